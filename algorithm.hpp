@@ -1,9 +1,100 @@
 #ifndef ALGORITHM_HPP
 # define ALGORITHM_HPP
 
+#include <functional>	// std::less, std::greater
+#if __cplusplus > 201703L
+# include <compare>		// std::three_way_comparable
+#endif
+
+#include "type_traits.hpp"
 
 namespace ft {
 
+	/* three-way comparison: negative, zero or positive like strcmp.
+		ordering a and b with < alone needs a < b and b < a, for strings
+		that is two walks over the common prefix. a type that knows how
+		to compare in one go provides it here, either through a compare()
+		member returning a signed integer that agrees with operator<
+		(std::string) or by specializing
+		three_way_traits for it */
+	template <typename T, typename Enable = void>
+	struct three_way_traits
+	{
+		static int compare(const T& a, const T& b)
+		{
+			if (a < b)
+				return (-1);
+			return (b < a) ? 1 : 0;
+		}
+	};
+
+	template <typename T>
+	struct three_way_traits<T, typename enable_if<has_compare_member<T>::value>::type>
+	{
+		static int compare(const T& a, const T& b)
+		{
+			return sign_(a.compare(b));
+		}
+
+		/* a long result would not fit an int */
+		template <typename R>
+		static int sign_(R c)
+		{
+			return (c < 0) ? -1 : (c > 0);
+		}
+	};
+
+#if __cplusplus > 201703L && defined(__cpp_lib_three_way_comparison)
+	/* C++20, anything with <=> but without compare() */
+	template <typename T>
+	struct three_way_traits<T, typename enable_if<!has_compare_member<T>::value
+								&& std::three_way_comparable<T> >::type>
+	{
+		static int compare(const T& a, const T& b)
+		{
+			const auto c = a <=> b;
+			return (c < 0) ? -1 : (c > 0);
+		}
+	};
+#endif
+
+	/* mixed types have no traits to go through */
+	template <typename T, typename U>
+	int		compare_3way(const T& a, const U& b)
+	{
+		if (a < b)
+			return (-1);
+		return (b < a) ? 1 : 0;
+	}
+
+	template <typename T>
+	int		compare_3way(const T& a, const T& b)
+	{
+		return (three_way_traits<T>::compare(a, b));
+	}
+
+	/* an arbitrary comparator is asked twice, std::less and std::greater
+		are known to order like operator< and can use the traits */
+	template <typename Compare, typename T, typename U>
+	int		compare_3way(const Compare& comp, const T& a, const U& b)
+	{
+		if (comp(a, b))
+			return (-1);
+		return comp(b, a) ? 1 : 0;
+	}
+
+	template <typename T>
+	int		compare_3way(const std::less<T>&, const T& a, const T& b)
+	{
+		return (three_way_traits<T>::compare(a, b));
+	}
+
+	template <typename T>
+	int		compare_3way(const std::greater<T>&, const T& a, const T& b)
+	{
+		return (-three_way_traits<T>::compare(a, b));
+	}
+
 	/* non-mutating algorithms: do not modify objects passed to them */
 
 	/* comparisons are only done in the range of the first object */
@@ -41,12 +132,12 @@ namespace ft {
 	bool	lexicographical_compare(InputIter1 first1, InputIter1 last1,
 					InputIter2 first2, InputIter2 last2)
 	{
+		/* one three-way comparison instead of < in both directions */
 		while (first1 != last1 && first2 != last2)
 		{
-			if (*first1 < *first2)
-				return (true);
-			else if (*first2 < *first1)
-				return (false);
+			const int c = ft::compare_3way(*first1, *first2);
+			if (c != 0)
+				return (c < 0);
 			++first1;
 			++first2;
 		}
@@ -61,12 +152,12 @@ namespace ft {
 	{
 		for (; first1 != last1 && first2 != last2; ++first1, ++first2)
 		{
-			if (comp(*first1, *first2))
-				return (true);
 			/* negation of comp is not enough, fires when
-				elements are equal */
-			else if (comp(*first2, *first1))
-				return (false);
+				elements are equal. std::less and std::greater
+				get away with a single three-way comparison */
+			const int c = ft::compare_3way(comp, *first1, *first2);
+			if (c != 0)
+				return (c < 0);
 		}
 		return (first1 == last1 && first2 != last2);
 	}
@@ -76,10 +167,10 @@ namespace ft {
 
 
 
-	/* Helper */
+	/* Helper, constexpr for the tables static_map.hpp sorts at compile time */
 
 	template <typename T>
-	void swap(T& a, T& b)
+	constexpr void swap(T& a, T& b)
 	{
 		T tmp = a;
 		a = b;
@@ -87,13 +178,13 @@ namespace ft {
 	}
 
 	template <typename T>
-	const T& min(const T& a, const T& b)
+	constexpr const T& min(const T& a, const T& b)
 	{
 		return a < b ? a : b;
 	}
 
 	template <typename T>
-	const T& max(const T& a, const T& b)
+	constexpr const T& max(const T& a, const T& b)
 	{
 		return a > b ? a : b;
 	}
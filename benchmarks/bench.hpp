@@ -0,0 +1,43 @@
+#ifndef BENCH_HPP
+# define BENCH_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <sys/time.h>
+
+/* helpers shared by the benchmarks, nothing here is part of the library */
+
+inline double now_seconds()
+{
+    struct timeval  tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/* xorshift, the same sequence on every platform */
+inline unsigned long next_random(unsigned long& state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+inline void print_row(const std::string& name, double seconds, double ops)
+{
+    std::cout << std::left << std::setw(40) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1)
+              << seconds * 1e9 / ops << " ns/op" << std::endl;
+}
+
+/* keeps the optimizer from dropping a computed value */
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif // BENCH_HPP
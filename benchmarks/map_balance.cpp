@@ -0,0 +1,112 @@
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+#include "../map.hpp"
+#include "bench.hpp"
+
+/*
+    The balancing policies against each other on an insert-heavy and a
+    lookup-heavy workload. Besides the timings every policy reports the
+    average depth of a node, the number of nodes a successful find visits.
+
+    usage: ./map_balance [elements]
+*/
+
+template <typename NodePtr>
+void sum_depths(NodePtr node, size_t depth, size_t& total)
+{
+    if (node == NULL)
+        return;
+    total += depth;
+    sum_depths(node->left, depth + 1, total);
+    sum_depths(node->right, depth + 1, total);
+}
+
+template <typename Balance>
+void run(const std::string& name, const std::vector<unsigned long>& keys,
+            const std::vector<unsigned long>& lookups)
+{
+    typedef ft::map<unsigned long, unsigned long, std::less<unsigned long>,
+                    std::allocator<ft::pair<const unsigned long, unsigned long> >,
+                    Balance>    map_type;
+
+    map_type        m;
+    unsigned long   sum = 0;
+
+    /* insert-heavy: fill, then replace half of the map with new keys */
+    double start = now_seconds();
+    for (size_t i = 0; i < keys.size(); ++i)
+        m.insert(ft::make_pair(keys[i], keys[i]));
+    for (size_t i = 0; i < keys.size(); i += 2)
+    {
+        m.erase(keys[i]);
+        m.insert(ft::make_pair(keys[i] + 1, keys[i]));
+    }
+    print_row(name + " insert/erase random", now_seconds() - start, keys.size() * 2);
+
+    size_t total = 0;
+    sum_depths(m.end().base()->left, 1, total);
+    std::cout << std::left << std::setw(40) << (name + " average depth")
+              << std::right << std::setw(10) << std::fixed << std::setprecision(2)
+              << double(total) / m.size() << std::endl;
+
+    /* lookup-heavy: random finds, about half of them hit */
+    start = now_seconds();
+    for (size_t i = 0; i < lookups.size(); ++i)
+    {
+        typename map_type::iterator it = m.find(lookups[i]);
+        if (it != m.end())
+            sum += it->second;
+    }
+    print_row(name + " find random", now_seconds() - start, lookups.size());
+    do_not_optimize(sum);
+
+    /* ascending keys, every insert lands on the rightmost path */
+    m.clear();
+    start = now_seconds();
+    for (size_t i = 0; i < keys.size(); ++i)
+        m.insert(m.end(), ft::make_pair(i, i));
+    print_row(name + " insert ascending", now_seconds() - start, keys.size());
+
+    total = 0;
+    sum_depths(m.end().base()->left, 1, total);
+    std::cout << std::left << std::setw(40) << (name + " average depth")
+              << std::right << std::setw(10) << std::fixed << std::setprecision(2)
+              << double(total) / m.size() << std::endl;
+
+    start = now_seconds();
+    for (size_t i = 0; i < lookups.size(); ++i)
+    {
+        typename map_type::iterator it = m.find(lookups[i] % (keys.size() * 2));
+        if (it != m.end())
+            sum += it->second;
+    }
+    print_row(name + " find ascending", now_seconds() - start, lookups.size());
+    do_not_optimize(sum);
+    std::cout << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t    elements = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 1000000;
+    const size_t    lookups = 4000000;
+    unsigned long   state = 42;
+
+    /* even keys only, key + 1 is always new */
+    std::vector<unsigned long> keys(elements);
+    for (size_t i = 0; i < elements; ++i)
+        keys[i] = (next_random(state) % (elements * 4)) & ~1UL;
+
+    std::vector<unsigned long> probes(lookups);
+    for (size_t i = 0; i < lookups; ++i)
+        probes[i] = next_random(state) % (elements * 4);
+
+    std::cout << "map of up to " << elements << " elements, "
+              << lookups << " lookups" << std::endl;
+
+    run<ft::rb_balance>("red-black", keys, probes);
+    run<ft::avl_balance>("avl", keys, probes);
+    run<ft::wb_balance>("weight-balanced", keys, probes);
+    return 0;
+}
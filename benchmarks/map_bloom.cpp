@@ -0,0 +1,60 @@
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+#include "../map.hpp"
+#include "bench.hpp"
+
+/*
+    ft::map with and without a bloom_filter, on lookups of which 80% miss.
+    Inserts pay for the filter, misses that the filter turns away skip the
+    tree.
+
+    usage: ./map_bloom [elements]
+*/
+
+typedef ft::map<unsigned long, unsigned long>   plain_map;
+typedef ft::map<unsigned long, unsigned long, std::less<unsigned long>,
+                std::allocator<ft::pair<const unsigned long, unsigned long> >,
+                ft::rb_balance, ft::bloom_filter<unsigned long> >   filtered_map;
+
+template <typename Map>
+void run(const std::string& name, const std::vector<unsigned long>& keys,
+            const std::vector<unsigned long>& lookups)
+{
+    Map             m;
+    unsigned long   sum = 0;
+
+    double start = now_seconds();
+    for (size_t i = 0; i < keys.size(); ++i)
+        m.insert(ft::make_pair(keys[i], i));
+    print_row(name + " insert", now_seconds() - start, keys.size());
+
+    start = now_seconds();
+    for (size_t round = 0; round < 4; ++round)
+        for (size_t i = 0; i < lookups.size(); ++i)
+            sum += m.count(lookups[i]);
+    print_row(name + " count, 80% miss", now_seconds() - start, lookups.size() * 4);
+    do_not_optimize(sum);
+    std::cout << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t    elements = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 1000000;
+    unsigned long   state = 42;
+
+    /* even keys are there, odd ones miss */
+    std::vector<unsigned long> keys(elements);
+    std::vector<unsigned long> lookups(elements);
+    for (size_t i = 0; i < elements; ++i)
+        keys[i] = next_random(state) & ~1UL;
+    for (size_t i = 0; i < elements; ++i)
+        lookups[i] = (i % 5 == 0) ? keys[next_random(state) % elements]
+                                  : next_random(state) | 1UL;
+
+    std::cout << elements << " random keys" << std::endl;
+    run<plain_map>("ft::map", keys, lookups);
+    run<filtered_map>("ft::map + bloom_filter", keys, lookups);
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <vector>
+#include <string>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <cstdlib>
+
+#include "../map.hpp"
+#include "../concurrent_map.hpp"
+#include "../sharded_map.hpp"
+#include "../concurrent_unordered_map.hpp"
+#include "bench.hpp"
+
+/*
+    Throughput of concurrent_map, sharded_map and concurrent_unordered_map
+    against a map behind one mutex, from 1 to 64 threads. Each thread runs
+    the same mix on a shared map prefilled with half of the key range: 80%
+    find, 10% insert, 10% erase of random keys.
+    ns/op is wall time over the operations of all threads together, lower
+    means more throughput.
+
+    usage: ./map_concurrent [keys] [operations per thread]
+*/
+
+struct locked_map
+{
+    ft::map<unsigned long, unsigned long>   map;
+    std::mutex                              lock;
+
+    bool find(unsigned long key)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return map.find(key) != map.end();
+    }
+
+    void insert(unsigned long key)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        map.insert(ft::make_pair(key, key));
+    }
+
+    void erase(unsigned long key)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        map.erase(key);
+    }
+};
+
+struct lock_free_map
+{
+    ft::concurrent_map<unsigned long, unsigned long>    map;
+
+    bool find(unsigned long key) { return map.count(key) != 0; }
+
+    void insert(unsigned long key) { map.insert(ft::make_pair(key, key)); }
+
+    void erase(unsigned long key) { map.erase(key); }
+};
+
+struct hash_sharded_map
+{
+    ft::sharded_map<unsigned long, unsigned long, 64>   map;
+
+    bool find(unsigned long key) { return map.count(key) != 0; }
+
+    void insert(unsigned long key) { map.insert(ft::make_pair(key, key)); }
+
+    void erase(unsigned long key) { map.erase(key); }
+};
+
+struct striped_hash_map
+{
+    ft::concurrent_unordered_map<unsigned long, unsigned long>  map;
+
+    bool find(unsigned long key) { return map.count(key) != 0; }
+
+    void insert(unsigned long key) { map.insert(ft::make_pair(key, key)); }
+
+    void erase(unsigned long key) { map.erase(key); }
+};
+
+template <typename Map>
+void work(Map& m, size_t keys, size_t ops, unsigned long seed)
+{
+    unsigned long   state = seed;
+    size_t          hits = 0;
+
+    for (size_t i = 0; i < ops; ++i)
+    {
+        const unsigned long r = next_random(state);
+        const unsigned long key = (r >> 8) % keys;
+        switch (r % 10)
+        {
+            case 0:
+                m.insert(key);
+                break;
+            case 1:
+                m.erase(key);
+                break;
+            default:
+                hits += m.find(key);
+        }
+    }
+    do_not_optimize(hits);
+}
+
+template <typename Map>
+void run(const std::string& name, size_t keys, size_t ops)
+{
+    for (size_t threads = 1; threads <= 64; threads *= 2)
+    {
+        Map m;
+        for (size_t key = 0; key < keys; key += 2)
+            m.insert(key);
+
+        std::vector<std::thread> pool;
+        double start = now_seconds();
+        for (size_t t = 0; t < threads; ++t)
+            pool.push_back(std::thread(work<Map>, std::ref(m), keys, ops, 42 + t));
+        for (size_t t = 0; t < threads; ++t)
+            pool[t].join();
+
+        std::ostringstream row;
+        row << name << " " << threads << " threads";
+        print_row(row.str(), now_seconds() - start, double(ops) * threads);
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t    keys = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 1000000;
+    const size_t    ops = (argc > 2) ? std::strtoul(argv[2], NULL, 10) : 200000;
+
+    std::cout << keys << " keys, " << ops << " operations per thread, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+    run<locked_map>("map + mutex", keys, ops);
+    run<lock_free_map>("concurrent_map", keys, ops);
+    run<hash_sharded_map>("sharded_map<64>", keys, ops);
+    run<striped_hash_map>("concurrent_unordered_map", keys, ops);
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <vector>
+#include <cstdlib>
+
+#include "../map.hpp"
+#include "bench.hpp"
+
+/*
+    find() in a loop against find_batch() on a map well beyond the size
+    of the last level cache. The keys are inserted in random order, so
+    neighbouring nodes are scattered over the heap and nearly every level
+    of a descent is a cache miss.
+
+    usage: ./map_find_batch [elements] [keys per batch]
+*/
+
+int main(int argc, char** argv)
+{
+    const size_t    elements = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 4000000;
+    const size_t    batch = (argc > 2) ? std::strtoul(argv[2], NULL, 10) : 256;
+    const size_t    lookups = 2000000;
+    unsigned long   state = 42;
+
+    ft::map<unsigned long, unsigned long>    m;
+    while (m.size() < elements)
+    {
+        unsigned long key = next_random(state) % (elements * 2);
+        m.insert(ft::make_pair(key, key));
+    }
+
+    /* about half of the keys hit */
+    std::vector<unsigned long> keys(lookups);
+    for (size_t i = 0; i < lookups; ++i)
+        keys[i] = next_random(state) % (elements * 2);
+
+    typedef ft::map<unsigned long, unsigned long>::iterator    iterator;
+    std::vector<iterator>   out(batch);
+    unsigned long           sum = 0;
+
+    std::cout << "map of " << elements << " elements, "
+              << lookups << " lookups in batches of " << batch << std::endl;
+
+    double start = now_seconds();
+    for (size_t i = 0; i + batch <= lookups; i += batch)
+    {
+        for (size_t j = 0; j < batch; ++j)
+            out[j] = m.find(keys[i + j]);
+        for (size_t j = 0; j < batch; ++j)
+            sum += (out[j] != m.end()) ? out[j]->second : 0;
+    }
+    print_row("find loop", now_seconds() - start, lookups);
+    do_not_optimize(sum);
+
+    unsigned long check = sum;
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i + batch <= lookups; i += batch)
+    {
+        m.find_batch(keys.begin() + i, keys.begin() + i + batch, out.begin());
+        for (size_t j = 0; j < batch; ++j)
+            sum += (out[j] != m.end()) ? out[j]->second : 0;
+    }
+    print_row("find_batch", now_seconds() - start, lookups);
+    do_not_optimize(sum);
+
+    start = now_seconds();
+    for (size_t i = 0; i + batch <= lookups; i += batch)
+    {
+        for (size_t j = 0; j < batch; ++j)
+            out[j] = m.lower_bound(keys[i + j]);
+        do_not_optimize(out[0]);
+    }
+    print_row("lower_bound loop", now_seconds() - start, lookups);
+
+    start = now_seconds();
+    for (size_t i = 0; i + batch <= lookups; i += batch)
+    {
+        m.lower_bound_batch(keys.begin() + i, keys.begin() + i + batch, out.begin());
+        do_not_optimize(out[0]);
+    }
+    print_row("lower_bound_batch", now_seconds() - start, lookups);
+
+    return (sum == check) ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include <vector>
+#include <cstdlib>
+
+#include "../frozen_map.hpp"
+#include "bench.hpp"
+
+/*
+    Lookups on a map against the frozen_map built from it. The map is
+    filled in random order, so its nodes are scattered over the heap.
+
+    usage: ./map_frozen [elements]
+*/
+
+int main(int argc, char** argv)
+{
+    const size_t    elements = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 4000000;
+    const size_t    lookups = 4000000;
+    unsigned long   state = 42;
+
+    ft::map<unsigned long, unsigned long>    m;
+    while (m.size() < elements)
+    {
+        unsigned long key = next_random(state) % (elements * 2);
+        m.insert(ft::make_pair(key, key));
+    }
+
+    double start = now_seconds();
+    ft::frozen_map<unsigned long, unsigned long> f(m);
+    std::cout << "map of " << elements << " elements, frozen in "
+              << std::fixed << std::setprecision(3) << now_seconds() - start << " s, "
+              << lookups << " lookups" << std::endl;
+
+    /* about half of the keys hit */
+    std::vector<unsigned long> keys(lookups);
+    for (size_t i = 0; i < lookups; ++i)
+        keys[i] = next_random(state) % (elements * 2);
+
+    unsigned long sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < lookups; ++i)
+    {
+        ft::map<unsigned long, unsigned long>::const_iterator it = m.find(keys[i]);
+        if (it != m.end())
+            sum += it->second;
+    }
+    print_row("map find", now_seconds() - start, lookups);
+    do_not_optimize(sum);
+
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < lookups; ++i)
+    {
+        ft::frozen_map<unsigned long, unsigned long>::const_iterator it = f.find(keys[i]);
+        if (it != f.end())
+            sum += it->second;
+    }
+    print_row("frozen_map find", now_seconds() - start, lookups);
+    do_not_optimize(sum);
+
+    start = now_seconds();
+    for (size_t i = 0; i < lookups; ++i)
+        do_not_optimize(m.lower_bound(keys[i]));
+    print_row("map lower_bound", now_seconds() - start, lookups);
+
+    start = now_seconds();
+    for (size_t i = 0; i < lookups; ++i)
+        do_not_optimize(f.lower_bound(keys[i]));
+    print_row("frozen_map lower_bound", now_seconds() - start, lookups);
+    return 0;
+}
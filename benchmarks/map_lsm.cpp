@@ -0,0 +1,91 @@
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+#include "../map.hpp"
+#include "../lsm_map.hpp"
+#include "bench.hpp"
+
+/*
+    ft::lsm_map against ft::map under a write-heavy load: writes of random
+    keys, a quarter of them overwrites, then lookups and one ordered scan.
+    The lsm_map rows are run for a few memtable sizes.
+
+    usage: ./map_lsm [writes]
+*/
+
+struct tree
+{
+    typedef ft::map<unsigned long, unsigned long>::const_iterator   const_iterator;
+
+    ft::map<unsigned long, unsigned long>   map;
+
+    void write(unsigned long key, unsigned long obj) { map[key] = obj; }
+
+    bool find(unsigned long key) const { return map.find(key) != map.end(); }
+
+    const_iterator begin() const { return map.begin(); }
+
+    const_iterator end() const { return map.end(); }
+};
+
+template <size_t Limit>
+struct lsm
+{
+    typedef ft::lsm_map<unsigned long, unsigned long>::const_iterator   const_iterator;
+
+    ft::lsm_map<unsigned long, unsigned long>   map;
+
+    lsm() : map(Limit) {}
+
+    void write(unsigned long key, unsigned long obj) { map.insert_or_assign(key, obj); }
+
+    bool find(unsigned long key) const { return map.count(key) != 0; }
+
+    const_iterator begin() const { return map.begin(); }
+
+    const_iterator end() const { return map.end(); }
+};
+
+template <typename Map>
+void run(const std::string& name, const std::vector<unsigned long>& keys)
+{
+    Map             m;
+    unsigned long   sum = 0;
+
+    double start = now_seconds();
+    for (size_t i = 0; i < keys.size(); ++i)
+        m.write(keys[i], i);
+    print_row(name + " write", now_seconds() - start, keys.size());
+
+    start = now_seconds();
+    for (size_t i = 0; i < keys.size(); ++i)
+        sum += m.find(keys[i]);
+    print_row(name + " find", now_seconds() - start, keys.size());
+
+    start = now_seconds();
+    size_t n = 0;
+    for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it, ++n)
+        sum += it->second;
+    print_row(name + " scan", now_seconds() - start, n);
+    do_not_optimize(sum);
+    std::cout << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t    writes = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 1000000;
+    unsigned long   state = 42;
+
+    /* three fresh keys, then an overwrite of an earlier one */
+    std::vector<unsigned long> keys(writes);
+    for (size_t i = 0; i < writes; ++i)
+        keys[i] = (i % 4 == 3) ? keys[next_random(state) % i] : next_random(state);
+
+    std::cout << writes << " writes" << std::endl;
+    run<tree>("ft::map", keys);
+    run<lsm<1024> >("ft::lsm_map memtable 1024", keys);
+    run<lsm<4096> >("ft::lsm_map memtable 4096", keys);
+    run<lsm<16384> >("ft::lsm_map memtable 16384", keys);
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdlib>
+
+#include "../map.hpp"
+#include "../unordered_map.hpp"
+#include "bench.hpp"
+
+/*
+    ft::unordered_map against ft::map and std::unordered_map: inserts of
+    random keys, then lookups of keys that are there and of keys that
+    aren't.
+
+    usage: ./map_unordered [elements]
+*/
+
+template <typename Map>
+void run(const std::string& name, const std::vector<unsigned long>& keys,
+            const std::vector<unsigned long>& misses)
+{
+    Map             m;
+    unsigned long   sum = 0;
+
+    double start = now_seconds();
+    for (size_t i = 0; i < keys.size(); ++i)
+        m.insert(typename Map::value_type(keys[i], i));
+    print_row(name + " insert", now_seconds() - start, keys.size());
+
+    start = now_seconds();
+    for (size_t round = 0; round < 4; ++round)
+        for (size_t i = 0; i < keys.size(); ++i)
+            sum += m.find(keys[i])->second;
+    print_row(name + " find hit", now_seconds() - start, keys.size() * 4);
+
+    start = now_seconds();
+    for (size_t round = 0; round < 4; ++round)
+        for (size_t i = 0; i < misses.size(); ++i)
+            sum += (m.find(misses[i]) != m.end());
+    print_row(name + " find miss", now_seconds() - start, misses.size() * 4);
+    do_not_optimize(sum);
+    std::cout << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t    elements = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 1000000;
+    unsigned long   state = 42;
+
+    /* even keys are there, odd ones are misses */
+    std::vector<unsigned long> keys(elements);
+    std::vector<unsigned long> misses(elements);
+    for (size_t i = 0; i < elements; ++i)
+    {
+        keys[i] = next_random(state) & ~1UL;
+        misses[i] = next_random(state) | 1UL;
+    }
+
+    std::cout << elements << " random keys" << std::endl;
+    run<ft::map<unsigned long, unsigned long> >("ft::map", keys, misses);
+    run<std::unordered_map<unsigned long, unsigned long> >("std::unordered_map", keys, misses);
+    run<ft::unordered_map<unsigned long, unsigned long> >("ft::unordered_map", keys, misses);
+    return 0;
+}
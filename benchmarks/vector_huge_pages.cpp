@@ -0,0 +1,74 @@
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <stdint.h>
+
+#include "../vector.hpp"
+#include "../huge_page_allocator.hpp"
+#include "bench.hpp"
+
+/*
+    Random reads over one big ft::vector<uint64_t>, with std::allocator and
+    with huge_page_allocator. Past the reach of the TLB every read with 4
+    KiB pages also walks the page table, 2 MiB pages take most of that
+    away. AnonHugePages is what the kernel really gave as huge pages, it
+    stays at 0 with transparent huge pages off
+    (/sys/kernel/mm/transparent_hugepage/enabled).
+
+    One vector is alive at a time, the machine needs the gigabytes once.
+
+    usage: ./vector_huge_pages [gigabytes]
+*/
+
+typedef ft::vector<uint64_t>                                            plain_vector;
+typedef ft::vector<uint64_t, ft::huge_page_allocator<uint64_t> >        huge_vector;
+typedef ft::vector<uint64_t, ft::huge_page_allocator<uint64_t, size_t(1) << 21, true> >
+                                                                        hugetlb_vector;
+
+/* in kB, from /proc/meminfo */
+long anon_huge_pages()
+{
+    std::ifstream   meminfo("/proc/meminfo");
+    std::string     key;
+    long            kb;
+
+    while (meminfo >> key >> kb)
+    {
+        if (key == "AnonHugePages:")
+            return kb;
+        meminfo.ignore(64, '\n');
+    }
+    return -1;
+}
+
+template <typename Vector>
+void run(const std::string& name, size_t elements, size_t reads)
+{
+    unsigned long   state = 42;
+    uint64_t        sum = 0;
+
+    double start = now_seconds();
+    Vector v(elements, 1);
+    print_row(name + " fill", now_seconds() - start, elements);
+
+    start = now_seconds();
+    for (size_t i = 0; i < reads; ++i)
+        sum += v[next_random(state) % elements];
+    print_row(name + " random read", now_seconds() - start, reads);
+    do_not_optimize(sum);
+    std::cout << "AnonHugePages: " << anon_huge_pages() << " kB" << std::endl << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t    gigabytes = (argc > 1) ? std::strtoul(argv[1], NULL, 10) : 4;
+    const size_t    elements = gigabytes * (size_t(1) << 30) / sizeof(uint64_t);
+    const size_t    reads = 50000000;
+
+    std::cout << gigabytes << " GB, " << elements << " elements, "
+              << reads << " random reads" << std::endl;
+    run<plain_vector>("std::allocator", elements, reads);
+    run<huge_vector>("huge_page_allocator", elements, reads);
+    run<hugetlb_vector>("MAP_HUGETLB or fallback", elements, reads);
+    return 0;
+}
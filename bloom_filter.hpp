@@ -0,0 +1,200 @@
+#ifndef BLOOM_FILTER_HPP
+# define BLOOM_FILTER_HPP
+
+#include <cstddef>		// size_t
+#include <functional>	// std::hash
+#include <stdint.h>		// uint32_t, uint64_t
+
+#include "algorithm.hpp"
+#include "vector.hpp"
+
+/*
+    Filters for the sixth template parameter of ft::map, asked before a
+    find or count descends the tree. A filter may answer "maybe" for a key
+    that isn't there but never "no" for one that is.
+
+    no_filter is the default, it answers "maybe" for every key and takes no
+    room in the map.
+
+    bloom_filter is a blocked Bloom filter. A key hashes to one block of
+    256 bits, 32 bytes aligned so a block never straddles two cache lines,
+    and sets one bit in each of the block's eight words. A miss costs one
+    hash and one cache line instead of a walk down the tree. BitsPerKey
+    trades room for precision, with the default of 10 about one miss in a
+    hundred still goes down the tree.
+
+    Bits can't be taken out again: erased keys stay in the filter and only
+    make it less precise. The map rebuilds the filter from its elements
+    when more keys were erased than are left, or when the filter is full;
+    the filter is then sized for twice the elements, so rebuilds cost O(1)
+    per insert or erase over time.
+
+    What the map expects of a filter:
+        enabled                 false if the map may skip the bookkeeping
+        insert(key)             false if the filter is full, the map then
+                                rebuilds it
+        erased(n, size)         n keys are gone, size are left. false if the
+                                map should rebuild
+        may_contain(key)
+        reset(n)                empty, sized for n keys
+        fill()                  "maybe" for every key until the next reset,
+                                where a reset threw and keys may be missing
+        swap(other)
+*/
+
+namespace ft {
+
+	struct no_filter
+	{
+		static const bool	enabled = false;
+
+		template <typename Key>
+		bool insert(const Key&) { return true; }
+
+		bool erased(size_t, size_t) { return true; }
+
+		template <typename Key>
+		bool may_contain(const Key&) const { return true; }
+
+		void reset(size_t) {}
+
+		void fill() {}
+
+		void swap(no_filter&) {}
+	};
+
+	template <typename Key, typename Hash = std::hash<Key>, size_t BitsPerKey = 10>
+	class bloom_filter
+	{
+		public:
+			static const bool	enabled = true;
+
+		private:
+			struct alignas(32) block
+			{
+				uint32_t	words[8];
+			};
+
+			/* below this many keys a rebuild isn't worth it yet */
+			static const size_t		min_keys = 64;
+
+			ft::vector<block>	blocks_;
+			size_t				capacity_;	// keys the blocks are sized for
+			size_t				keys_;		// inserted since the last reset
+			size_t				erased_;	// erased since the last reset
+			bool				filled_;	// no blocks but "maybe" anyway
+			Hash				hash_;
+
+		public:
+			explicit bloom_filter(const Hash& hash = Hash())
+				: capacity_(0), keys_(0), erased_(0), filled_(false), hash_(hash)
+			{}
+
+			bool insert(const Key& key)
+			{
+				if (keys_ >= capacity_)
+					return false;
+
+				const uint64_t	h = hash_of_(key);
+				block&			b = blocks_[block_of_(h)];
+
+				for (size_t i = 0; i < 8; ++i)
+					b.words[i] |= bit_(h, i);
+				++keys_;
+				return true;
+			}
+
+			bool erased(size_t n, size_t size)
+			{
+				erased_ += n;
+				return erased_ < min_keys || erased_ <= size;
+			}
+
+			bool may_contain(const Key& key) const
+			{
+				if (blocks_.empty())
+					return filled_;
+
+				const uint64_t	h = hash_of_(key);
+				const block&	b = blocks_[block_of_(h)];
+
+				for (size_t i = 0; i < 8; ++i)
+					if ((b.words[i] & bit_(h, i)) == 0)
+						return false;
+				return true;
+			}
+
+			void reset(size_t n)
+			{
+				const size_t	capacity = ft::max(2 * n, min_keys);
+				const size_t	count = (capacity * BitsPerKey + 255) / 256;
+				block			zero = {};
+
+				ft::vector<block>(count, zero).swap(blocks_);
+				capacity_ = capacity;
+				keys_ = 0;
+				erased_ = 0;
+				filled_ = false;
+			}
+
+			/* every bit set, and full so the next insert has the map
+				rebuild it */
+			void fill()
+			{
+				for (size_t i = 0; i < blocks_.size(); ++i)
+					for (size_t w = 0; w < 8; ++w)
+						blocks_[i].words[w] = ~0U;
+				capacity_ = 0;
+				filled_ = true;
+			}
+
+			void swap(bloom_filter& other)
+			{
+				blocks_.swap(other.blocks_);
+				ft::swap(capacity_, other.capacity_);
+				ft::swap(keys_, other.keys_);
+				ft::swap(erased_, other.erased_);
+				ft::swap(filled_, other.filled_);
+				ft::swap(hash_, other.hash_);
+			}
+
+			/* the bytes of the bit array */
+			size_t memory() const { return blocks_.size() * sizeof(block); }
+
+		private:
+			/* std::hash is the identity for integers, spread it first */
+			uint64_t hash_of_(const Key& key) const
+			{
+				uint64_t h = static_cast<uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ULL;
+
+				return h ^ (h >> 29);
+			}
+
+			/* the top half picks the block, without a division */
+			size_t block_of_(uint64_t h) const
+			{
+				return static_cast<size_t>(((h >> 32) * blocks_.size()) >> 32);
+			}
+
+			/* the bottom half times an odd constant per word, its top five
+				bits pick the bit */
+			static uint32_t bit_(uint64_t h, size_t i)
+			{
+				static const uint32_t salts[8] = {
+					0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+					0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+				};
+
+				return 1U << ((static_cast<uint32_t>(h) * salts[i]) >> 27);
+			}
+	};
+
+	template <typename Key, typename Hash, size_t BitsPerKey>
+	const bool bloom_filter<Key, Hash, BitsPerKey>::enabled;
+
+	template <typename Key, typename Hash, size_t BitsPerKey>
+	const size_t bloom_filter<Key, Hash, BitsPerKey>::min_keys;
+
+} // namespace ft
+
+#endif // BLOOM_FILTER_HPP
@@ -0,0 +1,591 @@
+#ifndef CONCURRENT_MAP_HPP
+# define CONCURRENT_MAP_HPP
+
+#include <functional>	// std::less
+#include <memory>		// std::allocator
+#include <atomic>
+#include <thread>		// std::this_thread
+#include <new>			// placement new
+#include <stdint.h>		// uintptr_t
+
+#include "iterator.hpp"
+#include "utility.hpp"
+#include "epoch.hpp"
+
+/*
+    An ordered map many threads can use at once, a lock-free skip list
+    (Fraser, Herlihy and Shavit). Every node sits on level 0 and on a random
+    number of levels above it, each level halves the nodes of the one below.
+
+    Erasing marks the pointers out of a node, the low bit of each, top level
+    first; the mark on level 0 decides which erase wins. Marked nodes are
+    unlinked by whoever walks by next and freed through epoch.hpp once no
+    thread can still hold them.
+
+    insert, erase, find, count, lower_bound and upper_bound are linearizable.
+    Iterators are forward only and weakly consistent: they never see an
+    element twice or out of order and see every element that is there for
+    the whole walk, elements inserted or erased meanwhile may or may not
+    show up. An iterator pins an epoch while it lives, the element it points
+    to stays valid even if erased. The iterators of a thread share one pin,
+    a thread may keep as many as it likes. Values are read-only, there is no
+    operator[] and no assignment of a mapped value, a thread could be
+    reading it. size() is exact only when no update is running.
+*/
+
+namespace ft {
+
+	template <typename T>
+	struct skip_node : public epoch_node
+	{
+		typedef std::atomic<uintptr_t>		link_type;
+
+		/* the inserter still links upper levels / the node is erased */
+		static const int	linking = 1;
+		static const int	erased = 2;
+
+		T						val;
+		std::atomic<int>		state;
+		int						level;
+
+		/* the tower of level pointers follows the node */
+		link_type* next() { return reinterpret_cast<link_type*>(this + 1); }
+
+		const link_type* next() const { return reinterpret_cast<const link_type*>(this + 1); }
+
+		static bool is_marked(uintptr_t link) { return (link & 1) != 0; }
+
+		static skip_node* pointer(uintptr_t link) { return reinterpret_cast<skip_node*>(link & ~uintptr_t(1)); }
+
+		/* the first node after this one on level 0 that isn't erased */
+		skip_node* next_live() const
+		{
+			skip_node* node = pointer(next()[0].load(std::memory_order_acquire));
+
+			while (node != NULL && is_marked(node->next()[0].load(std::memory_order_acquire)))
+				node = pointer(node->next()[0].load(std::memory_order_acquire));
+			return node;
+		}
+	};
+
+
+	template <typename Key, typename T, typename Compare, typename Allocator>
+	class concurrent_map;
+
+	template <typename Value>
+	class concurrent_map_iterator
+	{
+		public:
+			typedef forward_iterator_tag				iterator_category;
+			typedef Value								value_type;
+			typedef const Value&						reference;
+			typedef const Value*						pointer;
+			typedef ptrdiff_t							difference_type;
+			typedef const skip_node<Value>*				node_pointer;
+
+		private:
+			epoch_guard		guard_;
+			node_pointer	node_;
+
+			template <typename K, typename U, typename C, typename A>
+			friend class concurrent_map;
+
+			/* takes over the guard the node was found under */
+			concurrent_map_iterator(epoch_guard& guard, node_pointer node) : node_(node)
+			{
+				if (node_ != NULL)
+					guard_.swap(guard);
+			}
+
+		public:
+			concurrent_map_iterator() : node_(NULL)
+			{}
+
+			node_pointer base() const { return node_; }
+
+			reference operator*() const { return node_->val; }
+
+			pointer operator->() const { return &node_->val; }
+
+			/* end() needs no guard, it is dropped there */
+			concurrent_map_iterator& operator++()
+			{
+				node_ = node_->next_live();
+				if (node_ == NULL)
+				{
+					epoch_guard none;
+					guard_.swap(none);
+				}
+				return *this;
+			}
+
+			concurrent_map_iterator operator++(int)
+			{
+				concurrent_map_iterator tmp = *this;
+				++(*this);
+				return tmp;
+			}
+	};
+
+	template <typename Value>
+	bool operator==(const concurrent_map_iterator<Value>& lhs,
+					const concurrent_map_iterator<Value>& rhs)
+	{
+		return lhs.base() == rhs.base();
+	}
+
+	template <typename Value>
+	bool operator!=(const concurrent_map_iterator<Value>& lhs,
+					const concurrent_map_iterator<Value>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+
+	template <typename Key, typename T, typename Compare = std::less<Key>,
+				typename Allocator = std::allocator<ft::pair<const Key, T> > >
+	class concurrent_map
+	{
+		public:
+			typedef Key													key_type;
+			typedef T													mapped_type;
+			typedef ft::pair<const Key, T>								value_type;
+			typedef Compare												key_compare;
+			typedef Allocator											allocator_type;
+			typedef typename allocator_type::reference					reference;
+			typedef typename allocator_type::const_reference			const_reference;
+			typedef typename allocator_type::pointer					pointer;
+			typedef typename allocator_type::const_pointer				const_pointer;
+			typedef typename allocator_type::size_type					size_type;
+			typedef typename allocator_type::difference_type			difference_type;
+
+			typedef concurrent_map_iterator<value_type>					const_iterator;
+			typedef const_iterator										iterator;
+
+			/* 2^32 elements before the top level gets crowded */
+			static const int	max_level = 32;
+
+		private:
+			typedef skip_node<value_type>								node_type;
+			typedef node_type*											node_pointer;
+			typedef typename node_type::link_type						link_type;
+			typedef typename allocator_type::template
+				rebind<node_type>::other								node_allocator_type;
+
+			allocator_type				alloc_;
+			node_allocator_type			node_alloc_;
+			key_compare					comp_;
+			/* a full tower, its value is never constructed */
+			node_pointer				head_;
+			/* highest level in use, searches start there */
+			std::atomic<int>			level_;
+			std::atomic<size_type>		size_;
+			/* last member, the nodes it still holds are freed first */
+			epoch_domain				epochs_;
+
+		public:
+
+			explicit concurrent_map(const Compare& comp = Compare(),
+									const Allocator& alloc = Allocator())
+				: alloc_(alloc), node_alloc_(alloc), comp_(comp), head_(allocate_(max_level)),
+				level_(1), size_(0), epochs_(&reclaim_, this)
+			{}
+
+			template <typename InputIt>
+			concurrent_map(InputIt first, InputIt last, const Compare& comp = Compare(),
+							const Allocator& alloc = Allocator())
+				: alloc_(alloc), node_alloc_(alloc), comp_(comp), head_(allocate_(max_level)),
+				level_(1), size_(0), epochs_(&reclaim_, this)
+			{
+				try {
+					insert(first, last);
+				} catch (...) {
+					free_all_();
+					throw;
+				}
+			}
+
+			/* other may be updated meanwhile, the copy is as consistent as
+				a walk over it */
+			concurrent_map(const concurrent_map& other)
+				: alloc_(other.alloc_), node_alloc_(other.node_alloc_), comp_(other.comp_),
+				head_(allocate_(max_level)), level_(1), size_(0), epochs_(&reclaim_, this)
+			{
+				try {
+					insert(other.begin(), other.end());
+				} catch (...) {
+					free_all_();
+					throw;
+				}
+			}
+
+			/* no other thread may use the map any more */
+			~concurrent_map()
+			{
+				free_all_();
+			}
+
+			concurrent_map& operator=(const concurrent_map& other)
+			{
+				if (this != &other)
+				{
+					clear();
+					insert(other.begin(), other.end());
+				}
+				return *this;
+			}
+
+
+			const_iterator begin() const
+			{
+				epoch_guard guard(domain_());
+				return const_iterator(guard, head_->next_live());
+			}
+
+			const_iterator end() const { return const_iterator(); }
+
+			bool empty() const { return size() == 0; }
+
+			size_type size() const { return size_.load(std::memory_order_relaxed); }
+
+			size_type max_size() const { return node_alloc_.max_size(); }
+
+			ft::pair<const_iterator, bool> insert(const value_type& val)
+			{
+				epoch_guard		guard(epochs_);
+				node_pointer	preds[max_level];
+				node_pointer	succs[max_level];
+				node_pointer	node = NULL;
+				const int		top = random_level_();
+
+				raise_level_(top);
+				for (;;)
+				{
+					search_(val.first, preds, succs);
+					if (matches_(succs[0], val.first))
+					{
+						if (node != NULL)
+							destroy_(node);
+						return ft::make_pair(const_iterator(guard, succs[0]), false);
+					}
+					if (node == NULL)
+						node = create_(val, top);
+					for (int level = 0; level < top; ++level)
+						node->next()[level].store(link_(succs[level]), std::memory_order_relaxed);
+
+					uintptr_t expected = link_(succs[0]);
+					if (preds[0]->next()[0].compare_exchange_strong(expected, link_(node)))
+						break;
+				}
+				size_.fetch_add(1, std::memory_order_relaxed);
+
+				link_upper_(node, preds, succs);
+				/* an erase that came first left the retiring to us */
+				if (node->state.fetch_and(~node_type::linking) & node_type::erased)
+				{
+					search_(val.first, preds, succs);
+					guard.retire(node);
+				}
+				return ft::make_pair(const_iterator(guard, node), true);
+			}
+
+			const_iterator insert(const_iterator, const value_type& val)
+			{
+				return insert(val).first;
+			}
+
+			template <typename InputIt>
+			void insert(InputIt first, InputIt last)
+			{
+				for (; first != last; ++first)
+					insert(*first);
+			}
+
+			size_type erase(const key_type& key)
+			{
+				epoch_guard		guard(epochs_);
+				node_pointer	preds[max_level];
+				node_pointer	succs[max_level];
+
+				search_(key, preds, succs);
+				if (!matches_(succs[0], key))
+					return 0;
+
+				node_pointer node = succs[0];
+				for (int level = node->level - 1; level > 0; --level)
+					mark_(node->next()[level]);
+
+				/* the mark on level 0 is the erase */
+				uintptr_t link = node->next()[0].load(std::memory_order_acquire);
+				do {
+					if (node_type::is_marked(link))
+						return 0;
+				} while (!node->next()[0].compare_exchange_weak(link, link | 1));
+				size_.fetch_sub(1, std::memory_order_relaxed);
+
+				/* an insert still linking upper levels may link one after
+					any search from here, it unlinks and retires the node
+					itself. otherwise every level is linked already and the
+					search unlinks it on all of them */
+				if (!(node->state.fetch_or(node_type::erased) & node_type::linking))
+				{
+					search_(key, preds, succs);
+					guard.retire(node);
+				}
+				return 1;
+			}
+
+			void erase(const_iterator position)
+			{
+				erase(position->first);
+			}
+
+			/* erases what it finds, concurrent inserts may survive */
+			void clear()
+			{
+				for (const_iterator it = begin(); it != end(); ++it)
+					erase(it->first);
+			}
+
+			key_compare key_comp() const { return comp_; }
+
+			const_iterator find(const key_type& key) const
+			{
+				epoch_guard		guard(domain_());
+				node_pointer	node = bound_<false>(key);
+
+				return matches_(node, key) ? const_iterator(guard, node) : end();
+			}
+
+			size_type count(const key_type& key) const
+			{
+				epoch_guard guard(domain_());
+				return matches_(bound_<false>(key), key) ? 1 : 0;
+			}
+
+			const_iterator lower_bound(const key_type& key) const
+			{
+				epoch_guard guard(domain_());
+				return const_iterator(guard, bound_<false>(key));
+			}
+
+			const_iterator upper_bound(const key_type& key) const
+			{
+				epoch_guard guard(domain_());
+				return const_iterator(guard, bound_<true>(key));
+			}
+
+			ft::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+			{
+				return ft::make_pair(lower_bound(key), upper_bound(key));
+			}
+
+			allocator_type get_allocator() const { return alloc_; }
+
+
+		private:
+
+			/* guards only touch the domain's atomics and their own slot */
+			epoch_domain& domain_() const { return const_cast<epoch_domain&>(epochs_); }
+
+			static uintptr_t link_(const node_type* node) { return reinterpret_cast<uintptr_t>(node); }
+
+			bool matches_(const node_type* node, const key_type& key) const
+			{
+				return node != NULL && !comp_(key, node->val.first);
+			}
+
+			/* the tower rounded up to whole nodes */
+			node_pointer allocate_(int level)
+			{
+				const size_t units = 1 + (level * sizeof(link_type) + sizeof(node_type) - 1)
+										/ sizeof(node_type);
+				node_pointer node = node_alloc_.allocate(units);
+
+				for (int i = 0; i < level; ++i)
+					::new (static_cast<void*>(&node->next()[i])) link_type(0);
+				::new (static_cast<void*>(&node->state)) std::atomic<int>(node_type::linking);
+				node->level = level;
+				return node;
+			}
+
+			void deallocate_(node_pointer node)
+			{
+				const size_t units = 1 + (node->level * sizeof(link_type) + sizeof(node_type) - 1)
+										/ sizeof(node_type);
+				node_alloc_.deallocate(node, units);
+			}
+
+			node_pointer create_(const value_type& val, int level)
+			{
+				node_pointer node = allocate_(level);
+
+				try {
+					alloc_.construct(&node->val, val);
+				} catch (...) {
+					deallocate_(node);
+					throw;
+				}
+				return node;
+			}
+
+			void destroy_(node_pointer node)
+			{
+				alloc_.destroy(&node->val);
+				deallocate_(node);
+			}
+
+			static void reclaim_(epoch_node* node, void* map)
+			{
+				static_cast<concurrent_map*>(map)->destroy_(static_cast<node_pointer>(node));
+			}
+
+			void free_all_()
+			{
+				node_pointer node = node_type::pointer(head_->next()[0].load());
+
+				while (node != NULL)
+				{
+					node_pointer next = node_type::pointer(node->next()[0].load());
+					destroy_(node);
+					node = next;
+				}
+				deallocate_(head_);
+				head_ = NULL;
+			}
+
+			/* level n with probability 2^-n */
+			static int random_level_()
+			{
+				static thread_local unsigned long long	state
+					= std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+
+				state ^= state << 13;
+				state ^= state >> 7;
+				state ^= state << 17;
+				return __builtin_ctzll(state | (1ULL << (max_level - 1))) + 1;
+			}
+
+			void raise_level_(int level)
+			{
+				int current = level_.load(std::memory_order_relaxed);
+
+				while (current < level && !level_.compare_exchange_weak(current, level))
+					;
+			}
+
+			static void mark_(link_type& link)
+			{
+				uintptr_t value = link.load(std::memory_order_acquire);
+
+				while (!node_type::is_marked(value) && !link.compare_exchange_weak(value, value | 1))
+					;
+			}
+
+			/*
+				Fills preds and succs with the last node before key and the
+				first one from key on, on every level, unlinking the marked
+				nodes on the way. Levels above level_ get head_ and NULL, an
+				insert that raced to link there fails its CAS and searches
+				again.
+			*/
+			void search_(const key_type& key, node_pointer* preds, node_pointer* succs)
+			{
+				while (!try_search_(key, preds, succs))
+					;
+			}
+
+			bool try_search_(const key_type& key, node_pointer* preds, node_pointer* succs)
+			{
+				const int		top = level_.load(std::memory_order_acquire);
+				node_pointer	pred = head_;
+
+				for (int level = max_level - 1; level >= top; --level)
+				{
+					preds[level] = head_;
+					succs[level] = NULL;
+				}
+				for (int level = top - 1; level >= 0; --level)
+				{
+					node_pointer curr = node_type::pointer(pred->next()[level].load(std::memory_order_acquire));
+					while (curr != NULL)
+					{
+						uintptr_t succ = curr->next()[level].load(std::memory_order_acquire);
+						if (node_type::is_marked(succ))
+						{
+							uintptr_t expected = link_(curr);
+							if (!pred->next()[level].compare_exchange_strong(expected, succ & ~uintptr_t(1)))
+								return false;
+							curr = node_type::pointer(succ);
+							continue;
+						}
+						if (!comp_(curr->val.first, key))
+							break;
+						pred = curr;
+						curr = node_type::pointer(succ);
+					}
+					preds[level] = pred;
+					succs[level] = curr;
+				}
+				return true;
+			}
+
+			/* read-only, skips the marked nodes instead of unlinking them.
+				the first node not less than key, or greater with Upper */
+			template <bool Upper>
+			node_pointer bound_(const key_type& key) const
+			{
+				const node_type*	pred = head_;
+				node_pointer		curr = NULL;
+
+				for (int level = level_.load(std::memory_order_acquire) - 1; level >= 0; --level)
+				{
+					curr = node_type::pointer(pred->next()[level].load(std::memory_order_acquire));
+					while (curr != NULL)
+					{
+						uintptr_t succ = curr->next()[level].load(std::memory_order_acquire);
+						if (!node_type::is_marked(succ))
+						{
+							if (Upper ? comp_(key, curr->val.first) : !comp_(curr->val.first, key))
+								break;
+							pred = curr;
+						}
+						curr = node_type::pointer(succ);
+					}
+				}
+				return curr;
+			}
+
+			/*
+				Links the levels above 0 of a node that is on level 0. Stops
+				once the node got marked, the erase that marked it may
+				already have searched past the levels linked so far, the
+				search before the retire in insert cleans those up.
+			*/
+			void link_upper_(node_pointer node, node_pointer* preds, node_pointer* succs)
+			{
+				for (int level = 1; level < node->level; ++level)
+				{
+					for (;;)
+					{
+						uintptr_t own = node->next()[level].load(std::memory_order_acquire);
+						if (node_type::is_marked(own))
+							return;
+						if (node_type::pointer(own) != succs[level]
+							&& !node->next()[level].compare_exchange_strong(own, link_(succs[level])))
+							continue;
+
+						uintptr_t expected = link_(succs[level]);
+						if (preds[level]->next()[level].compare_exchange_strong(expected, link_(node)))
+							break;
+						search_(node->val.first, preds, succs);
+						if (succs[0] != node)
+							return;
+					}
+				}
+			}
+	};
+
+} // namespace ft
+
+#endif // CONCURRENT_MAP_HPP
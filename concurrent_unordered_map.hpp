@@ -0,0 +1,724 @@
+#ifndef CONCURRENT_UNORDERED_MAP_HPP
+# define CONCURRENT_UNORDERED_MAP_HPP
+
+#include <functional>	// std::hash, std::equal_to
+#include <memory>		// std::allocator
+#include <stdexcept>	// std::out_of_range
+#include <atomic>
+#include <mutex>		// std::mutex
+#include <thread>		// std::this_thread
+#include <cstring>		// std::memcpy
+#include <new>			// placement new
+#include <type_traits>	// std::is_trivially_copyable, std::is_default_constructible
+
+#include "utility.hpp"
+#include "epoch.hpp"
+
+/*
+    A hash map for many threads, open addressing with linear probing.
+
+    Writers lock one of stripe_count mutexes, picked by the hash of the key,
+    so two writers only wait on each other when their keys share a stripe.
+    Readers take no lock. Every slot has a version, odd while a writer is
+    changing it; a reader copies the slot out and starts over if the version
+    moved meanwhile. That copy is why keys and mapped values have to be
+    trivially copyable (and default constructible, the copy is made into
+    one). Lookups hand out copies and never references.
+
+    Erase leaves a tombstone. Once three quarters of the slots are used a
+    new table is hung behind the current one, large enough for the live
+    elements and the inserts that can come before the move is done. Every
+    write then moves a chunk of slots over, each under the lock of its key's stripe. Inserts only go to
+    the new table. A moved slot keeps its key so readers know to go on to
+    the new table, and an empty slot is sealed so a writer can't claim it
+    late. Readers look through the old table and then the new one. The last
+    writer to finish a chunk makes the new table the only one and retires
+    the old one through epoch.hpp.
+
+    A writer that stalls halfway through its chunk holds the move up, the
+    others go on inserting into the new table. Once that one fills up too
+    another table is hung behind it, so tables form a chain: the oldest
+    is emptied into the newest, inserts go to the newest, and readers look
+    through all of them.
+
+    for_each() visits every element once. It finishes a running resize
+    first and holds off new ones until it returns; a writer finding the
+    table full meanwhile waits, without its stripe lock.
+*/
+
+namespace ft {
+
+	template <typename Key, typename T, typename Hash = std::hash<Key>,
+				typename KeyEqual = std::equal_to<Key>,
+				typename Allocator = std::allocator<ft::pair<const Key, T> > >
+	class concurrent_unordered_map
+	{
+		public:
+			typedef Key													key_type;
+			typedef T													mapped_type;
+			typedef ft::pair<const Key, T>								value_type;
+			typedef Hash												hasher;
+			typedef KeyEqual											key_equal;
+			typedef Allocator											allocator_type;
+			typedef typename allocator_type::size_type					size_type;
+
+			static const size_t		stripe_count = 64;
+
+		private:
+			static_assert(std::is_trivially_copyable<Key>::value
+							&& std::is_trivially_copyable<T>::value
+							&& std::is_default_constructible<Key>::value
+							&& std::is_default_constructible<T>::value,
+							"concurrent_unordered_map reads slots while they may change, "
+							"keys and mapped values must be trivially copyable and "
+							"default constructible");
+
+			typedef unsigned long		word_type;
+
+			static const size_t		key_words = (sizeof(Key) + sizeof(word_type) - 1) / sizeof(word_type);
+			static const size_t		mapped_words = (sizeof(T) + sizeof(word_type) - 1) / sizeof(word_type);
+
+			/* slot states. sealed and moved are only found in a table a
+				resize is emptying */
+			static const unsigned	slot_empty = 0;
+			static const unsigned	slot_busy = 1;
+			static const unsigned	slot_full = 2;
+			static const unsigned	slot_deleted = 3;
+			static const unsigned	slot_moved = 4;
+			static const unsigned	slot_sealed = 5;
+
+			struct slot
+			{
+				std::atomic<unsigned>		version;
+				std::atomic<unsigned>		state;
+				std::atomic<size_t>			hash;
+				std::atomic<word_type>		key[key_words];
+				std::atomic<word_type>		mapped[mapped_words];
+			};
+
+			struct table : public epoch_node
+			{
+				size_type					capacity;	// a power of 2
+				slot*						slots;
+				/* slots that ever left empty */
+				std::atomic<size_type>		used;
+				/* the table hung behind this one, set once and never cleared */
+				std::atomic<table*>			next;
+				/* chunks handed out to / finished by migrating writers */
+				std::atomic<size_type>		claimed;
+				std::atomic<size_type>		migrated;
+			};
+
+			struct alignas(64) stripe
+			{
+				std::mutex		lock;
+			};
+
+			typedef typename allocator_type::template rebind<table>::other		table_allocator_type;
+			typedef typename allocator_type::template rebind<slot>::other		slot_allocator_type;
+			typedef std::lock_guard<std::mutex>									lock_type;
+
+			static const size_type	min_capacity = 16;
+			static const size_type	migrate_chunk = 32;
+
+			table_allocator_type	table_alloc_;
+			slot_allocator_type		slot_alloc_;
+			hasher					hash_;
+			key_equal				eq_;
+			/* the oldest table that may still hold elements */
+			std::atomic<table*>		root_;
+			std::atomic<size_type>	size_;
+			stripe					stripes_[stripe_count];
+			/* starting a resize and starting a for_each exclude each other */
+			std::mutex				resize_lock_;
+			size_type				scanners_;
+			/* a resize a for_each held off, the next for_each starts it */
+			bool					resize_wanted_;
+			/* last member, the tables it still holds are freed first */
+			epoch_domain			epochs_;
+
+			concurrent_unordered_map(const concurrent_unordered_map&);
+			concurrent_unordered_map& operator=(const concurrent_unordered_map&);
+
+		public:
+			explicit concurrent_unordered_map(size_type n = 0, const Hash& hash = Hash(),
+												const KeyEqual& eq = KeyEqual(),
+												const Allocator& alloc = Allocator())
+				: table_alloc_(alloc), slot_alloc_(alloc), hash_(hash), eq_(eq),
+				root_(NULL), size_(0), scanners_(0), resize_wanted_(false),
+				epochs_(&reclaim_, this)
+			{
+				root_.store(create_table_(capacity_for_(n)), std::memory_order_relaxed);
+			}
+
+			/* no other thread may use the map any more */
+			~concurrent_unordered_map()
+			{
+				table* t = root_.load();
+
+				while (t != NULL)
+				{
+					table* next = t->next.load();
+					destroy_table_(t);
+					t = next;
+				}
+			}
+
+			/* exact only when no update is running */
+			size_type size() const { return size_.load(std::memory_order_relaxed); }
+
+			bool empty() const { return size() == 0; }
+
+			/* the slots of the newest table */
+			size_type bucket_count() const
+			{
+				epoch_guard guard(domain_());
+				return newest_()->capacity;
+			}
+
+			bool find(const key_type& key, mapped_type& obj) const
+			{
+				epoch_guard guard(domain_());
+				return read_(key, hash_of_(key), &obj);
+			}
+
+			size_type count(const key_type& key) const
+			{
+				epoch_guard guard(domain_());
+				return read_(key, hash_of_(key), NULL) ? 1 : 0;
+			}
+
+			mapped_type at(const key_type& key) const
+			{
+				mapped_type obj;
+
+				if (!find(key, obj))
+					throw std::out_of_range("ft::concurrent_unordered_map");
+				return obj;
+			}
+
+			/* false if the key was there already */
+			bool insert(const value_type& val)
+			{
+				return write_(val.first, &val.second, false);
+			}
+
+			/* true if the key was new */
+			bool insert_or_assign(const key_type& key, const mapped_type& obj)
+			{
+				return write_(key, &obj, true);
+			}
+
+			size_type erase(const key_type& key)
+			{
+				epoch_guard		guard(epochs_);
+				const size_t	hash = hash_of_(key);
+				table*			t;
+				size_type		i;
+
+				help_resize_(guard);
+				lock_type lock(stripe_of_(hash));
+				if (!locate_(key, hash, t, i))
+					return 0;
+				set_state_(t->slots[i], slot_deleted);
+				size_.fetch_sub(1, std::memory_order_relaxed);
+				return 1;
+			}
+
+			/* f(mapped_type&) under the lock of the key's stripe. f sees
+				a copy that is written back */
+			template <typename Function>
+			bool update(const key_type& key, Function f)
+			{
+				epoch_guard		guard(epochs_);
+				const size_t	hash = hash_of_(key);
+				table*			t;
+				size_type		i;
+
+				help_resize_(guard);
+				lock_type lock(stripe_of_(hash));
+				if (!locate_(key, hash, t, i))
+					return false;
+
+				mapped_type obj = load_words_<mapped_type, mapped_words>(t->slots[i].mapped);
+				f(obj);
+				write_mapped_(t->slots[i], obj);
+				return true;
+			}
+
+			/*
+				f(const key_type&, const mapped_type&) once for every element
+				there for the whole call, elements inserted or erased meanwhile
+				may or may not be visited. f may erase and update but not
+				insert, an insert might wait for a resize that waits for f.
+			*/
+			template <typename Function>
+			void for_each(Function f) const
+			{
+				concurrent_unordered_map& self = const_cast<concurrent_unordered_map&>(*this);
+				epoch_guard guard(self.epochs_);
+
+				{
+					lock_type lock(self.resize_lock_);
+					if (self.resize_wanted_)
+						self.hang_table_();
+					++self.scanners_;
+				}
+				try {
+					self.finish_resize_(guard);
+					scan_(root_.load(std::memory_order_acquire), f);
+				} catch (...) {
+					self.end_scan_();
+					throw;
+				}
+				self.end_scan_();
+			}
+
+			void clear()
+			{
+				for_each(eraser(*this));
+			}
+
+			hasher hash_function() const { return hash_; }
+
+			key_equal key_eq() const { return eq_; }
+
+		private:
+			struct eraser
+			{
+				concurrent_unordered_map&	map;
+
+				explicit eraser(concurrent_unordered_map& m) : map(m) {}
+
+				void operator()(const key_type& key, const mapped_type&) const { map.erase(key); }
+			};
+
+			/* guards only touch the domain's atomics and their own slot */
+			epoch_domain& domain_() const { return const_cast<epoch_domain&>(epochs_); }
+
+			size_t hash_of_(const key_type& key) const
+			{
+				unsigned long long h = hash_(key);
+
+				h *= 0x9E3779B97F4A7C15ULL;
+				return static_cast<size_t>(h ^ (h >> 32));
+			}
+
+			/* the top bits, the table index takes the bottom ones */
+			std::mutex& stripe_of_(size_t hash)
+			{
+				return stripes_[(hash >> (8 * sizeof(size_t) - 6)) % stripe_count].lock;
+			}
+
+			static size_type capacity_for_(size_type n)
+			{
+				size_type capacity = min_capacity;
+
+				while (capacity / 2 < n)
+					capacity *= 2;
+				return capacity;
+			}
+
+			table* create_table_(size_type capacity)
+			{
+				table* t = table_alloc_.allocate(1);
+
+				try {
+					::new (static_cast<void*>(t)) table();
+					t->slots = slot_alloc_.allocate(capacity);
+				} catch (...) {
+					table_alloc_.deallocate(t, 1);
+					throw;
+				}
+				for (size_type i = 0; i < capacity; ++i)
+					::new (static_cast<void*>(&t->slots[i])) slot();
+				t->capacity = capacity;
+				t->used.store(0, std::memory_order_relaxed);
+				t->next.store(NULL, std::memory_order_relaxed);
+				t->claimed.store(0, std::memory_order_relaxed);
+				t->migrated.store(0, std::memory_order_relaxed);
+				return t;
+			}
+
+			void destroy_table_(table* t)
+			{
+				slot_alloc_.deallocate(t->slots, t->capacity);
+				table_alloc_.deallocate(t, 1);
+			}
+
+			static void reclaim_(epoch_node* node, void* map)
+			{
+				static_cast<concurrent_unordered_map*>(map)->destroy_table_(static_cast<table*>(node));
+			}
+
+			table* newest_() const
+			{
+				table* t = root_.load(std::memory_order_acquire);
+
+				for (table* next; (next = t->next.load(std::memory_order_acquire)) != NULL; )
+					t = next;
+				return t;
+			}
+
+			template <typename U, size_t Words>
+			static void store_words_(std::atomic<word_type>* words, const U& value)
+			{
+				word_type buffer[Words] = {};
+
+				std::memcpy(static_cast<void*>(buffer), static_cast<const void*>(&value), sizeof(U));
+				for (size_t i = 0; i < Words; ++i)
+					words[i].store(buffer[i], std::memory_order_relaxed);
+			}
+
+			template <typename U, size_t Words>
+			static U load_words_(const std::atomic<word_type>* words)
+			{
+				word_type	buffer[Words];
+				U			value;
+
+				for (size_t i = 0; i < Words; ++i)
+					buffer[i] = words[i].load(std::memory_order_relaxed);
+				std::memcpy(static_cast<void*>(&value), static_cast<const void*>(buffer), sizeof(U));
+				return value;
+			}
+
+			/* the writer side of the version, one writer per slot at a time */
+			static void begin_write_(slot& s)
+			{
+				s.version.store(s.version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+			}
+
+			static void end_write_(slot& s)
+			{
+				s.version.store(s.version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			}
+
+			static void set_state_(slot& s, unsigned state)
+			{
+				begin_write_(s);
+				s.state.store(state, std::memory_order_relaxed);
+				end_write_(s);
+			}
+
+			static void write_mapped_(slot& s, const mapped_type& obj)
+			{
+				begin_write_(s);
+				store_words_<mapped_type, mapped_words>(s.mapped, obj);
+				end_write_(s);
+			}
+
+			/*
+				The reader side. Copies state, key and mapped value of a slot
+				as they were at one moment, spinning while a write is on.
+				Returns false for a slot whose key doesn't matter.
+			*/
+			bool read_slot_(const slot& s, size_t hash, unsigned& state, const key_type& key,
+							mapped_type* obj) const
+			{
+				for (;;)
+				{
+					const unsigned version = s.version.load(std::memory_order_acquire);
+					if (version & 1)
+					{
+						std::this_thread::yield();
+						continue;
+					}
+					state = s.state.load(std::memory_order_relaxed);
+					if (state != slot_full && state != slot_moved)
+						return false;
+					const size_t	slot_hash = s.hash.load(std::memory_order_relaxed);
+					const key_type	slot_key = load_words_<key_type, key_words>(s.key);
+					mapped_type		slot_obj;
+					if (obj != NULL)
+						slot_obj = load_words_<mapped_type, mapped_words>(s.mapped);
+					std::atomic_thread_fence(std::memory_order_acquire);
+					if (s.version.load(std::memory_order_relaxed) != version)
+						continue;
+
+					if (slot_hash != hash || !eq_(key, slot_key))
+						return false;
+					if (obj != NULL && state == slot_full)
+						*obj = slot_obj;
+					return true;
+				}
+			}
+
+			/* through the tables from the oldest. a moved slot with the key
+				sends the search on to the next table, so does the end of
+				the probe sequence */
+			bool read_(const key_type& key, size_t hash, mapped_type* obj) const
+			{
+				for (const table* t = root_.load(std::memory_order_acquire); t != NULL;
+						t = t->next.load(std::memory_order_acquire))
+				{
+					const size_type mask = t->capacity - 1;
+					for (size_type n = 0; n < t->capacity; ++n)
+					{
+						const slot&	s = t->slots[(hash + n) & mask];
+						unsigned	state;
+						if (read_slot_(s, hash, state, key, obj))
+						{
+							if (state == slot_full)
+								return true;
+							break;
+						}
+						if (state == slot_empty || state == slot_sealed)
+							break;
+					}
+				}
+				return false;
+			}
+
+			/* the slot holding key, with its stripe locked */
+			bool locate_(const key_type& key, size_t hash, table*& found, size_type& index)
+			{
+				for (table* t = root_.load(std::memory_order_acquire); t != NULL;
+						t = t->next.load(std::memory_order_acquire))
+				{
+					const size_type mask = t->capacity - 1;
+					for (size_type n = 0; n < t->capacity; ++n)
+					{
+						slot&			s = t->slots[(hash + n) & mask];
+						const unsigned	state = s.state.load(std::memory_order_acquire);
+						if (state == slot_empty || state == slot_sealed)
+							break;
+						if (state == slot_full && s.hash.load(std::memory_order_relaxed) == hash
+							&& eq_(key, load_words_<key_type, key_words>(s.key)))
+						{
+							found = t;
+							index = (hash + n) & mask;
+							return true;
+						}
+					}
+				}
+				return false;
+			}
+
+			/* claims the first free slot of the probe sequence in t. false
+				if t is full or a resize is emptying it */
+			bool place_(table* t, size_t hash, const key_type& key, const mapped_type& obj)
+			{
+				const size_type mask = t->capacity - 1;
+
+				for (size_type n = 0; n < t->capacity; ++n)
+				{
+					slot&		s = t->slots[(hash + n) & mask];
+					unsigned	state = s.state.load(std::memory_order_acquire);
+					if (state == slot_sealed || state == slot_moved)
+						return false;
+					if ((state == slot_empty || state == slot_deleted)
+						&& s.state.compare_exchange_strong(state, slot_busy, std::memory_order_acquire))
+					{
+						if (state == slot_empty)
+							t->used.fetch_add(1, std::memory_order_relaxed);
+						begin_write_(s);
+						s.hash.store(hash, std::memory_order_relaxed);
+						store_words_<key_type, key_words>(s.key, key);
+						store_words_<mapped_type, mapped_words>(s.mapped, obj);
+						s.state.store(slot_full, std::memory_order_relaxed);
+						end_write_(s);
+						return true;
+					}
+				}
+				return false;
+			}
+
+			/* moves the element of slot i of t to the newest table, the
+				stripe of its key is locked. a full newest table gets
+				another one behind it, waiting for room would wait for
+				writers that wait for this move */
+			void move_(table* t, size_type i)
+			{
+				slot&				s = t->slots[i];
+				const size_t		hash = s.hash.load(std::memory_order_relaxed);
+				const key_type		key = load_words_<key_type, key_words>(s.key);
+				const mapped_type	obj = load_words_<mapped_type, mapped_words>(s.mapped);
+
+				while (!place_(newest_(), hash, key, obj))
+				{
+					lock_type lock(resize_lock_);
+					hang_table_();
+				}
+				set_state_(s, slot_moved);
+			}
+
+			bool write_(const key_type& key, const mapped_type* obj, bool assign)
+			{
+				epoch_guard		guard(epochs_);
+				const size_t	hash = hash_of_(key);
+				table*			t;
+				size_type		i;
+
+				/* a full table waits for a resize, which may have to move a
+					slot of this stripe: wait without the lock */
+				for (;;)
+				{
+					help_resize_(guard);
+					{
+						lock_type lock(stripe_of_(hash));
+
+						if (locate_(key, hash, t, i))
+						{
+							/* in place even in a table being emptied, the
+								move of the slot waits for the lock */
+							if (assign)
+								write_mapped_(t->slots[i], *obj);
+							return false;
+						}
+						if (place_(newest_(), hash, key, *obj))
+							break;
+					}
+					start_resize_();
+					std::this_thread::yield();
+				}
+				size_.fetch_add(1, std::memory_order_relaxed);
+
+				table* n = newest_();
+				if (n->used.load(std::memory_order_relaxed) > n->capacity / 4 * 3)
+					start_resize_();
+				return true;
+			}
+
+			/* hangs a new table behind the newest one, unless that one
+				still has room. a running for_each only takes note, scans
+				back to back would hold the resize off forever */
+			void start_resize_()
+			{
+				std::unique_lock<std::mutex> lock(resize_lock_, std::try_to_lock);
+
+				if (!lock.owns_lock())
+					return;
+				if (scanners_ != 0)
+					resize_wanted_ = true;
+				else
+					hang_table_();
+			}
+
+			/*
+				resize_lock_ is held. The new table takes the live elements
+				and the inserts until the oldest table is emptied, one per
+				chunk when no writer stalls, at half load. Mostly tombstones
+				give a table of the same size.
+			*/
+			void hang_table_()
+			{
+				table* t = newest_();
+
+				resize_wanted_ = false;
+				if (t->used.load(std::memory_order_relaxed) <= t->capacity / 4 * 3)
+					return;
+
+				const size_type	needed = size_.load(std::memory_order_relaxed)
+										+ root_.load(std::memory_order_acquire)->capacity / migrate_chunk;
+				size_type		capacity = t->capacity;
+				while (capacity / 2 < needed)
+					capacity *= 2;
+				t->next.store(create_table_(capacity), std::memory_order_release);
+			}
+
+			/* moves one chunk of the table being emptied, no lock held */
+			void help_resize_(epoch_guard& guard)
+			{
+				table* t = root_.load(std::memory_order_acquire);
+
+				if (t->next.load(std::memory_order_acquire) == NULL)
+					return;
+
+				const size_type first = t->claimed.fetch_add(migrate_chunk, std::memory_order_relaxed);
+				if (first >= t->capacity)
+					return;
+
+				const size_type last = (first + migrate_chunk < t->capacity)
+										? first + migrate_chunk : t->capacity;
+				for (size_type i = first; i < last; ++i)
+					migrate_slot_(t, i);
+
+				if (t->migrated.fetch_add(last - first, std::memory_order_acq_rel) + (last - first)
+					== t->capacity)
+				{
+					root_.store(t->next.load(std::memory_order_acquire), std::memory_order_release);
+					guard.retire(t);
+				}
+			}
+
+			void migrate_slot_(table* t, size_type i)
+			{
+				slot& s = t->slots[i];
+
+				for (;;)
+				{
+					unsigned state = s.state.load(std::memory_order_acquire);
+					if (state == slot_empty)
+					{
+						if (s.state.compare_exchange_strong(state, slot_sealed))
+							return;
+					}
+					else if (state == slot_deleted)
+					{
+						if (s.state.compare_exchange_strong(state, slot_moved))
+							return;
+					}
+					else if (state == slot_busy)
+						std::this_thread::yield();
+					else if (state == slot_full)
+					{
+						lock_type lock(stripe_of_(s.hash.load(std::memory_order_relaxed)));
+						if (s.state.load(std::memory_order_acquire) == slot_full)
+						{
+							move_(t, i);
+							return;
+						}
+					}
+					else
+						return;
+				}
+			}
+
+			void finish_resize_(epoch_guard& guard)
+			{
+				for (table* t; (t = root_.load(std::memory_order_acquire))->next.load() != NULL; )
+				{
+					help_resize_(guard);
+					if (t->claimed.load(std::memory_order_relaxed) >= t->capacity)
+						std::this_thread::yield();
+				}
+			}
+
+			void end_scan_()
+			{
+				lock_type lock(resize_lock_);
+				--scanners_;
+			}
+
+			template <typename Function>
+			void scan_(const table* t, Function& f) const
+			{
+				for (size_type i = 0; i < t->capacity; ++i)
+				{
+					const slot& s = t->slots[i];
+					for (;;)
+					{
+						const unsigned version = s.version.load(std::memory_order_acquire);
+						if (version & 1)
+						{
+							std::this_thread::yield();
+							continue;
+						}
+						const unsigned		state = s.state.load(std::memory_order_relaxed);
+						const key_type		key = load_words_<key_type, key_words>(s.key);
+						const mapped_type	obj = load_words_<mapped_type, mapped_words>(s.mapped);
+						std::atomic_thread_fence(std::memory_order_acquire);
+						if (s.version.load(std::memory_order_relaxed) != version)
+							continue;
+						if (state == slot_full)
+							f(key, obj);
+						break;
+					}
+				}
+			}
+	};
+
+} // namespace ft
+
+#endif // CONCURRENT_UNORDERED_MAP_HPP
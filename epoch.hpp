@@ -0,0 +1,333 @@
+#ifndef EPOCH_HPP
+# define EPOCH_HPP
+
+#include <cstddef>		// size_t
+#include <atomic>
+#include <thread>		// std::this_thread
+#include <functional>	// std::hash
+
+/*
+    Epoch-based reclamation for the concurrent containers.
+
+    A thread pins the current epoch for the length of an operation, by
+    holding an epoch_guard. A node unlinked from a container is retired
+    instead of freed: it is stamped with the epoch of its unlinking and only
+    handed to the reclaim function once the epoch went two steps further.
+    The epoch only moves when every pinned guard sits on the current one, so
+    by then no guard that might have seen the node is left.
+
+    The guards a thread holds on a domain share one of max_slots slots: the
+    first claims it, the others add to its count, and it is pinned at the
+    oldest epoch any of them saw. So a thread may keep any number of
+    iterators, only the number of threads pinning at once is bounded (a
+    thread that finds no free slot waits for one). The last guard out gives
+    the slot back, on whatever thread it is destroyed, but retire only works
+    on the thread that made the guard. The retired nodes stay in the slot
+    they were retired from and are reclaimed by whoever holds it later, at
+    the latest by the destructor of the domain.
+*/
+
+namespace ft {
+
+	/* the part of a node the domain uses, nodes derive from it */
+	struct epoch_node
+	{
+		epoch_node*				retired_next;
+		unsigned long long		retired_epoch;
+	};
+
+	class epoch_guard;
+
+	class epoch_domain
+	{
+		public:
+			typedef void (*reclaim_function)(epoch_node* node, void* context);
+
+			static const size_t		max_slots = 128;
+
+		private:
+			/* epochs that are 0 mod 3 apart share a bag, a bag only holds
+				nodes of one epoch */
+			struct alignas(64) slot
+			{
+				/* claims << 32 | guards, free without guards */
+				std::atomic<unsigned long long>	state;
+				std::atomic<unsigned long long>	epoch;	// stale while free
+				epoch_node*						bags[3];
+				unsigned long long				bag_epochs[3];
+				size_t							retired;
+			};
+
+			/* the slot a thread holds in a domain, claim tells it from a
+				later claim of the same slot */
+			struct pin_cache
+			{
+				unsigned long long		domain;
+				size_t					slot;
+				unsigned long long		claim;
+			};
+
+			/* how many retires between two attempts to move the epoch */
+			static const size_t		advance_interval = 64;
+			/* ids cache_size apart share an entry. a thread pinning two such
+				domains at once may take more than one slot in them */
+			static const size_t		cache_size = 8;
+			static const unsigned long long	guard_mask = 0xFFFFFFFFULL;
+
+			alignas(64) std::atomic<unsigned long long>	epoch_;
+			/* never reused, a pin_cache can outlive its domain */
+			const unsigned long long					id_;
+			slot										slots_[max_slots];
+			reclaim_function							reclaim_;
+			void*										context_;
+
+			friend class epoch_guard;
+
+			epoch_domain(const epoch_domain&);
+			epoch_domain& operator=(const epoch_domain&);
+
+		public:
+			epoch_domain(reclaim_function reclaim, void* context)
+				: epoch_(1), id_(next_id_().fetch_add(1, std::memory_order_relaxed)),
+				reclaim_(reclaim), context_(context)
+			{
+				for (size_t i = 0; i < max_slots; ++i)
+				{
+					slots_[i].state.store(0, std::memory_order_relaxed);
+					slots_[i].epoch.store(0, std::memory_order_relaxed);
+					for (size_t b = 0; b < 3; ++b)
+					{
+						slots_[i].bags[b] = NULL;
+						slots_[i].bag_epochs[b] = 0;
+					}
+					slots_[i].retired = 0;
+				}
+			}
+
+			/* no guard may be left */
+			~epoch_domain()
+			{
+				for (size_t i = 0; i < max_slots; ++i)
+					for (size_t b = 0; b < 3; ++b)
+						reclaim_bag_(slots_[i], b);
+			}
+
+		private:
+			static size_t& slot_hint_()
+			{
+				static thread_local size_t	hint
+					= std::hash<std::thread::id>()(std::this_thread::get_id()) % max_slots;
+
+				return hint;
+			}
+
+			static std::atomic<unsigned long long>& next_id_()
+			{
+				static std::atomic<unsigned long long>	id(1);
+
+				return id;
+			}
+
+			pin_cache& cache_() const
+			{
+				static thread_local pin_cache	cache[cache_size] = {};
+
+				return cache[id_ % cache_size];
+			}
+
+			/* one more guard on the slot the thread holds, if it still
+				holds one */
+			bool share_(const pin_cache& c)
+			{
+				if (c.domain != id_)
+					return false;
+
+				std::atomic<unsigned long long>& state = slots_[c.slot].state;
+				unsigned long long current = state.load(std::memory_order_relaxed);
+				while ((current >> 32) == c.claim && (current & guard_mask) != 0)
+					if (state.compare_exchange_weak(current, current + 1, std::memory_order_acquire))
+						return true;
+				return false;
+			}
+
+			size_t claim_()
+			{
+				size_t&		hint = slot_hint_();
+				pin_cache&	c = cache_();
+
+				for (;;)
+				{
+					for (size_t n = 0; n < max_slots; ++n)
+					{
+						const size_t		i = (hint + n) % max_slots;
+						unsigned long long	state = slots_[i].state.load(std::memory_order_relaxed);
+						const unsigned long long claim = ((state >> 32) + 1) & guard_mask;
+						if ((state & guard_mask) == 0
+							&& slots_[i].state.compare_exchange_strong(state, (claim << 32) | 1,
+																		std::memory_order_acquire))
+						{
+							hint = i;
+							c.domain = id_;
+							c.slot = i;
+							c.claim = claim;
+							return i;
+						}
+					}
+					std::this_thread::yield();
+				}
+			}
+
+			/*
+				The slot of the thread with one more guard on it, pinned at
+				epoch or older. epoch 0 is the current one, it comes back
+				as what the guard got. The stores are seq_cst, try_advance_
+				either sees the pin or the guard sees every unlink that
+				happened before the advance.
+			*/
+			size_t pin_(unsigned long long& epoch)
+			{
+				const pin_cache& c = cache_();
+
+				if (share_(c))
+				{
+					const unsigned long long pinned = slots_[c.slot].epoch.load(std::memory_order_relaxed);
+					if (epoch == 0 || pinned < epoch)
+						epoch = pinned;
+					else if (epoch < pinned)
+						slots_[c.slot].epoch.store(epoch, std::memory_order_seq_cst);
+					return c.slot;
+				}
+
+				const size_t i = claim_();
+				if (epoch == 0)
+					epoch = epoch_.load(std::memory_order_seq_cst);
+				slots_[i].epoch.store(epoch, std::memory_order_seq_cst);
+				return i;
+			}
+
+			/* from any thread */
+			void unpin_(size_t i)
+			{
+				slots_[i].state.fetch_sub(1, std::memory_order_release);
+			}
+
+			void try_advance_()
+			{
+				unsigned long long epoch = epoch_.load(std::memory_order_seq_cst);
+
+				for (size_t i = 0; i < max_slots; ++i)
+				{
+					if ((slots_[i].state.load(std::memory_order_seq_cst) & guard_mask) == 0)
+						continue;
+					if (slots_[i].epoch.load(std::memory_order_seq_cst) != epoch)
+						return;
+				}
+				epoch_.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+			}
+
+			void reclaim_bag_(slot& s, size_t b)
+			{
+				epoch_node* node = s.bags[b];
+
+				s.bags[b] = NULL;
+				while (node != NULL)
+				{
+					epoch_node* next = node->retired_next;
+					reclaim_(node, context_);
+					node = next;
+				}
+			}
+
+			void retire_(size_t i, epoch_node* node)
+			{
+				slot&						s = slots_[i];
+				const unsigned long long	epoch = epoch_.load(std::memory_order_seq_cst);
+				const size_t				b = epoch % 3;
+
+				/* an older bag in the same place is at least 3 epochs old */
+				if (s.bag_epochs[b] != epoch)
+				{
+					reclaim_bag_(s, b);
+					s.bag_epochs[b] = epoch;
+				}
+				node->retired_epoch = epoch;
+				node->retired_next = s.bags[b];
+				s.bags[b] = node;
+
+				if (++s.retired % advance_interval == 0)
+				{
+					try_advance_();
+					const unsigned long long now = epoch_.load(std::memory_order_seq_cst);
+					for (size_t k = 0; k < 3; ++k)
+						if (s.bags[k] != NULL && s.bag_epochs[k] + 2 <= now)
+							reclaim_bag_(s, k);
+				}
+			}
+	};
+
+	/*
+		Pins the epoch of a domain while it lives. A copy pins the same epoch
+		as the original or an older one, so it protects the same nodes.
+	*/
+	class epoch_guard
+	{
+		private:
+			epoch_domain*			domain_;
+			size_t					slot_;
+			unsigned long long		epoch_;
+
+		public:
+			epoch_guard() : domain_(NULL), slot_(0), epoch_(0)
+			{}
+
+			explicit epoch_guard(epoch_domain& domain)
+				: domain_(&domain), slot_(0), epoch_(0)
+			{
+				slot_ = domain_->pin_(epoch_);
+			}
+
+			epoch_guard(const epoch_guard& other)
+				: domain_(other.domain_), slot_(0), epoch_(other.epoch_)
+			{
+				if (domain_ != NULL)
+					slot_ = domain_->pin_(epoch_);
+			}
+
+			epoch_guard& operator=(const epoch_guard& other)
+			{
+				epoch_guard tmp(other);
+				swap(tmp);
+				return *this;
+			}
+
+			~epoch_guard()
+			{
+				if (domain_ != NULL)
+					domain_->unpin_(slot_);
+			}
+
+			void swap(epoch_guard& other)
+			{
+				epoch_domain*		domain = domain_;
+				size_t				slot = slot_;
+				unsigned long long	epoch = epoch_;
+
+				domain_ = other.domain_;
+				slot_ = other.slot_;
+				epoch_ = other.epoch_;
+				other.domain_ = domain;
+				other.slot_ = slot;
+				other.epoch_ = epoch;
+			}
+
+			/* node is unreachable for guards created from now on. on the
+				thread that made the guard */
+			void retire(epoch_node* node)
+			{
+				domain_->retire_(slot_, node);
+			}
+	};
+
+} // namespace ft
+
+#endif // EPOCH_HPP
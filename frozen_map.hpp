@@ -0,0 +1,410 @@
+#ifndef FROZEN_MAP_HPP
+# define FROZEN_MAP_HPP
+
+#include <functional>	// std::less
+#include <memory>		// std::allocator
+#include <stdexcept>	// std::out_of_range, std::length_error
+
+#include "iterator.hpp"
+#include "algorithm.hpp"
+#include "utility.hpp"
+#include "map.hpp"
+
+/*
+    A read-only copy of an ft::map for lookups once a map stopped changing.
+
+    The elements are stored in order in one array, iteration is a walk over
+    it. The keys are copied a second time into Eytzinger order: the implicit
+    binary tree of a heap, the root at index 1 and the children of k at 2k
+    and 2k + 1. A descent then moves through the array in one direction and
+    the top levels share a few cache lines. The loop has no branch on the
+    comparison (k = 2k + (key at k < key)) and prefetches the cache line
+    with the descendants a few levels down, so the misses of consecutive
+    levels overlap instead of following each other like in the tree.
+
+    Keys, their positions in the sorted array and the elements live in one
+    allocation. A frozen_map has no insert or erase, the mapped values can
+    still be modified through the iterators.
+*/
+
+namespace ft {
+
+	template <typename Key, typename T, typename Compare = std::less<Key>,
+				typename Allocator = std::allocator<ft::pair<const Key, T> > >
+	class frozen_map
+	{
+		public:
+			typedef Key													key_type;
+			typedef T													mapped_type;
+			typedef ft::pair<const Key, T>								value_type;
+			typedef Compare												key_compare;
+			typedef Allocator											allocator_type;
+			typedef typename allocator_type::reference					reference;
+			typedef typename allocator_type::const_reference			const_reference;
+			typedef typename allocator_type::pointer					pointer;
+			typedef typename allocator_type::const_pointer				const_pointer;
+			typedef typename allocator_type::size_type					size_type;
+			typedef typename allocator_type::difference_type			difference_type;
+
+			typedef ft::normal_iterator<pointer, frozen_map>			iterator;
+			typedef ft::normal_iterator<const_pointer, frozen_map>		const_iterator;
+			typedef ft::reverse_iterator<iterator>						reverse_iterator;
+			typedef ft::reverse_iterator<const_iterator>				const_reverse_iterator;
+
+		private:
+			typedef typename allocator_type::template
+				rebind<key_type>::other									key_allocator_type;
+			typedef typename allocator_type::template
+				rebind<char>::other										block_allocator_type;
+
+			static const size_type		cache_line_ = 64;
+
+			/* levels below k whose keys share one cache line with the
+				first descendant of k, that line is prefetched */
+			static const size_type		prefetch_levels_ = (sizeof(key_type) <= 4) ? 4
+											: (sizeof(key_type) <= 8) ? 3
+											: (sizeof(key_type) <= 16) ? 2 : 1;
+
+			key_compare			comp_;
+			allocator_type		alloc_;
+			size_type			size_;
+			char*				block_;
+			size_type			block_size_;
+			/* [1, size_] in Eytzinger order, index 0 is not constructed */
+			key_type*			keys_;
+			/* ranks_[k] is the position of keys_[k] in values_,
+				ranks_[0] == size_ so that a failed search lands on end() */
+			size_type*			ranks_;
+			pointer				values_;
+
+		public:
+
+			explicit frozen_map(const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+				: comp_(comp), alloc_(alloc), size_(0), block_(NULL), block_size_(0),
+				keys_(NULL), ranks_(NULL), values_(NULL)
+			{
+				build_(static_cast<const_pointer>(NULL), 0);
+			}
+
+			/* copies the elements of m, m stays as it is */
+			template <typename Balance, typename Filter>
+			explicit frozen_map(const ft::map<Key, T, Compare, Allocator, Balance, Filter>& m)
+				: comp_(m.key_comp()), alloc_(m.get_allocator()), size_(0), block_(NULL),
+				block_size_(0), keys_(NULL), ranks_(NULL), values_(NULL)
+			{
+				build_(m.begin(), m.size());
+			}
+
+			frozen_map(const frozen_map& other)
+				: comp_(other.comp_), alloc_(other.alloc_), size_(0), block_(NULL),
+				block_size_(0), keys_(NULL), ranks_(NULL), values_(NULL)
+			{
+				build_(other.begin(), other.size_);
+			}
+
+			~frozen_map()
+			{
+				destroy_();
+			}
+
+			frozen_map& operator=(const frozen_map& other)
+			{
+				if (this != &other)
+				{
+					frozen_map tmp(other);
+					swap(tmp);
+				}
+				return *this;
+			}
+
+
+			iterator begin() { return iterator(values_); }
+
+			const_iterator begin() const { return const_iterator(values_); }
+
+			iterator end() { return iterator(values_ + size_); }
+
+			const_iterator end() const { return const_iterator(values_ + size_); }
+
+			reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+			const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+			reverse_iterator rend() { return reverse_iterator(begin()); }
+
+			const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+			bool empty() const { return size_ == 0; }
+
+			size_type size() const { return size_; }
+
+			size_type max_size() const
+			{
+				return block_allocator_type(alloc_).max_size()
+					/ (sizeof(value_type) + sizeof(key_type) + sizeof(size_type));
+			}
+
+			mapped_type& at(const key_type& key)
+			{
+				iterator it = find(key);
+
+				if (it == end())
+					throw std::out_of_range("ft::frozen_map");
+				return it->second;
+			}
+
+			const mapped_type& at(const key_type& key) const
+			{
+				const_iterator it = find(key);
+
+				if (it == end())
+					throw std::out_of_range("ft::frozen_map");
+				return it->second;
+			}
+
+			void swap(frozen_map& other)
+			{
+				ft::swap(comp_, other.comp_);
+				ft::swap(alloc_, other.alloc_);
+				ft::swap(size_, other.size_);
+				ft::swap(block_, other.block_);
+				ft::swap(block_size_, other.block_size_);
+				ft::swap(keys_, other.keys_);
+				ft::swap(ranks_, other.ranks_);
+				ft::swap(values_, other.values_);
+			}
+
+			key_compare key_comp() const { return comp_; }
+
+			iterator find(const key_type& key)
+			{
+				return iterator(values_ + find_rank_(key));
+			}
+
+			const_iterator find(const key_type& key) const
+			{
+				return const_iterator(values_ + find_rank_(key));
+			}
+
+			size_type count(const key_type& key) const
+			{
+				return (find_rank_(key) != size_) ? 1 : 0;
+			}
+
+			iterator lower_bound(const key_type& key)
+			{
+				return iterator(values_ + ranks_[lower_index_(key)]);
+			}
+
+			const_iterator lower_bound(const key_type& key) const
+			{
+				return const_iterator(values_ + ranks_[lower_index_(key)]);
+			}
+
+			iterator upper_bound(const key_type& key)
+			{
+				return iterator(values_ + ranks_[upper_index_(key)]);
+			}
+
+			const_iterator upper_bound(const key_type& key) const
+			{
+				return const_iterator(values_ + ranks_[upper_index_(key)]);
+			}
+
+			ft::pair<iterator, iterator> equal_range(const key_type& key)
+			{
+				return ft::make_pair(lower_bound(key), upper_bound(key));
+			}
+
+			ft::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+			{
+				return ft::make_pair(lower_bound(key), upper_bound(key));
+			}
+
+			allocator_type get_allocator() const { return alloc_; }
+
+
+		private:
+
+			/* the descent stepped right on every key smaller than the one
+				searched for. the answer is the last node where it went left,
+				found by dropping the trailing ones and one more bit from k */
+			static size_type ascend_(size_type k)
+			{
+#if defined(__GNUC__) || defined(__clang__)
+				return k >> __builtin_ffsll(~static_cast<unsigned long long>(k));
+#else
+				while (k & 1)
+					k >>= 1;
+				return k >> 1;
+#endif
+			}
+
+			void prefetch_(size_type k) const
+			{
+				const size_type ahead = k << prefetch_levels_;
+
+				FT_PREFETCH(keys_ + (ahead <= size_ ? ahead : 0));
+			}
+
+			/* index into keys_ of the first key not less than key, 0 if none */
+			size_type lower_index_(const key_type& key) const
+			{
+				size_type k = 1;
+
+				while (k <= size_)
+				{
+					prefetch_(k);
+					k = 2 * k + comp_(keys_[k], key);
+				}
+				return ascend_(k);
+			}
+
+			/* index into keys_ of the first key greater than key, 0 if none */
+			size_type upper_index_(const key_type& key) const
+			{
+				size_type k = 1;
+
+				while (k <= size_)
+				{
+					prefetch_(k);
+					k = 2 * k + !comp_(key, keys_[k]);
+				}
+				return ascend_(k);
+			}
+
+			/* position in values_, size_ if key is missing */
+			size_type find_rank_(const key_type& key) const
+			{
+				const size_type k = lower_index_(key);
+
+				if (k == 0 || comp_(key, keys_[k]))
+					return size_;
+				return ranks_[k];
+			}
+
+			static size_type align_up_(size_type n, size_type alignment)
+			{
+				return (n + alignment - 1) / alignment * alignment;
+			}
+
+			/* in-order walk of the implicit tree, hands out the sorted
+				positions 0, 1, ... in the order the nodes are visited */
+			size_type fill_ranks_(size_type k, size_type rank)
+			{
+				if (k > size_)
+					return rank;
+				rank = fill_ranks_(2 * k, rank);
+				ranks_[k] = rank++;
+				return fill_ranks_(2 * k + 1, rank);
+			}
+
+			/* first has to yield the n elements in ascending order */
+			template <typename InputIt>
+			void build_(InputIt first, size_type n)
+			{
+				if (n > max_size())
+					throw std::length_error("ft::frozen_map");
+
+				/* keys first and aligned to a cache line, the levels below a
+					node then start on a line boundary */
+				const size_type ranks_offset = align_up_((n + 1) * sizeof(key_type),
+																sizeof(size_type));
+				const size_type values_offset = align_up_(ranks_offset
+												+ (n + 1) * sizeof(size_type), cache_line_);
+
+				block_allocator_type block_alloc(alloc_);
+				block_size_ = values_offset + n * sizeof(value_type) + cache_line_;
+				block_ = block_alloc.allocate(block_size_);
+
+				char* base = block_ + (cache_line_ - reinterpret_cast<size_t>(block_) % cache_line_)
+								% cache_line_;
+				keys_ = reinterpret_cast<key_type*>(base);
+				ranks_ = reinterpret_cast<size_type*>(base + ranks_offset);
+				values_ = reinterpret_cast<pointer>(base + values_offset);
+				size_ = 0;
+
+				key_allocator_type key_alloc(alloc_);
+				size_type keys = 0;
+				try {
+					for (; size_ < n; ++size_, ++first)
+						alloc_.construct(values_ + size_, *first);
+					ranks_[0] = size_;
+					fill_ranks_(1, 0);
+					for (keys = 1; keys <= size_; ++keys)
+						key_alloc.construct(keys_ + keys, values_[ranks_[keys]].first);
+				} catch (...) {
+					while (keys > 1)
+						key_alloc.destroy(keys_ + --keys);
+					while (size_ > 0)
+						alloc_.destroy(values_ + --size_);
+					block_alloc.deallocate(block_, block_size_);
+					block_ = NULL;
+					throw;
+				}
+			}
+
+			void destroy_()
+			{
+				key_allocator_type key_alloc(alloc_);
+
+				for (size_type k = 1; k <= size_; ++k)
+					key_alloc.destroy(keys_ + k);
+				for (size_type i = 0; i < size_; ++i)
+					alloc_.destroy(values_ + i);
+				if (block_ != NULL)
+					block_allocator_type(alloc_).deallocate(block_, block_size_);
+			}
+	};
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	bool operator==(const frozen_map<Key, T, Compare, Alloc>& lhs,
+					const frozen_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	bool operator!=(const frozen_map<Key, T, Compare, Alloc>& lhs,
+					const frozen_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	bool operator<(const frozen_map<Key, T, Compare, Alloc>& lhs,
+					const frozen_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	bool operator<=(const frozen_map<Key, T, Compare, Alloc>& lhs,
+					const frozen_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return !(rhs < lhs);
+	}
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	bool operator>(const frozen_map<Key, T, Compare, Alloc>& lhs,
+					const frozen_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return rhs < lhs;
+	}
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	bool operator>=(const frozen_map<Key, T, Compare, Alloc>& lhs,
+					const frozen_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return !(lhs < rhs);
+	}
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	void swap(frozen_map<Key, T, Compare, Alloc>& lhs, frozen_map<Key, T, Compare, Alloc>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+
+} // namespace ft
+
+#endif // FROZEN_MAP_HPP
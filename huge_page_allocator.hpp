@@ -0,0 +1,161 @@
+#ifndef HUGE_PAGE_ALLOCATOR_HPP
+# define HUGE_PAGE_ALLOCATOR_HPP
+
+#include <cstddef>		// size_t, ptrdiff_t
+#include <limits>
+#include <new>			// std::bad_alloc, placement new
+#include <sys/mman.h>	// mmap, munmap, madvise
+
+/*
+    An allocator for big arrays that are read all over the place, an
+    ft::vector of a few GB probed at random. With 4 KiB pages every probe
+    is a TLB miss and a page walk of its own. A 2 MiB page covers 512 of
+    them, so the TLB reaches 512 times as far.
+
+        ft::vector<record, ft::huge_page_allocator<record> >   v;
+
+    Blocks smaller than Threshold bytes come from operator new like with
+    std::allocator. Bigger ones are mapped directly, rounded up to 2 MiB
+    and aligned to 2 MiB, so the kernel can back all of the block with huge
+    pages, and are handed to transparent huge pages with
+    madvise(MADV_HUGEPAGE). That is a hint, with THP off the block is
+    ordinary memory.
+
+    With HugeTLB the big blocks are asked for from the reserved huge page
+    pool first (MAP_HUGETLB, see /proc/sys/vm/nr_hugepages), the pages are
+    there from the start and can't be split or swapped. When the pool has
+    too few of them the block falls back to the madvise way, so a program
+    doesn't have to care whether the pool was set up.
+
+    The allocator has no state, any two compare equal. A block has to be
+    deallocated with the size it was allocated with, which is what the
+    containers do anyway.
+*/
+
+namespace ft {
+
+	template <typename T, size_t Threshold = size_t(1) << 21, bool HugeTLB = false>
+	class huge_page_allocator
+	{
+		public:
+			typedef T				value_type;
+			typedef T*				pointer;
+			typedef const T*		const_pointer;
+			typedef T&				reference;
+			typedef const T&		const_reference;
+			typedef size_t			size_type;
+			typedef ptrdiff_t		difference_type;
+
+			template <typename U>
+			struct rebind
+			{
+				typedef huge_page_allocator<U, Threshold, HugeTLB>	other;
+			};
+
+			static const size_type	huge_page_size = size_type(1) << 21;
+			static const size_type	threshold = Threshold;
+
+			huge_page_allocator() {}
+
+			template <typename U>
+			huge_page_allocator(const huge_page_allocator<U, Threshold, HugeTLB>&) {}
+
+			pointer allocate(size_type n)
+			{
+				if (n > max_size())
+					throw std::bad_alloc();
+
+				const size_type bytes = n * sizeof(T);
+				if (bytes < Threshold)
+					return static_cast<pointer>(::operator new(bytes));
+
+				void* block = NULL;
+				if (HugeTLB)
+					block = map_hugetlb_(round_(bytes));
+				if (block == NULL)
+					block = map_aligned_(round_(bytes));
+				return static_cast<pointer>(block);
+			}
+
+			void deallocate(pointer p, size_type n)
+			{
+				const size_type bytes = n * sizeof(T);
+
+				if (bytes < Threshold)
+					::operator delete(p);
+				else
+					munmap(p, round_(bytes));
+			}
+
+			void construct(pointer p, const_reference val) { ::new (static_cast<void*>(p)) T(val); }
+
+			void destroy(pointer p) { p->~T(); }
+
+			size_type max_size() const
+			{
+				return (std::numeric_limits<difference_type>::max() - huge_page_size) / sizeof(T);
+			}
+
+		private:
+			static size_type round_(size_type bytes)
+			{
+				return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+			}
+
+			/* NULL when the pool can't give them */
+			static void* map_hugetlb_(size_type bytes)
+			{
+#ifdef MAP_HUGETLB
+				void* block = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+									MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+				return (block == MAP_FAILED) ? NULL : block;
+#else
+				(void)bytes;
+				return NULL;
+#endif
+			}
+
+			/* mmap only promises 4 KiB alignment: one huge page more is
+				mapped and what sticks out on either side goes back */
+			static void* map_aligned_(size_type bytes)
+			{
+				void* mapped = mmap(NULL, bytes + huge_page_size, PROT_READ | PROT_WRITE,
+									MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+				if (mapped == MAP_FAILED)
+					throw std::bad_alloc();
+
+				char* const	first = static_cast<char*>(mapped);
+				char* const	block = reinterpret_cast<char*>(
+					(reinterpret_cast<size_t>(first) + huge_page_size - 1) & ~(huge_page_size - 1));
+				char* const	last = first + bytes + huge_page_size;
+
+				if (block != first)
+					munmap(first, block - first);
+				if (block + bytes != last)
+					munmap(block + bytes, last - (block + bytes));
+#ifdef MADV_HUGEPAGE
+				madvise(block, bytes, MADV_HUGEPAGE);
+#endif
+				return block;
+			}
+	};
+
+	template <typename T, typename U, size_t Threshold, bool HugeTLB>
+	bool operator==(const huge_page_allocator<T, Threshold, HugeTLB>&,
+					const huge_page_allocator<U, Threshold, HugeTLB>&)
+	{
+		return true;
+	}
+
+	template <typename T, typename U, size_t Threshold, bool HugeTLB>
+	bool operator!=(const huge_page_allocator<T, Threshold, HugeTLB>&,
+					const huge_page_allocator<U, Threshold, HugeTLB>&)
+	{
+		return false;
+	}
+
+} // namespace ft
+
+#endif // HUGE_PAGE_ALLOCATOR_HPP
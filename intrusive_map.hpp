@@ -0,0 +1,401 @@
+#ifndef INTRUSIVE_MAP_HPP
+# define INTRUSIVE_MAP_HPP
+
+#include <cstddef>		// size_t, ptrdiff_t
+#include <functional>	// std::less
+#include <type_traits>	// std::is_convertible
+
+#include "iterator.hpp"
+#include "utility.hpp"
+#include "red_black_tree.hpp"
+#include "type_traits.hpp"
+
+/*
+    An ordered map over objects that live somewhere else, in a pool, on the
+    stack, inside other objects. The links come with the object: its type
+    derives from intrusive_hook, which is the node base of a red-black
+    rb_tree (parent, left, right and color). The map only links and
+    unlinks, it never allocates and never copies an element, and it does
+    not own them: an object has to stay where it is while it is linked and
+    has to be erased before it goes away.
+
+        struct order : ft::intrusive_hook<>
+        {
+            int     id;
+            ...
+        };
+        struct id_of { const int& operator()(const order& o) const { return o.id; } };
+
+        ft::intrusive_map<int, order, id_of>    orders;
+        orders.insert(pool[i]);
+        orders.erase(pool[i]);      // O(log n), no lookup
+
+    KeyOf reads the key of an object. The key must not change while the
+    object is linked. An object that should sit in several maps at once
+    derives from one hook per map, told apart by the Tag of the hook and
+    the map.
+
+    Balancing is the one of rb_tree (tree_insert_rebalance and
+    tree_erase_rebalance), the root hangs as the left child of a header
+    inside the map that also serves as end().
+*/
+
+namespace ft {
+
+	template <typename Tag = void>
+	struct intrusive_hook : public rb_node_base
+	{
+		intrusive_hook() {}
+
+		/* a copied object is not linked anywhere */
+		intrusive_hook(const intrusive_hook&) : rb_node_base() {}
+
+		intrusive_hook& operator=(const intrusive_hook&) { return *this; }
+
+		/* the map clears parent when it unlinks the object */
+		bool is_linked() const { return parent != NULL; }
+	};
+
+
+	template <typename Key, typename T, typename KeyOf, typename Compare = std::less<Key>,
+				typename Tag = void>
+	class intrusive_map
+	{
+		public:
+			typedef Key									key_type;
+			typedef T									value_type;
+			typedef KeyOf								key_of;
+			typedef Compare								key_compare;
+			typedef intrusive_hook<Tag>					hook_type;
+			typedef size_t								size_type;
+			typedef ptrdiff_t							difference_type;
+			typedef T&									reference;
+			typedef const T&							const_reference;
+			typedef T*									pointer;
+			typedef const T*							const_pointer;
+
+			template <typename V>
+			class basic_iterator
+			{
+				public:
+					typedef bidirectional_iterator_tag	iterator_category;
+					typedef T							value_type;
+					typedef V&							reference;
+					typedef V*							pointer;
+					typedef ptrdiff_t					difference_type;
+
+				private:
+					rb_node_base*	node_;
+
+					friend class intrusive_map;
+
+				public:
+					basic_iterator() : node_(NULL)
+					{}
+
+					/* iterator to const_iterator, not the other way */
+					template <typename U>
+					basic_iterator(const basic_iterator<U>& other,
+									typename ft::enable_if<std::is_convertible<U*, V*>::value>::type* = 0)
+						: node_(other.base())
+					{}
+
+					rb_node_base* base() const { return node_; }
+
+					reference operator*() const { return object_of_(node_); }
+
+					pointer operator->() const { return &object_of_(node_); }
+
+					basic_iterator& operator++()
+					{
+						node_ = tree_next(node_);
+						return *this;
+					}
+
+					basic_iterator operator++(int)
+					{
+						basic_iterator tmp = *this;
+						++(*this);
+						return tmp;
+					}
+
+					basic_iterator& operator--()
+					{
+						node_ = tree_prev(node_);
+						return *this;
+					}
+
+					basic_iterator operator--(int)
+					{
+						basic_iterator tmp = *this;
+						--(*this);
+						return tmp;
+					}
+
+					friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs)
+					{
+						return lhs.node_ == rhs.node_;
+					}
+
+					friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs)
+					{
+						return !(lhs == rhs);
+					}
+
+				private:
+					explicit basic_iterator(rb_node_base* node) : node_(node)
+					{}
+			};
+
+			typedef basic_iterator<T>						iterator;
+			typedef basic_iterator<const T>					const_iterator;
+			typedef ft::reverse_iterator<iterator>			reverse_iterator;
+			typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+
+		private:
+			/* header_.left is the root, header_ is end() */
+			rb_node_base	header_;
+			rb_node_base*	leftmost_;
+			size_type		size_;
+			key_of			key_of_;
+			key_compare		comp_;
+
+		public:
+			explicit intrusive_map(const KeyOf& key_of = KeyOf(), const Compare& comp = Compare())
+				: leftmost_(&header_), size_(0), key_of_(key_of), comp_(comp)
+			{}
+
+			/* unlinks what is still linked, the objects stay */
+			~intrusive_map() { clear(); }
+
+			iterator begin() { return iterator(leftmost_); }
+
+			const_iterator begin() const { return const_iterator(leftmost_); }
+
+			iterator end() { return iterator(&header_); }
+
+			const_iterator end() const { return const_iterator(const_cast<rb_node_base*>(&header_)); }
+
+			reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+			const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+			reverse_iterator rend() { return reverse_iterator(begin()); }
+
+			const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+			bool empty() const { return size_ == 0; }
+
+			size_type size() const { return size_; }
+
+			/* links obj unless an object with an equivalent key is linked
+				already, obj must not be linked into this map */
+			ft::pair<iterator, bool> insert(T& obj)
+			{
+				const Key&		key = key_of_(obj);
+				rb_node_base*	parent = &header_;
+				rb_node_base**	link = &header_.left;
+
+				while (*link != NULL)
+				{
+					parent = *link;
+					if (comp_(key, key_of_(object_of_(parent))))
+						link = &parent->left;
+					else if (comp_(key_of_(object_of_(parent)), key))
+						link = &parent->right;
+					else
+						return ft::make_pair(iterator(parent), false);
+				}
+
+				rb_node_base* node = static_cast<hook_type*>(&obj);
+				node->parent = parent;
+				node->left = NULL;
+				node->right = NULL;
+				*link = node;
+				if (leftmost_ == &header_ || (parent == leftmost_ && link == &parent->left))
+					leftmost_ = node;
+				tree_insert_rebalance(header_.left, node);
+				++size_;
+				return ft::make_pair(iterator(node), true);
+			}
+
+			/* an iterator to obj, O(1) */
+			iterator iterator_to(T& obj) { return iterator(static_cast<hook_type*>(&obj)); }
+
+			const_iterator iterator_to(const T& obj) const
+			{
+				return const_iterator(const_cast<hook_type*>(static_cast<const hook_type*>(&obj)));
+			}
+
+			/* obj has to be linked into this map. no lookup, the hook
+				knows where obj is */
+			void erase(T& obj)
+			{
+				unlink_(static_cast<hook_type*>(&obj));
+			}
+
+			iterator erase(iterator position)
+			{
+				rb_node_base* node = position.base();
+
+				++position;
+				unlink_(node);
+				return position;
+			}
+
+			size_type erase(const Key& key)
+			{
+				iterator it = find(key);
+
+				if (it == end())
+					return 0;
+				unlink_(it.base());
+				return 1;
+			}
+
+			/* every object is unlinked, O(n) to mark their hooks */
+			void clear()
+			{
+				rb_node_base* node = header_.left;
+
+				/* the right spine of every left child is walked down as
+					it comes, no stack needed */
+				while (node != NULL)
+				{
+					if (node->left != NULL)
+					{
+						rb_node_base* left = node->left;
+						node->left = left->right;
+						left->right = node;
+						node = left;
+					}
+					else
+					{
+						rb_node_base* right = node->right;
+						node->parent = NULL;
+						node->right = NULL;
+						node = right;
+					}
+				}
+				header_.left = NULL;
+				leftmost_ = &header_;
+				size_ = 0;
+			}
+
+			iterator find(const Key& key)
+			{
+				iterator it = lower_bound(key);
+
+				return (it == end() || comp_(key, key_of_(*it))) ? end() : it;
+			}
+
+			const_iterator find(const Key& key) const
+			{
+				return const_cast<intrusive_map*>(this)->find(key);
+			}
+
+			size_type count(const Key& key) const { return find(key) != end(); }
+
+			iterator lower_bound(const Key& key)
+			{
+				rb_node_base* node = header_.left;
+				rb_node_base* result = &header_;
+
+				while (node != NULL)
+				{
+					if (!comp_(key_of_(object_of_(node)), key))
+					{
+						result = node;
+						node = node->left;
+					}
+					else
+						node = node->right;
+				}
+				return iterator(result);
+			}
+
+			const_iterator lower_bound(const Key& key) const
+			{
+				return const_cast<intrusive_map*>(this)->lower_bound(key);
+			}
+
+			iterator upper_bound(const Key& key)
+			{
+				rb_node_base* node = header_.left;
+				rb_node_base* result = &header_;
+
+				while (node != NULL)
+				{
+					if (comp_(key, key_of_(object_of_(node))))
+					{
+						result = node;
+						node = node->left;
+					}
+					else
+						node = node->right;
+				}
+				return iterator(result);
+			}
+
+			const_iterator upper_bound(const Key& key) const
+			{
+				return const_cast<intrusive_map*>(this)->upper_bound(key);
+			}
+
+			/* the header is part of the map, the root has to be told
+				where its parent went */
+			void swap(intrusive_map& other)
+			{
+				ft::swap(header_.left, other.header_.left);
+				ft::swap(leftmost_, other.leftmost_);
+				ft::swap(size_, other.size_);
+				ft::swap(key_of_, other.key_of_);
+				ft::swap(comp_, other.comp_);
+				fix_header_(other);
+				other.fix_header_(*this);
+			}
+
+			key_compare key_comp() const { return comp_; }
+
+		private:
+			/* the map links objects, copying one would link them twice */
+			intrusive_map(const intrusive_map&);
+			intrusive_map& operator=(const intrusive_map&);
+
+			static T& object_of_(rb_node_base* node)
+			{
+				return static_cast<T&>(static_cast<hook_type&>(*node));
+			}
+
+			void unlink_(rb_node_base* node)
+			{
+				if (node == leftmost_)
+					leftmost_ = tree_next(node);
+				tree_erase_rebalance(header_.left, node);
+				node->parent = NULL;
+				node->left = NULL;
+				node->right = NULL;
+				--size_;
+			}
+
+			/* after a swap: the root and leftmost_ may still point to the
+				header of the other map */
+			void fix_header_(intrusive_map& other)
+			{
+				if (header_.left != NULL)
+					header_.left->parent = &header_;
+				if (leftmost_ == &other.header_)
+					leftmost_ = &header_;
+			}
+	};
+
+	template <typename Key, typename T, typename KeyOf, typename Compare, typename Tag>
+	void swap(intrusive_map<Key, T, KeyOf, Compare, Tag>& lhs,
+				intrusive_map<Key, T, KeyOf, Compare, Tag>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+
+} // namespace ft
+
+#endif // INTRUSIVE_MAP_HPP
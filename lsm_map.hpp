@@ -0,0 +1,528 @@
+#ifndef LSM_MAP_HPP
+# define LSM_MAP_HPP
+
+#include <functional>	// std::less
+#include <memory>		// std::allocator
+#include <stdexcept>	// std::out_of_range
+
+#include "map.hpp"
+#include "vector.hpp"
+
+/*
+    An ordered map for write-heavy work, after the log-structured merge tree.
+
+    Writes go to a small ft::map, the memtable. Once it holds
+    memtable_limit records it is flushed to a run, an immutable ft::vector
+    sorted by key, and starts over. Runs are size-tiered: a run of up to
+    tier_fanout^t * memtable_limit records is in tier t, and whenever the
+    newest tier_fanout runs share a tier they are merged into one. Every
+    record is so copied about log(n / memtable_limit) / log(tier_fanout)
+    times, instead of every write rebalancing a tree of n nodes.
+
+    An erase is a write too, a tombstone that hides older records of the
+    key until a merge that reaches the oldest run drops both. Writes are
+    blind, they don't look for the key first, so the map can't keep a count
+    of its elements and there is no size().
+
+    Lookups check the memtable, then the runs from the newest to the oldest;
+    the first record of the key wins. Scans merge the memtable and the runs
+    in key order. Any write may flush and merge, and invalidates iterators.
+*/
+
+namespace ft {
+
+	/* what the memtable and the runs store, erased marks a tombstone */
+	template <typename Value>
+	struct lsm_record
+	{
+		Value	value;
+		bool	erased;
+
+		lsm_record(const Value& val, bool e) : value(val), erased(e)
+		{}
+	};
+
+	template <typename Key, typename T, typename Compare = std::less<Key>,
+				typename Allocator = std::allocator<ft::pair<const Key, T> > >
+	class lsm_map
+	{
+		public:
+			typedef Key													key_type;
+			typedef T													mapped_type;
+			typedef ft::pair<const Key, T>								value_type;
+			typedef Compare												key_compare;
+			typedef Allocator											allocator_type;
+			typedef typename allocator_type::size_type					size_type;
+			typedef typename allocator_type::difference_type			difference_type;
+
+			static const size_type		tier_fanout = 4;
+
+		private:
+			typedef lsm_record<value_type>								record;
+			typedef typename allocator_type::template rebind<ft::pair<const Key, record> >::other
+																		memtable_allocator_type;
+			typedef typename allocator_type::template rebind<record>::other	record_allocator_type;
+			typedef ft::map<Key, record, Compare, memtable_allocator_type>	memtable_type;
+			typedef ft::vector<record, record_allocator_type>			records_type;
+
+			struct run
+			{
+				records_type	records;
+				size_type		tier;
+
+				run() : tier(0) {}
+
+				void swap(run& other)
+				{
+					records.swap(other.records);
+					ft::swap(tier, other.tier);
+				}
+			};
+
+			/* oldest first, the tiers never grow from one run to the next */
+			typedef ft::vector<run>										runs_type;
+
+			memtable_type		memtable_;
+			runs_type			runs_;
+			size_type			memtable_limit_;
+			key_compare			comp_;
+			allocator_type		alloc_;
+
+		public:
+
+			/* a merge of the memtable and the runs. on equal keys the newest
+				record wins, tombstones are skipped */
+			class const_iterator
+			{
+				public:
+					typedef forward_iterator_tag		iterator_category;
+					typedef typename lsm_map::value_type	value_type;
+					typedef const value_type&			reference;
+					typedef const value_type*			pointer;
+					typedef ptrdiff_t					difference_type;
+
+				private:
+					const lsm_map*							map_;
+					typename memtable_type::const_iterator	mem_;
+					ft::vector<size_type>					pos_;
+					const record*							cur_;
+
+					friend class lsm_map;
+
+				public:
+					const_iterator() : map_(NULL), cur_(NULL)
+					{}
+
+					reference operator*() const { return cur_->value; }
+
+					pointer operator->() const { return &cur_->value; }
+
+					const_iterator& operator++()
+					{
+						skip_(cur_->value.first);
+						settle_();
+						return *this;
+					}
+
+					const_iterator operator++(int)
+					{
+						const_iterator tmp = *this;
+						++(*this);
+						return tmp;
+					}
+
+					friend bool operator==(const const_iterator& lhs, const const_iterator& rhs)
+					{
+						return lhs.cur_ == rhs.cur_;
+					}
+
+					friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs)
+					{
+						return !(lhs == rhs);
+					}
+
+				private:
+					/* each source on its first record not less than key */
+					const_iterator(const lsm_map& map, const key_type* key)
+						: map_(&map), pos_(map.runs_.size(), 0), cur_(NULL)
+					{
+						if (key == NULL)
+							mem_ = map.memtable_.begin();
+						else
+						{
+							mem_ = map.memtable_.lower_bound(*key);
+							for (size_type i = 0; i < pos_.size(); ++i)
+								pos_[i] = map.lower_bound_(map.runs_[i].records, *key);
+						}
+						settle_();
+					}
+
+					/* the record of the smallest key, from the newest source */
+					const record* smallest_() const
+					{
+						const record* best = NULL;
+
+						if (mem_ != map_->memtable_.end())
+							best = &mem_->second;
+						for (size_type i = pos_.size(); i-- > 0; )
+						{
+							const records_type& records = map_->runs_[i].records;
+							if (pos_[i] == records.size())
+								continue;
+							const record* r = &records[pos_[i]];
+							if (best == NULL || map_->comp_(r->value.first, best->value.first))
+								best = r;
+						}
+						return best;
+					}
+
+					/* moves every source past key */
+					void skip_(const key_type& key)
+					{
+						if (mem_ != map_->memtable_.end() && !map_->comp_(key, mem_->first))
+							++mem_;
+						for (size_type i = 0; i < pos_.size(); ++i)
+						{
+							const records_type& records = map_->runs_[i].records;
+							if (pos_[i] != records.size()
+								&& !map_->comp_(key, records[pos_[i]].value.first))
+								++pos_[i];
+						}
+					}
+
+					void settle_()
+					{
+						while ((cur_ = smallest_()) != NULL && cur_->erased)
+							skip_(cur_->value.first);
+					}
+			};
+
+			typedef const_iterator										iterator;
+
+			explicit lsm_map(size_type memtable_limit = 4096, const Compare& comp = Compare(),
+								const Allocator& alloc = Allocator())
+				: memtable_(comp, memtable_allocator_type(alloc)),
+				memtable_limit_(memtable_limit > 0 ? memtable_limit : 1),
+				comp_(comp), alloc_(alloc)
+			{}
+
+			template <typename InputIt>
+			lsm_map(InputIt first, InputIt last, size_type memtable_limit = 4096,
+					const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+				: memtable_(comp, memtable_allocator_type(alloc)),
+				memtable_limit_(memtable_limit > 0 ? memtable_limit : 1),
+				comp_(comp), alloc_(alloc)
+			{
+				for (; first != last; ++first)
+					insert_or_assign(first->first, first->second);
+			}
+
+			/* a copy of the runs is a copy of whole vectors, runs_ only
+				ever grows by swapping them */
+			lsm_map(const lsm_map& other)
+				: memtable_(other.memtable_), memtable_limit_(other.memtable_limit_),
+				comp_(other.comp_), alloc_(other.alloc_)
+			{
+				runs_.reserve(other.runs_.size());
+				for (size_type i = 0; i < other.runs_.size(); ++i)
+				{
+					run tmp;
+					tmp.records = other.runs_[i].records;
+					tmp.tier = other.runs_[i].tier;
+					push_run_(tmp);
+				}
+			}
+
+			lsm_map& operator=(const lsm_map& other)
+			{
+				if (this != &other)
+				{
+					lsm_map tmp(other);
+					swap(tmp);
+				}
+				return *this;
+			}
+
+			const_iterator begin() const { return const_iterator(*this, NULL); }
+
+			const_iterator end() const { return const_iterator(); }
+
+			const_iterator lower_bound(const key_type& key) const
+			{
+				return const_iterator(*this, &key);
+			}
+
+			/* a walk over the merge, tombstones hide the runs below */
+			bool empty() const { return begin() == end(); }
+
+			/* writes key, whether it was there or not */
+			void insert_or_assign(const key_type& key, const mapped_type& obj)
+			{
+				write_(key, obj, false);
+			}
+
+			/* a lookup and a write, false if the key was there already */
+			bool insert(const value_type& val)
+			{
+				if (count(val.first))
+					return false;
+				write_(val.first, val.second, false);
+				return true;
+			}
+
+			template <typename InputIt>
+			void insert(InputIt first, InputIt last)
+			{
+				for (; first != last; ++first)
+					insert(*first);
+			}
+
+			/* writes a tombstone, whether the key was there or not */
+			void erase(const key_type& key)
+			{
+				write_(key, mapped_type(), true);
+			}
+
+			void clear()
+			{
+				memtable_.clear();
+				runs_.clear();
+			}
+
+			void swap(lsm_map& other)
+			{
+				memtable_.swap(other.memtable_);
+				runs_.swap(other.runs_);
+				ft::swap(memtable_limit_, other.memtable_limit_);
+				ft::swap(comp_, other.comp_);
+				ft::swap(alloc_, other.alloc_);
+			}
+
+			size_type count(const key_type& key) const
+			{
+				return lookup_(key) != NULL;
+			}
+
+			/* copies the mapped value to obj if the key is there */
+			bool find(const key_type& key, mapped_type& obj) const
+			{
+				const record* r = lookup_(key);
+
+				if (r == NULL)
+					return false;
+				obj = r->value.second;
+				return true;
+			}
+
+			const mapped_type& at(const key_type& key) const
+			{
+				const record* r = lookup_(key);
+
+				if (r == NULL)
+					throw std::out_of_range("ft::lsm_map");
+				return r->value.second;
+			}
+
+			/* writes the memtable out as a run */
+			void flush()
+			{
+				if (memtable_.empty())
+					return;
+
+				run fresh;
+				fresh.records.reserve(memtable_.size());
+				for (typename memtable_type::const_iterator it = memtable_.begin();
+						it != memtable_.end(); ++it)
+					fresh.records.push_back(it->second);
+				memtable_.clear();
+				fresh.tier = tier_of_(fresh.records.size());
+				push_run_(fresh);
+				merge_tiers_();
+			}
+
+			/* flushes and merges all runs into one, without tombstones */
+			void compact()
+			{
+				flush();
+				if (runs_.size() > 1 || (runs_.size() == 1 && has_tombstones_(runs_[0])))
+					merge_(0);
+			}
+
+			/* the runs below the memtable, tier_fanout - 1 per tier at most */
+			size_type run_count() const { return runs_.size(); }
+
+			size_type memtable_limit() const { return memtable_limit_; }
+
+			key_compare key_comp() const { return comp_; }
+
+			allocator_type get_allocator() const { return alloc_; }
+
+		private:
+			void write_(const key_type& key, const mapped_type& obj, bool erased)
+			{
+				typename memtable_type::iterator it = memtable_.find(key);
+
+				if (it != memtable_.end())
+				{
+					it->second.value.second = obj;
+					it->second.erased = erased;
+				}
+				else
+				{
+					/* a tombstone with nothing below it has nothing to hide */
+					if (erased && runs_.empty())
+						return;
+					memtable_.insert(ft::make_pair(key, record(value_type(key, obj), erased)));
+				}
+				if (memtable_.size() >= memtable_limit_)
+					flush();
+			}
+
+			/* the newest record of key, NULL if there is none or it is a
+				tombstone */
+			const record* lookup_(const key_type& key) const
+			{
+				typename memtable_type::const_iterator it = memtable_.find(key);
+
+				if (it != memtable_.end())
+					return it->second.erased ? NULL : &it->second;
+				for (size_type i = runs_.size(); i-- > 0; )
+				{
+					const records_type& records = runs_[i].records;
+					/* the first and last keys fence off most runs */
+					if (comp_(key, records.front().value.first)
+						|| comp_(records.back().value.first, key))
+						continue;
+					const size_type pos = lower_bound_(records, key);
+					if (!comp_(key, records[pos].value.first))
+						return records[pos].erased ? NULL : &records[pos];
+				}
+				return NULL;
+			}
+
+			size_type lower_bound_(const records_type& records, const key_type& key) const
+			{
+				size_type first = 0;
+				size_type count = records.size();
+
+				while (count > 0)
+				{
+					const size_type half = count / 2;
+					if (comp_(records[first + half].value.first, key))
+					{
+						first += half + 1;
+						count -= half + 1;
+					}
+					else
+						count = half;
+				}
+				return first;
+			}
+
+			/* appends by swapping, growing runs_ swaps the runs over too
+				instead of copying their records */
+			void push_run_(run& r)
+			{
+				if (runs_.size() == runs_.capacity())
+				{
+					runs_type bigger;
+					bigger.reserve(runs_.capacity() * 2 + tier_fanout);
+					for (size_type i = 0; i < runs_.size(); ++i)
+					{
+						bigger.push_back(run());
+						bigger.back().swap(runs_[i]);
+					}
+					runs_.swap(bigger);
+				}
+				runs_.push_back(run());
+				runs_.back().swap(r);
+			}
+
+			size_type tier_of_(size_type records) const
+			{
+				size_type tier = 0;
+
+				for (records /= memtable_limit_; records >= tier_fanout; records /= tier_fanout)
+					++tier;
+				return tier;
+			}
+
+			/* a merge may land in the tier it came from, when it dropped
+				enough overwritten records */
+			void merge_tiers_()
+			{
+				while (runs_.size() >= tier_fanout)
+				{
+					const size_type first = runs_.size() - tier_fanout;
+					if (runs_[first].tier != runs_.back().tier)
+						return;
+					merge_(first);
+				}
+			}
+
+			static bool has_tombstones_(const run& r)
+			{
+				for (size_type i = 0; i < r.records.size(); ++i)
+					if (r.records[i].erased)
+						return true;
+				return false;
+			}
+
+			/* replaces the runs from first on with their merge. nothing is
+				older than a merge from the first run, its tombstones go */
+			void merge_(size_type first)
+			{
+				const bool		drop = (first == 0);
+				const size_type	last = runs_.size();
+				size_type		total = 0;
+
+				for (size_type i = first; i < last; ++i)
+					total += runs_[i].records.size();
+
+				ft::vector<size_type>	pos(last - first, 0);
+				run						merged;
+				merged.records.reserve(total);
+				for (;;)
+				{
+					/* the smallest key, newest run first on a tie */
+					size_type best = last;
+					for (size_type i = last; i-- > first; )
+					{
+						if (pos[i - first] == runs_[i].records.size())
+							continue;
+						if (best == last || comp_(runs_[i].records[pos[i - first]].value.first,
+													runs_[best].records[pos[best - first]].value.first))
+							best = i;
+					}
+					if (best == last)
+						break;
+
+					const record& r = runs_[best].records[pos[best - first]];
+					if (!(drop && r.erased))
+						merged.records.push_back(r);
+					for (size_type i = first; i < last; ++i)
+					{
+						const records_type& records = runs_[i].records;
+						if (pos[i - first] != records.size()
+							&& !comp_(r.value.first, records[pos[i - first]].value.first))
+							++pos[i - first];
+					}
+				}
+
+				while (runs_.size() > first)
+					runs_.pop_back();
+				merged.tier = tier_of_(merged.records.size());
+				if (!merged.records.empty())
+					push_run_(merged);
+			}
+	};
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	void swap(lsm_map<Key, T, Compare, Alloc>& lhs, lsm_map<Key, T, Compare, Alloc>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+
+} // namespace ft
+
+#endif // LSM_MAP_HPP
@@ -3,15 +3,26 @@
 
 #include <utility> // std::pair
 #include <functional> // std::less
+#include <memory> // std::allocator
+#include <stdexcept> // std::out_of_range, std::length_error
 #include <map>
 
 
 #include "utility.hpp"
+#include "algorithm.hpp"
+#include "red_black_tree.hpp"
+#include "bloom_filter.hpp"
 
 namespace ft {
 
+/* Balance is not part of std::map, it picks the balancing scheme of the
+    tree: ft::rb_balance (default), ft::avl_balance or ft::wb_balance.
+    neither is Filter, which find and count ask before the tree:
+    ft::no_filter (default) or an ft::bloom_filter<Key> for maps where
+    most lookups miss (see bloom_filter.hpp) */
 template <typename Key, typename T, typename Compare = std::less<Key>,
-            typename Allocator = std::allocator<ft::pair<const Key, T>>>
+            typename Allocator = std::allocator<ft::pair<const Key, T> >,
+            typename Balance = ft::rb_balance, typename Filter = ft::no_filter>
 class map
 {
     public:
@@ -27,25 +38,22 @@ class map
         typedef typename allocator_type::size_type          size_type;
         typedef typename allocator_type::difference_type    difference_type;
 
-    private:
-        typedef ft::rb_tree<value_type, value_compare, allocator_type>  tree_type;
-
-    public:
-        typedef typename tree_type::iterator                iterator;
-        typedef typename tree_type::const_iterator          const_iterator;
-        typedef typename tree_type::reverse_iterator        reverse_iterator;
-        typedef typename tree_type::const_reverse_iterator  const_reverse_iterator;
-
 
-        /* typedefs are inherited by the binary_function struct */
-        class value_compare: public std::binary_function<value_type, value_type, bool>
+        /* typedefs are inherited by the binary_function struct in the
+            original, spelled out here because it is deprecated since C++11 */
+        class value_compare
         {
             friend class map;
 
+            public:
+                typedef value_type      first_argument_type;
+                typedef value_type      second_argument_type;
+                typedef bool            result_type;
+
             protected:
                 key_compare     compare_;
 
-                value_compare(key_ompare c) : compare_(c)
+                value_compare(key_compare c) : compare_(c)
                 {}
 
 
@@ -55,30 +63,97 @@ class map
                 {
                     return compare_(lhs.first, rhs.first);
                 }
-        }
 
-        
+                /* used by the tree to look up a key without building a pair */
+                bool operator()(const value_type& lhs, const key_type& rhs) const
+                {
+                    return compare_(lhs.first, rhs);
+                }
+
+                bool operator()(const key_type& lhs, const value_type& rhs) const
+                {
+                    return compare_(lhs, rhs.first);
+                }
+
+                /* set when the key_compare asks for the prefix node layout
+                    (see prefix_less), the tree then caches prefix(key) */
+                typedef typename prefix_policy_of<key_compare>::type     prefix_policy;
+
+                typename prefix_policy::type prefix(const value_type& val) const
+                {
+                    return prefix_policy::make(val.first);
+                }
+
+                typename prefix_policy::type prefix(const key_type& key) const
+                {
+                    return prefix_policy::make(key);
+                }
+
+                /* found by the tree through argument dependent lookup, passes
+                    the keys on so std::less<std::string> compares only once */
+                friend int compare_3way(const value_compare& c, const value_type& lhs,
+                                        const value_type& rhs)
+                {
+                    return ft::compare_3way(c.compare_, lhs.first, rhs.first);
+                }
+
+                friend int compare_3way(const value_compare& c, const value_type& lhs,
+                                        const key_type& rhs)
+                {
+                    return ft::compare_3way(c.compare_, lhs.first, rhs);
+                }
+
+                friend int compare_3way(const value_compare& c, const key_type& lhs,
+                                        const value_type& rhs)
+                {
+                    return ft::compare_3way(c.compare_, lhs, rhs.first);
+                }
+        };
+
+    private:
+        typedef ft::rb_tree<value_type, value_compare, allocator_type, Balance>     tree_type;
+
+    public:
+        typedef typename tree_type::iterator                iterator;
+        typedef typename tree_type::const_iterator          const_iterator;
+        typedef typename tree_type::reverse_iterator        reverse_iterator;
+        typedef typename tree_type::const_reverse_iterator  const_reverse_iterator;
 
-        explicit map(const Compare& comp, Allocator& alloc = Allocator())
+
+    private:
+        tree_type       tree_;
+        /* holds every key of the map, and maybe some erased ones */
+        [[no_unique_address]] Filter    filter_;
+
+    public:
+
+        explicit map(const Compare& comp = Compare(), const Allocator& alloc = Allocator())
             : tree_(value_compare(comp), alloc)
         {}
 
         template <typename InputIt>
         map(InputIt first, InputIt last, const Compare& comp = Compare(),
-            const Allocator& alloc = Allocator());
-        {}
+            const Allocator& alloc = Allocator())
+            : tree_(value_compare(comp), alloc)
+        {
+            insert(first, last);
+        }
 
-        map(const map& other);
-            : tree_(other.tree_)
+        map(const map& other)
+            : tree_(other.tree_), filter_(other.filter_)
         {}
 
-        ~map();
+        ~map()
+        {}
 
 
         map& operator=(const map& other)
         {
             if (this != &other)
+            {
                 tree_ = other.tree_;
+                filter_ = other.filter_;
+            }
             return *this;
         }
 
@@ -88,7 +163,7 @@ class map
         const_iterator begin() const { return tree_.begin(); }
 
         iterator end() { return tree_.end(); }
-        
+
         const_iterator end() const { return tree_.end(); }
 
         reverse_iterator rbegin() { return reverse_iterator(end()); }
@@ -97,7 +172,7 @@ class map
 
         reverse_iterator rend() { return reverse_iterator(begin()); }
 
-        const_reverse_iterator rend() { return const_reverse_iterator(begin()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
 
         bool empty() const { return !tree_.size(); }
 
@@ -105,34 +180,128 @@ class map
 
         size_type max_size() const { return tree_.max_size(); }
 
+        /* not part of std::map. number of elements the map can hold
+            without allocating another node */
+        size_type capacity() const { return tree_.capacity(); }
+
+        /* allocates the nodes for n elements as one block, later inserts
+            take their nodes from it. the block lives as long as the map */
+        void reserve(size_type n)
+        {
+            if (n > max_size())
+                throw std::length_error("ft::map");
+            tree_.reserve(n);
+        }
+
+        /* not part of std::map. moves all nodes into one block in key
+            order, for maps whose nodes got scattered by a long history of
+            inserts and erases. with rebalance the tree is rebuilt with the
+            smallest possible depth. invalidates all iterators */
+        void compact(bool rebalance = false)
+        {
+            tree_.compact(rebalance);
+        }
+
         mapped_type& operator[](const key_type& key)
-        {}
+        {
+            iterator it = lower_bound(key);
+
+            if (it == end() || key_comp()(key, it->first))
+            {
+                it = tree_.insert_unique(it, value_type(key, mapped_type()));
+                filter_insert_(key);
+            }
+            return it->second;
+        }
+
+        mapped_type& at(const key_type& key)
+        {
+            iterator it = find(key);
+
+            if (it == end())
+                throw std::out_of_range("ft::map");
+            return it->second;
+        }
 
-        mapped_type& at(const key_type& key);
+        const mapped_type& at(const key_type& key) const
+        {
+            const_iterator it = find(key);
 
-        const mapped_type& at(const key_type& key) const;
+            if (it == end())
+                throw std::out_of_range("ft::map");
+            return it->second;
+        }
 
-        ft::pair<iterator, bool> insert(const value_type& val);
+        ft::pair<iterator, bool> insert(const value_type& val)
+        {
+            ft::pair<iterator, bool> res = tree_.insert_unique(val);
 
-        iterator insert(iterator position, const value_type& val);
+            if (res.second)
+                filter_insert_(val.first);
+            return res;
+        }
 
+        iterator insert(iterator position, const value_type& val)
+        {
+            const size_type old_size = size();
+            iterator        it = tree_.insert_unique(position, val);
+
+            if (size() != old_size)
+                filter_insert_(val.first);
+            return it;
+        }
+
+        /* a filter sees every key, one by one into a map that has
+            elements, rebuilt after a bulk insert into an empty one */
         template <typename InputIt>
-        void insert(InputIt first, InputIt last);
+        void insert(InputIt first, InputIt last)
+        {
+            if (!Filter::enabled || empty())
+            {
+                tree_.insert_range_unique(first, last);
+                if (Filter::enabled)
+                    rebuild_filter_();
+            }
+            else
+                for (; first != last; ++first)
+                    insert(end(), *first);
+        }
 
-        iterator erase(iterator position);
+        iterator erase(iterator position)
+        {
+            iterator next = tree_.erase(position);
 
-        iterator erase(iterator first, iterator last);
+            filter_erased_(1);
+            return next;
+        }
 
-        size_type erase(const Key& key);
+        iterator erase(iterator first, iterator last)
+        {
+            const size_type old_size = size();
+            iterator        next = tree_.erase_range(first, last);
+
+            filter_erased_(old_size - size());
+            return next;
+        }
+
+        size_type erase(const Key& key)
+        {
+            const size_type n = tree_.erase_unique(key);
+
+            if (n != 0)
+                filter_erased_(n);
+            return n;
+        }
 
         void clear()
         {
             tree_.clear();
+            filter_.reset(0);
         }
 
         key_compare key_comp() const
         {
-            return key_compare();
+            return tree_.value_comp().compare_;
         }
 
         value_compare value_comp() const
@@ -142,69 +311,245 @@ class map
 
         iterator find(const Key& key)
         {
+            if (!filter_.may_contain(key))
+                return end();
             return tree_.find(key);
         }
 
         const_iterator find(const Key& key) const
         {
+            if (!filter_.may_contain(key))
+                return end();
             return tree_.find(key);
         }
 
-        size_type count(const Key& key) const { return tree_.count(key); }
+        size_type count(const Key& key) const
+        {
+            if (!filter_.may_contain(key))
+                return 0;
+            return tree_.count(key);
+        }
+
+        iterator lower_bound(const Key& key)
+        {
+            return tree_.lower_bound(key);
+        }
+
+        const_iterator lower_bound(const Key& key) const
+        {
+            return tree_.lower_bound(key);
+        }
+
+        iterator upper_bound(const Key& key)
+        {
+            return tree_.upper_bound(key);
+        }
+
+        const_iterator upper_bound(const Key& key) const
+        {
+            return tree_.upper_bound(key);
+        }
 
-        iterator lower_bound(const Key& key);
+        /* not part of std::map. lookups that start from hint and only
+            climb as far up as needed, cheap when key is close to hint.
+            with a hint far away they cost about as much as find */
+        iterator find_near(const_iterator hint, const Key& key)
+        {
+            return tree_.find_near(hint, key);
+        }
+
+        const_iterator find_near(const_iterator hint, const Key& key) const
+        {
+            return tree_.find_near(hint, key);
+        }
+
+        iterator lower_bound_near(const_iterator hint, const Key& key)
+        {
+            return tree_.lower_bound_near(hint, key);
+        }
+
+        const_iterator lower_bound_near(const_iterator hint, const Key& key) const
+        {
+            return tree_.lower_bound_near(hint, key);
+        }
+
+        /* not part of std::map. looks up every key of [first, last) and
+            writes one iterator per key to out (end() for a missing key).
+            the descents of several keys are interleaved so their cache
+            misses overlap, which pays off for large maps and many keys */
+        template <typename ForwardIt, typename OutputIt>
+        OutputIt find_batch(ForwardIt first, ForwardIt last, OutputIt out)
+        {
+            return tree_.find_batch(first, last, out);
+        }
+
+        template <typename ForwardIt, typename OutputIt>
+        OutputIt find_batch(ForwardIt first, ForwardIt last, OutputIt out) const
+        {
+            return tree_.find_batch(first, last, out);
+        }
+
+        template <typename ForwardIt, typename OutputIt>
+        OutputIt lower_bound_batch(ForwardIt first, ForwardIt last, OutputIt out)
+        {
+            return tree_.lower_bound_batch(first, last, out);
+        }
 
-        const_iterator lower_bound(const Key& key) const;
+        template <typename ForwardIt, typename OutputIt>
+        OutputIt lower_bound_batch(ForwardIt first, ForwardIt last, OutputIt out) const
+        {
+            return tree_.lower_bound_batch(first, last, out);
+        }
 
-        iterator upper_bound(const Key& key);
+        template <typename ForwardIt, typename OutputIt>
+        OutputIt upper_bound_batch(ForwardIt first, ForwardIt last, OutputIt out)
+        {
+            return tree_.upper_bound_batch(first, last, out);
+        }
 
-        const_iterator upper_bound(const Key& key) const;
+        template <typename ForwardIt, typename OutputIt>
+        OutputIt upper_bound_batch(ForwardIt first, ForwardIt last, OutputIt out) const
+        {
+            return tree_.upper_bound_batch(first, last, out);
+        }
 
-        ft::pair<iterator, iterator> equal_range(const Key& key);
+        ft::pair<iterator, iterator> equal_range(const Key& key)
+        {
+            return tree_.equal_range(key);
+        }
 
-        ft::pair<const_iterator, const_iterator> equal_range(const Key& key);
+        ft::pair<const_iterator, const_iterator> equal_range(const Key& key) const
+        {
+            return tree_.equal_range(key);
+        }
 
         void swap(map& other)
         {
             tree_.swap(other.tree_);
+            filter_.swap(other.filter_);
         }
 
         allocator_type get_allocator() const
         { return tree_.get_allocator(); }
+
+        /* not part of std::map */
+        const Filter& filter() const { return filter_; }
+
+
+        template <typename K, typename U, typename C, typename A, typename B, typename F,
+                    typename Predicate>
+        friend typename map<K, U, C, A, B, F>::size_type
+        erase_if(map<K, U, C, A, B, F>& m, Predicate pred);
+
+    private:
+        void filter_insert_(const key_type& key)
+        {
+            bool inserted;
+
+            try {
+                inserted = filter_.insert(key);
+            } catch (...) {
+                filter_.fill();
+                throw;
+            }
+            if (!inserted)
+                rebuild_filter_();
+        }
+
+        void filter_erased_(size_type n)
+        {
+            if (!filter_.erased(n, size()))
+                rebuild_filter_();
+        }
+
+        /* the key is in the tree already when the filter learns of it.
+            should that throw the filter says "maybe" until the next
+            rebuild */
+        void rebuild_filter_()
+        {
+            try {
+                filter_.reset(size());
+                for (const_iterator it = begin(); it != end(); ++it)
+                    filter_.insert(it->first);
+            } catch (...) {
+                filter_.fill();
+                throw;
+            }
+        }
 };
 
-template <typename Key, typename T, typename Compare, typename Alloc>
-bool operator==(const map<Key, T, Compare, Alloc>& lhs,
-                const map<Key, T, Compare, Alloc>& rhs);
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance,
+            typename Filter>
+bool operator==(const map<Key, T, Compare, Alloc, Balance, Filter>& lhs,
+                const map<Key, T, Compare, Alloc, Balance, Filter>& rhs)
+{
+    return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
 
-template <typename Key, typename T, typename Compare, typename Alloc>
-bool operator!=(const map<Key, T, Compare, Alloc>& lhs,
-                const map<Key, T, Compare, Alloc>& rhs);
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance,
+            typename Filter>
+bool operator!=(const map<Key, T, Compare, Alloc, Balance, Filter>& lhs,
+                const map<Key, T, Compare, Alloc, Balance, Filter>& rhs)
+{
+    return !(lhs == rhs);
+}
 
-template <typename Key, typename T, typename Compare, typename Alloc>
-bool operator<(const map<Key, T, Compare, Alloc>& lhs,
-               const map<Key, T, Compare, Alloc>& rhs);
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance,
+            typename Filter>
+bool operator<(const map<Key, T, Compare, Alloc, Balance, Filter>& lhs,
+               const map<Key, T, Compare, Alloc, Balance, Filter>& rhs)
+{
+    return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
 
-template <typename Key, typename T, typename Compare, typename Alloc>
-bool operator<=(const map<Key, T, Compare, Alloc>& lhs,
-                const map<Key, T, Compare, Alloc>& rhs);
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance,
+            typename Filter>
+bool operator<=(const map<Key, T, Compare, Alloc, Balance, Filter>& lhs,
+                const map<Key, T, Compare, Alloc, Balance, Filter>& rhs)
+{
+    return !(rhs < lhs);
+}
 
-template <typename Key, typename T, typename Compare, typename Alloc>
-bool operator>(const map<Key, T, Compare, Alloc>& lhs,
-                const map<Key, T, Compare, Alloc>& rhs);
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance,
+            typename Filter>
+bool operator>(const map<Key, T, Compare, Alloc, Balance, Filter>& lhs,
+                const map<Key, T, Compare, Alloc, Balance, Filter>& rhs)
+{
+    return rhs < lhs;
+}
 
-template <typename Key, typename T, typename Compare, typename Alloc>
-bool operator>=(const map<Key, T, Compare, Alloc>& lhs,
-                const map<Key, T, Compare, Alloc>& rhs);
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance,
+            typename Filter>
+bool operator>=(const map<Key, T, Compare, Alloc, Balance, Filter>& lhs,
+                const map<Key, T, Compare, Alloc, Balance, Filter>& rhs)
+{
+    return !(lhs < rhs);
+}
 
-template <typename Key, typename T, typename Compare, typename Alloc>
-void swap(ft::map<Key, T, Compare, Alloc>& lhs,
-            ft::map<Key, T, Compare, Alloc>&rhs)
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance,
+            typename Filter>
+void swap(ft::map<Key, T, Compare, Alloc, Balance, Filter>& lhs,
+            ft::map<Key, T, Compare, Alloc, Balance, Filter>&rhs)
 {
     lhs.swap(rhs);
 }
 
+/* C++20 erase_if. pred is called once per element with a value_type&.
+    removing a large share of the map rebuilds the tree in one pass
+    instead of erasing (and rebalancing) element by element */
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance,
+            typename Filter, typename Predicate>
+typename map<Key, T, Compare, Alloc, Balance, Filter>::size_type
+erase_if(map<Key, T, Compare, Alloc, Balance, Filter>& m, Predicate pred)
+{
+    const typename map<Key, T, Compare, Alloc, Balance, Filter>::size_type n
+        = m.tree_.erase_if(pred);
+
+    m.filter_erased_(n);
+    return n;
+}
+
 
 } // namespace ft
 
-#endif // MAP_HPP
\ No newline at end of file
+#endif // MAP_HPP
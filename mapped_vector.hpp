@@ -0,0 +1,193 @@
+#ifndef MAPPED_VECTOR_HPP
+# define MAPPED_VECTOR_HPP
+
+#include <cstddef>		// size_t, ptrdiff_t
+#include <limits>
+#include <new>			// placement new, std::bad_alloc
+#include <stdexcept>	// std::length_error
+#include <sys/mman.h>	// mmap, mprotect, munmap
+#include <unistd.h>		// sysconf
+
+#include "vector.hpp"
+
+/*
+    A vector that never moves its elements to grow. The first allocation
+    reserves the address range for the largest the vector may become with
+    mmap(PROT_NONE), which costs address space and nothing else. Growing
+    makes the next pages of that range readable and writable (mprotect),
+    the block stays where it is:
+
+        ft::mapped_vector<record>   v(ft::max_elements(100000000));
+        record* first = &v[0];
+        ... push_back a few million more ...
+        // first still points to v[0], nothing was copied
+
+    So growing never copies, pointers, references and iterators stay valid
+    while the vector grows (not through insert or erase, which shift the
+    elements like everywhere else), and there is no copy of the old block
+    next to the new one while growing. Capacity still doubles, but pages
+    that were committed and never written take no memory: what is
+    resident is what holds elements.
+
+    The maximum is given in elements to the constructor (max_elements),
+    the reservation is that many elements rounded up to the page and
+    max_size() is exactly what fits. Beyond it push_back & co throw
+    std::length_error like a full ft::vector. Without a maximum the
+    reservation is default_reservation bytes, address space only
+    (MAP_NORESERVE), 64-bit processes have plenty of it.
+
+    It is a basic_vector (vector.hpp) with the interface and iterators of
+    ft::vector, swap exchanges the reservations. Linux and other POSIX
+    systems only.
+*/
+
+namespace ft {
+
+	/* a block is a whole reservation. the committed part is derived from
+		the capacity, rounded up to the page, so the storage only needs
+		to know the size of a reservation */
+	template <typename T>
+	struct mapped_storage
+	{
+		typedef size_t								size_type;
+		typedef ptrdiff_t							difference_type;
+		typedef T&									reference;
+		typedef const T&							const_reference;
+		typedef T*									pointer;
+		typedef const T*							const_pointer;
+		typedef ft::false_type						has_inline;
+
+		size_type		reserved_;
+
+		explicit mapped_storage(size_type max_elements)
+			: reserved_(0)
+		{
+			if (max_elements > static_cast<size_type>(std::numeric_limits<difference_type>::max()) / sizeof(T))
+				throw std::length_error("ft::mapped_vector");
+			reserved_ = round_to_page(max_elements * sizeof(T));
+		}
+
+		static size_type page_size()
+		{
+			static const size_type page = static_cast<size_type>(sysconf(_SC_PAGESIZE));
+
+			return page;
+		}
+
+		static size_type round_to_page(size_type bytes)
+		{
+			return (bytes + page_size() - 1) & ~(page_size() - 1);
+		}
+
+		pointer initial() const { return NULL; }
+
+		size_type initial_capacity() const { return 0; }
+
+		/* reserves the whole range, commits n */
+		pointer allocate(size_type n)
+		{
+			void* range = mmap(NULL, reserved_, PROT_NONE,
+								MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+			if (range == MAP_FAILED)
+				throw std::bad_alloc();
+			if (commit_(range, 0, n) == 0)
+			{
+				munmap(range, reserved_);
+				throw std::bad_alloc();
+			}
+			return static_cast<pointer>(range);
+		}
+
+		void deallocate(pointer p, size_type) { munmap(p, reserved_); }
+
+		size_type extend(pointer p, size_type cap, size_type n)
+		{
+			if (p == NULL)
+				return 0;
+
+			const size_type extended = commit_(p, cap, n);
+			if (extended == 0)
+				throw std::bad_alloc();
+			return extended;
+		}
+
+		bool is_inline(const_pointer) const { return false; }
+
+		void construct(pointer p, const_reference val) { ::new (static_cast<void*>(p)) T(val); }
+
+		void destroy(pointer p) { p->~T(); }
+
+		size_type max_size() const { return reserved_ / sizeof(T); }
+
+		void overflow() const { throw std::length_error("ft::mapped_vector"); }
+
+		void swap(mapped_storage& other) { ft::swap(reserved_, other.reserved_); }
+
+		/* the pages between cap and n elements become writable. the
+			capacity that makes, the whole last page, or 0 */
+		size_type commit_(void* range, size_type cap, size_type n) const
+		{
+			const size_type	from = round_to_page(cap * sizeof(T));
+			const size_type	to = ft::min(round_to_page(n * sizeof(T)), reserved_);
+
+			if (to > from && mprotect(static_cast<char*>(range) + from, to - from,
+										PROT_READ | PROT_WRITE) != 0)
+				return 0;
+			return to / sizeof(T);
+		}
+	};
+
+
+	/* the most elements a mapped_vector may hold, the last argument of
+		its constructors:
+			ft::mapped_vector<int>	v(ft::max_elements(1000000)); */
+	struct max_elements
+	{
+		size_t		n;
+
+		explicit max_elements(size_t count) : n(count)
+		{}
+	};
+
+
+	template <typename T>
+	class mapped_vector : public basic_vector<T, mapped_storage<T> >
+	{
+		private:
+			typedef basic_vector<T, mapped_storage<T> >			base_type;
+			typedef typename base_type::storage_type			storage_type;
+
+		public:
+			typedef typename base_type::value_type				value_type;
+			typedef typename base_type::size_type				size_type;
+
+			/* 64 GiB of address space */
+			static const size_type		default_reservation = size_type(1) << 36;
+
+			explicit mapped_vector(max_elements max = max_elements(default_reservation / sizeof(T)))
+				: base_type(storage_type(max.n))
+			{}
+
+			explicit mapped_vector(size_type n, const value_type &val = value_type(),
+									max_elements max = max_elements(default_reservation / sizeof(T)))
+				: base_type(n, val, storage_type(max.n))
+			{}
+
+			template <typename InputIterator>
+			mapped_vector(InputIterator first, InputIterator last,
+					max_elements max = max_elements(default_reservation / sizeof(T)),
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = 0)
+				: base_type(first, last, storage_type(max.n))
+			{}
+	};
+
+	template <typename T>
+	void swap(mapped_vector<T>& lhs, mapped_vector<T>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+
+} // namespace ft
+
+#endif // MAPPED_VECTOR_HPP
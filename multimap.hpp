@@ -0,0 +1,354 @@
+#ifndef MULTIMAP_HPP
+# define MULTIMAP_HPP
+
+#include <functional> // std::less
+#include <memory> // std::allocator
+#include <stdexcept> // std::length_error
+
+
+#include "utility.hpp"
+#include "algorithm.hpp"
+#include "red_black_tree.hpp"
+
+namespace ft {
+
+/* the map for keys that may repeat, on the same tree. elements with an
+    equivalent key sit side by side in insertion order, equal_range hands
+    out all of them after a single descent.
+    Balance picks the balancing scheme of the tree like for ft::map */
+template <typename Key, typename T, typename Compare = std::less<Key>,
+            typename Allocator = std::allocator<ft::pair<const Key, T> >,
+            typename Balance = ft::rb_balance>
+class multimap
+{
+    public:
+        typedef Key                                         key_type;
+        typedef T                                           mapped_type;
+        typedef ft::pair<const Key, T>                      value_type;
+        typedef Compare                                     key_compare;
+        typedef Allocator                                   allocator_type;
+        typedef typename allocator_type::reference          reference;
+        typedef typename allocator_type::const_reference    const_reference;
+        typedef typename allocator_type::pointer            pointer;
+        typedef typename allocator_type::const_pointer      const_pointer;
+        typedef typename allocator_type::size_type          size_type;
+        typedef typename allocator_type::difference_type    difference_type;
+
+
+        /* the same as map::value_compare */
+        class value_compare
+        {
+            friend class multimap;
+
+            public:
+                typedef value_type      first_argument_type;
+                typedef value_type      second_argument_type;
+                typedef bool            result_type;
+
+            protected:
+                key_compare     compare_;
+
+                value_compare(key_compare c) : compare_(c)
+                {}
+
+
+            public:
+
+                bool operator()(const value_type& lhs, const value_type& rhs) const
+                {
+                    return compare_(lhs.first, rhs.first);
+                }
+
+                bool operator()(const value_type& lhs, const key_type& rhs) const
+                {
+                    return compare_(lhs.first, rhs);
+                }
+
+                bool operator()(const key_type& lhs, const value_type& rhs) const
+                {
+                    return compare_(lhs, rhs.first);
+                }
+
+                typedef typename prefix_policy_of<key_compare>::type     prefix_policy;
+
+                typename prefix_policy::type prefix(const value_type& val) const
+                {
+                    return prefix_policy::make(val.first);
+                }
+
+                typename prefix_policy::type prefix(const key_type& key) const
+                {
+                    return prefix_policy::make(key);
+                }
+
+                friend int compare_3way(const value_compare& c, const value_type& lhs,
+                                        const value_type& rhs)
+                {
+                    return ft::compare_3way(c.compare_, lhs.first, rhs.first);
+                }
+
+                friend int compare_3way(const value_compare& c, const value_type& lhs,
+                                        const key_type& rhs)
+                {
+                    return ft::compare_3way(c.compare_, lhs.first, rhs);
+                }
+
+                friend int compare_3way(const value_compare& c, const key_type& lhs,
+                                        const value_type& rhs)
+                {
+                    return ft::compare_3way(c.compare_, lhs, rhs.first);
+                }
+        };
+
+    private:
+        typedef ft::rb_tree<value_type, value_compare, allocator_type, Balance>     tree_type;
+
+    public:
+        typedef typename tree_type::iterator                iterator;
+        typedef typename tree_type::const_iterator          const_iterator;
+        typedef typename tree_type::reverse_iterator        reverse_iterator;
+        typedef typename tree_type::const_reverse_iterator  const_reverse_iterator;
+
+
+    private:
+        tree_type       tree_;
+
+    public:
+
+        explicit multimap(const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+            : tree_(value_compare(comp), alloc)
+        {}
+
+        template <typename InputIt>
+        multimap(InputIt first, InputIt last, const Compare& comp = Compare(),
+                    const Allocator& alloc = Allocator())
+            : tree_(value_compare(comp), alloc)
+        {
+            insert(first, last);
+        }
+
+        multimap(const multimap& other)
+            : tree_(other.tree_)
+        {}
+
+        ~multimap()
+        {}
+
+
+        multimap& operator=(const multimap& other)
+        {
+            if (this != &other)
+                tree_ = other.tree_;
+            return *this;
+        }
+
+
+        iterator begin() { return tree_.begin(); }
+
+        const_iterator begin() const { return tree_.begin(); }
+
+        iterator end() { return tree_.end(); }
+
+        const_iterator end() const { return tree_.end(); }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        bool empty() const { return !tree_.size(); }
+
+        size_type size() const { return tree_.size(); }
+
+        size_type max_size() const { return tree_.max_size(); }
+
+        /* not part of std::multimap, see map::capacity and map::reserve */
+        size_type capacity() const { return tree_.capacity(); }
+
+        void reserve(size_type n)
+        {
+            if (n > max_size())
+                throw std::length_error("ft::multimap");
+            tree_.reserve(n);
+        }
+
+        void compact(bool rebalance = false)
+        {
+            tree_.compact(rebalance);
+        }
+
+        /* always inserts, after the elements with an equivalent key */
+        iterator insert(const value_type& val)
+        {
+            return tree_.insert_equal(val);
+        }
+
+        /* as close before position as the order allows */
+        iterator insert(iterator position, const value_type& val)
+        {
+            return tree_.insert_equal(position, val);
+        }
+
+        template <typename InputIt>
+        void insert(InputIt first, InputIt last)
+        {
+            tree_.insert_range_equal(first, last);
+        }
+
+        iterator erase(iterator position)
+        {
+            return tree_.erase(position);
+        }
+
+        iterator erase(iterator first, iterator last)
+        {
+            return tree_.erase_range(first, last);
+        }
+
+        /* every element with an equivalent key */
+        size_type erase(const Key& key)
+        {
+            return tree_.erase_equal(key);
+        }
+
+        void clear()
+        {
+            tree_.clear();
+        }
+
+        key_compare key_comp() const
+        {
+            return tree_.value_comp().compare_;
+        }
+
+        value_compare value_comp() const
+        {
+            return tree_.value_comp();
+        }
+
+        /* some element with an equivalent key, not necessarily the first */
+        iterator find(const Key& key)
+        {
+            return tree_.find(key);
+        }
+
+        const_iterator find(const Key& key) const
+        {
+            return tree_.find(key);
+        }
+
+        size_type count(const Key& key) const
+        {
+            return tree_.count_equal(key);
+        }
+
+        iterator lower_bound(const Key& key)
+        {
+            return tree_.lower_bound(key);
+        }
+
+        const_iterator lower_bound(const Key& key) const
+        {
+            return tree_.lower_bound(key);
+        }
+
+        iterator upper_bound(const Key& key)
+        {
+            return tree_.upper_bound(key);
+        }
+
+        const_iterator upper_bound(const Key& key) const
+        {
+            return tree_.upper_bound(key);
+        }
+
+        ft::pair<iterator, iterator> equal_range(const Key& key)
+        {
+            return tree_.equal_range(key);
+        }
+
+        ft::pair<const_iterator, const_iterator> equal_range(const Key& key) const
+        {
+            return tree_.equal_range(key);
+        }
+
+        void swap(multimap& other)
+        {
+            tree_.swap(other.tree_);
+        }
+
+        allocator_type get_allocator() const
+        { return tree_.get_allocator(); }
+
+
+        template <typename K, typename U, typename C, typename A, typename B,
+                    typename Predicate>
+        friend typename multimap<K, U, C, A, B>::size_type
+        erase_if(multimap<K, U, C, A, B>& m, Predicate pred);
+};
+
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance>
+bool operator==(const multimap<Key, T, Compare, Alloc, Balance>& lhs,
+                const multimap<Key, T, Compare, Alloc, Balance>& rhs)
+{
+    return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance>
+bool operator!=(const multimap<Key, T, Compare, Alloc, Balance>& lhs,
+                const multimap<Key, T, Compare, Alloc, Balance>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance>
+bool operator<(const multimap<Key, T, Compare, Alloc, Balance>& lhs,
+               const multimap<Key, T, Compare, Alloc, Balance>& rhs)
+{
+    return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance>
+bool operator<=(const multimap<Key, T, Compare, Alloc, Balance>& lhs,
+                const multimap<Key, T, Compare, Alloc, Balance>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance>
+bool operator>(const multimap<Key, T, Compare, Alloc, Balance>& lhs,
+                const multimap<Key, T, Compare, Alloc, Balance>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance>
+bool operator>=(const multimap<Key, T, Compare, Alloc, Balance>& lhs,
+                const multimap<Key, T, Compare, Alloc, Balance>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance>
+void swap(ft::multimap<Key, T, Compare, Alloc, Balance>& lhs,
+            ft::multimap<Key, T, Compare, Alloc, Balance>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+/* C++20 erase_if, see the one of ft::map */
+template <typename Key, typename T, typename Compare, typename Alloc, typename Balance,
+            typename Predicate>
+typename multimap<Key, T, Compare, Alloc, Balance>::size_type
+erase_if(multimap<Key, T, Compare, Alloc, Balance>& m, Predicate pred)
+{
+    return m.tree_.erase_if(pred);
+}
+
+
+} // namespace ft
+
+#endif // MULTIMAP_HPP
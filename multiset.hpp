@@ -0,0 +1,279 @@
+#ifndef MULTISET_HPP
+# define MULTISET_HPP
+
+#include <functional> // std::less
+#include <memory> // std::allocator
+#include <stdexcept> // std::length_error
+
+
+#include "utility.hpp"
+#include "algorithm.hpp"
+#include "red_black_tree.hpp"
+
+namespace ft {
+
+/* the set for keys that may repeat, see multimap. the elements are the
+    keys, so both iterators are const */
+template <typename Key, typename Compare = std::less<Key>,
+            typename Allocator = std::allocator<Key>, typename Balance = ft::rb_balance>
+class multiset
+{
+    public:
+        typedef Key                                         key_type;
+        typedef Key                                         value_type;
+        typedef Compare                                     key_compare;
+        typedef Compare                                     value_compare;
+        typedef Allocator                                   allocator_type;
+        typedef typename allocator_type::reference          reference;
+        typedef typename allocator_type::const_reference    const_reference;
+        typedef typename allocator_type::pointer            pointer;
+        typedef typename allocator_type::const_pointer      const_pointer;
+        typedef typename allocator_type::size_type          size_type;
+        typedef typename allocator_type::difference_type    difference_type;
+
+    private:
+        /* key_compare plus what the tree asks of a comparator, the
+            prefix of a key for a prefix_less (see map::value_compare) */
+        struct tree_compare
+        {
+            key_compare     compare_;
+
+            tree_compare(const key_compare& c) : compare_(c)
+            {}
+
+            bool operator()(const key_type& lhs, const key_type& rhs) const
+            {
+                return compare_(lhs, rhs);
+            }
+
+            typedef typename prefix_policy_of<key_compare>::type     prefix_policy;
+
+            typename prefix_policy::type prefix(const key_type& key) const
+            {
+                return prefix_policy::make(key);
+            }
+
+            friend int compare_3way(const tree_compare& c, const key_type& lhs,
+                                    const key_type& rhs)
+            {
+                return ft::compare_3way(c.compare_, lhs, rhs);
+            }
+        };
+
+        typedef ft::rb_tree<value_type, tree_compare, allocator_type, Balance>     tree_type;
+
+    public:
+        typedef typename tree_type::const_iterator          iterator;
+        typedef typename tree_type::const_iterator          const_iterator;
+        typedef typename tree_type::const_reverse_iterator  reverse_iterator;
+        typedef typename tree_type::const_reverse_iterator  const_reverse_iterator;
+
+
+    private:
+        tree_type       tree_;
+
+    public:
+
+        explicit multiset(const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+            : tree_(tree_compare(comp), alloc)
+        {}
+
+        template <typename InputIt>
+        multiset(InputIt first, InputIt last, const Compare& comp = Compare(),
+                    const Allocator& alloc = Allocator())
+            : tree_(tree_compare(comp), alloc)
+        {
+            insert(first, last);
+        }
+
+        multiset(const multiset& other)
+            : tree_(other.tree_)
+        {}
+
+        ~multiset()
+        {}
+
+
+        multiset& operator=(const multiset& other)
+        {
+            if (this != &other)
+                tree_ = other.tree_;
+            return *this;
+        }
+
+
+        iterator begin() const { return tree_.begin(); }
+
+        iterator end() const { return tree_.end(); }
+
+        reverse_iterator rbegin() const { return reverse_iterator(end()); }
+
+        reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+        bool empty() const { return !tree_.size(); }
+
+        size_type size() const { return tree_.size(); }
+
+        size_type max_size() const { return tree_.max_size(); }
+
+        /* not part of std::multiset, see map::capacity and map::reserve */
+        size_type capacity() const { return tree_.capacity(); }
+
+        void reserve(size_type n)
+        {
+            if (n > max_size())
+                throw std::length_error("ft::multiset");
+            tree_.reserve(n);
+        }
+
+        void compact(bool rebalance = false)
+        {
+            tree_.compact(rebalance);
+        }
+
+        iterator insert(const value_type& val)
+        {
+            return tree_.insert_equal(val);
+        }
+
+        iterator insert(iterator position, const value_type& val)
+        {
+            return tree_.insert_equal(position, val);
+        }
+
+        template <typename InputIt>
+        void insert(InputIt first, InputIt last)
+        {
+            tree_.insert_range_equal(first, last);
+        }
+
+        iterator erase(iterator position)
+        {
+            return tree_.erase(position);
+        }
+
+        iterator erase(iterator first, iterator last)
+        {
+            return tree_.erase_range(first, last);
+        }
+
+        size_type erase(const Key& key)
+        {
+            return tree_.erase_equal(key);
+        }
+
+        void clear()
+        {
+            tree_.clear();
+        }
+
+        key_compare key_comp() const
+        {
+            return tree_.value_comp().compare_;
+        }
+
+        value_compare value_comp() const
+        {
+            return tree_.value_comp().compare_;
+        }
+
+        iterator find(const Key& key) const
+        {
+            return tree_.find(key);
+        }
+
+        size_type count(const Key& key) const
+        {
+            return tree_.count_equal(key);
+        }
+
+        iterator lower_bound(const Key& key) const
+        {
+            return tree_.lower_bound(key);
+        }
+
+        iterator upper_bound(const Key& key) const
+        {
+            return tree_.upper_bound(key);
+        }
+
+        ft::pair<iterator, iterator> equal_range(const Key& key) const
+        {
+            return tree_.equal_range(key);
+        }
+
+        void swap(multiset& other)
+        {
+            tree_.swap(other.tree_);
+        }
+
+        allocator_type get_allocator() const
+        { return tree_.get_allocator(); }
+
+
+        template <typename K, typename C, typename A, typename B, typename Predicate>
+        friend typename multiset<K, C, A, B>::size_type
+        erase_if(multiset<K, C, A, B>& s, Predicate pred);
+};
+
+template <typename Key, typename Compare, typename Alloc, typename Balance>
+bool operator==(const multiset<Key, Compare, Alloc, Balance>& lhs,
+                const multiset<Key, Compare, Alloc, Balance>& rhs)
+{
+    return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename Key, typename Compare, typename Alloc, typename Balance>
+bool operator!=(const multiset<Key, Compare, Alloc, Balance>& lhs,
+                const multiset<Key, Compare, Alloc, Balance>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename Key, typename Compare, typename Alloc, typename Balance>
+bool operator<(const multiset<Key, Compare, Alloc, Balance>& lhs,
+               const multiset<Key, Compare, Alloc, Balance>& rhs)
+{
+    return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Key, typename Compare, typename Alloc, typename Balance>
+bool operator<=(const multiset<Key, Compare, Alloc, Balance>& lhs,
+                const multiset<Key, Compare, Alloc, Balance>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <typename Key, typename Compare, typename Alloc, typename Balance>
+bool operator>(const multiset<Key, Compare, Alloc, Balance>& lhs,
+                const multiset<Key, Compare, Alloc, Balance>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <typename Key, typename Compare, typename Alloc, typename Balance>
+bool operator>=(const multiset<Key, Compare, Alloc, Balance>& lhs,
+                const multiset<Key, Compare, Alloc, Balance>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+template <typename Key, typename Compare, typename Alloc, typename Balance>
+void swap(ft::multiset<Key, Compare, Alloc, Balance>& lhs,
+            ft::multiset<Key, Compare, Alloc, Balance>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+/* C++20 erase_if, see the one of ft::map */
+template <typename Key, typename Compare, typename Alloc, typename Balance, typename Predicate>
+typename multiset<Key, Compare, Alloc, Balance>::size_type
+erase_if(multiset<Key, Compare, Alloc, Balance>& s, Predicate pred)
+{
+    return s.tree_.erase_if(pred);
+}
+
+
+} // namespace ft
+
+#endif // MULTISET_HPP
@@ -0,0 +1,927 @@
+#ifndef PERSISTENT_MAP_HPP
+# define PERSISTENT_MAP_HPP
+
+#include <functional>	// std::less
+#include <memory>		// std::allocator
+#include <stdexcept>	// std::out_of_range
+#include <atomic>		// node reference counts
+#include <new>			// placement new
+
+#include "iterator.hpp"
+#include "algorithm.hpp"
+#include "utility.hpp"
+#include "red_black_tree.hpp"	// NODE_COLOR
+
+/*
+    A red-black tree whose nodes are never modified once an update is done.
+    An update copies the nodes on the path from the root down to the key
+    (and the few neighbours the rebalancing recolors), everything else is
+    shared with the previous version. Nodes count their owners, a node is
+    freed with its last owner.
+
+    Copying a persistent_map, or snapshot(), only takes a reference on the
+    root: O(1), and the copy keeps seeing the contents of that moment while
+    the original goes on changing. A snapshot can be read and destroyed on
+    another thread without any lock, the reference counts are atomic and no
+    update touches a node another version can see. Two threads must not use
+    the same persistent_map object at once, give each one its own copy.
+
+    The updates are the functional red-black algorithms (Okasaki's insert,
+    Kahrs' delete), with the nodes as links instead of parent pointers.
+    Without parent pointers an iterator carries the path from the root.
+    Values are read-only through iterators, insert_or_assign() changes a
+    mapped value. If copying a value throws, an update has no effect.
+
+    The path an iterator carries is made of raw pointers, it owns none of
+    its nodes. An update that changes the map (insert, insert_or_assign,
+    erase, clear, assignment) lets go of the old path, whose nodes are
+    freed unless another copy still shares them: every iterator into the
+    map is invalid after such an update, like the iterators of a
+    std::vector after a reallocation. To keep iterating a version while
+    the map changes, iterate a snapshot() of it, its iterators stay valid
+    as long as the snapshot lives.
+*/
+
+namespace ft {
+
+	template <typename T>
+	struct persistent_node
+	{
+		typedef persistent_node<T>*		pointer;
+
+		T						val;
+		std::atomic<size_t>		refs;
+		/* the update that created the node, only that update changes it */
+		unsigned long long		stamp;
+		pointer					left;
+		pointer					right;
+		NODE_COLOR				color;
+	};
+
+	/* unique over all maps, a node stamped by another map's update must
+		look foreign even if the two maps share it */
+	inline unsigned long long persistent_stamp()
+	{
+		static std::atomic<unsigned long long>	last(0);
+
+		return ++last;
+	}
+
+
+	template <typename Key, typename T, typename Compare, typename Allocator>
+	class persistent_map;
+
+	template <typename Value>
+	class persistent_map_iterator
+	{
+		public:
+			typedef bidirectional_iterator_tag			iterator_category;
+			typedef Value								value_type;
+			typedef const Value&						reference;
+			typedef const Value*						pointer;
+			typedef ptrdiff_t							difference_type;
+			typedef const persistent_node<Value>*		node_pointer;
+
+			/* a red-black tree is at most twice as deep as a perfectly
+				balanced one, that bounds the path for any size_t size */
+			static const size_t		max_height = 2 * 8 * sizeof(size_t);
+
+		private:
+			node_pointer	root_;
+			/* root down to the current node, empty for end() */
+			node_pointer	path_[max_height];
+			size_t			depth_;
+
+			template <typename K, typename U, typename C, typename A>
+			friend class persistent_map;
+
+		public:
+			persistent_map_iterator() : root_(NULL), depth_(0)
+			{}
+
+			explicit persistent_map_iterator(node_pointer root) : root_(root), depth_(0)
+			{}
+
+			/* only the used part of the path is copied */
+			persistent_map_iterator(const persistent_map_iterator& other)
+				: root_(other.root_), depth_(other.depth_)
+			{
+				for (size_t i = 0; i < depth_; ++i)
+					path_[i] = other.path_[i];
+			}
+
+			persistent_map_iterator& operator=(const persistent_map_iterator& other)
+			{
+				root_ = other.root_;
+				depth_ = other.depth_;
+				for (size_t i = 0; i < depth_; ++i)
+					path_[i] = other.path_[i];
+				return *this;
+			}
+
+			/* the current node, NULL for end() */
+			node_pointer base() const { return (depth_ != 0) ? path_[depth_ - 1] : NULL; }
+
+			/* the root of the version the iterator walks */
+			node_pointer root() const { return root_; }
+
+			reference operator*() const { return base()->val; }
+
+			pointer operator->() const { return &base()->val; }
+
+			persistent_map_iterator& operator++()
+			{
+				node_pointer node = base();
+
+				if (node->right != NULL)
+				{
+					push_(node->right);
+					push_leftmost_();
+					return *this;
+				}
+				/* up until coming from a left child */
+				--depth_;
+				while (depth_ != 0 && path_[depth_ - 1]->right == node)
+					node = path_[--depth_];
+				return *this;
+			}
+
+			persistent_map_iterator operator++(int)
+			{
+				persistent_map_iterator tmp = *this;
+				++(*this);
+				return tmp;
+			}
+
+			persistent_map_iterator& operator--()
+			{
+				if (depth_ == 0)
+				{
+					push_(root_);
+					push_rightmost_();
+					return *this;
+				}
+
+				node_pointer node = base();
+				if (node->left != NULL)
+				{
+					push_(node->left);
+					push_rightmost_();
+					return *this;
+				}
+				--depth_;
+				while (depth_ != 0 && path_[depth_ - 1]->left == node)
+					node = path_[--depth_];
+				return *this;
+			}
+
+			persistent_map_iterator operator--(int)
+			{
+				persistent_map_iterator tmp = *this;
+				--(*this);
+				return tmp;
+			}
+
+		private:
+			void push_(node_pointer node) { path_[depth_++] = node; }
+
+			void push_leftmost_()
+			{
+				while (base()->left != NULL)
+					push_(base()->left);
+			}
+
+			void push_rightmost_()
+			{
+				while (base()->right != NULL)
+					push_(base()->right);
+			}
+	};
+
+	template <typename Value>
+	bool operator==(const persistent_map_iterator<Value>& lhs,
+					const persistent_map_iterator<Value>& rhs)
+	{
+		return lhs.base() == rhs.base();
+	}
+
+	template <typename Value>
+	bool operator!=(const persistent_map_iterator<Value>& lhs,
+					const persistent_map_iterator<Value>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+
+	template <typename Key, typename T, typename Compare = std::less<Key>,
+				typename Allocator = std::allocator<ft::pair<const Key, T> > >
+	class persistent_map
+	{
+		public:
+			typedef Key													key_type;
+			typedef T													mapped_type;
+			typedef ft::pair<const Key, T>								value_type;
+			typedef Compare												key_compare;
+			typedef Allocator											allocator_type;
+			typedef typename allocator_type::reference					reference;
+			typedef typename allocator_type::const_reference			const_reference;
+			typedef typename allocator_type::pointer					pointer;
+			typedef typename allocator_type::const_pointer				const_pointer;
+			typedef typename allocator_type::size_type					size_type;
+			typedef typename allocator_type::difference_type			difference_type;
+
+			/* shared values can't be modified, both iterators are const */
+			typedef persistent_map_iterator<value_type>					const_iterator;
+			typedef const_iterator										iterator;
+			typedef ft::reverse_iterator<const_iterator>				const_reverse_iterator;
+			typedef const_reverse_iterator								reverse_iterator;
+
+		private:
+			typedef persistent_node<value_type>							node_type;
+			typedef node_type*											node_pointer;
+			typedef typename allocator_type::template
+				rebind<node_type>::other								node_allocator_type;
+
+			/*
+				Owns one reference to a node and gives it back when it goes
+				out of scope, unless take() handed it on. Every reference an
+				update holds is either in a node or in one of these, so an
+				exception leaves no node behind.
+			*/
+			class node_ref
+			{
+				private:
+					persistent_map*		map_;
+					node_pointer		node_;
+
+					node_ref(const node_ref&);
+					node_ref& operator=(const node_ref&);
+
+				public:
+					node_ref(persistent_map* map, node_pointer node) : map_(map), node_(node)
+					{}
+
+					~node_ref() { map_->release_(node_); }
+
+					node_pointer& get() { return node_; }
+
+					node_pointer take()
+					{
+						node_pointer node = node_;
+						node_ = NULL;
+						return node;
+					}
+			};
+
+			node_pointer			root_;
+			size_type				size_;
+			key_compare				comp_;
+			allocator_type			alloc_;
+			node_allocator_type		node_alloc_;
+			/* stamp of the running update */
+			unsigned long long		stamp_;
+
+		public:
+
+			explicit persistent_map(const Compare& comp = Compare(),
+									const Allocator& alloc = Allocator())
+				: root_(NULL), size_(0), comp_(comp), alloc_(alloc), node_alloc_(alloc), stamp_(0)
+			{}
+
+			template <typename InputIt>
+			persistent_map(InputIt first, InputIt last, const Compare& comp = Compare(),
+							const Allocator& alloc = Allocator())
+				: root_(NULL), size_(0), comp_(comp), alloc_(alloc), node_alloc_(alloc), stamp_(0)
+			{
+				try {
+					insert(first, last);
+				} catch (...) {
+					clear();
+					throw;
+				}
+			}
+
+			/* O(1), shares all nodes with other */
+			persistent_map(const persistent_map& other)
+				: root_(retain_(other.root_)), size_(other.size_), comp_(other.comp_),
+				alloc_(other.alloc_), node_alloc_(other.node_alloc_), stamp_(0)
+			{}
+
+			~persistent_map()
+			{
+				release_(root_);
+			}
+
+			persistent_map& operator=(const persistent_map& other)
+			{
+				if (this != &other)
+				{
+					persistent_map tmp(other);
+					swap(tmp);
+				}
+				return *this;
+			}
+
+			/* not part of std::map. an O(1) copy that keeps the current
+				contents no matter what happens to this map later */
+			persistent_map snapshot() const { return *this; }
+
+
+			const_iterator begin() const
+			{
+				const_iterator it(root_);
+
+				if (root_ != NULL)
+				{
+					it.push_(root_);
+					it.push_leftmost_();
+				}
+				return it;
+			}
+
+			const_iterator end() const { return const_iterator(root_); }
+
+			const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+			const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+			bool empty() const { return size_ == 0; }
+
+			size_type size() const { return size_; }
+
+			size_type max_size() const { return node_alloc_.max_size(); }
+
+			const mapped_type& at(const key_type& key) const
+			{
+				const_iterator it = find(key);
+
+				if (it == end())
+					throw std::out_of_range("ft::persistent_map");
+				return it->second;
+			}
+
+			ft::pair<const_iterator, bool> insert(const value_type& val)
+			{
+				const_iterator it = find(val.first);
+
+				if (it != end())
+					return ft::make_pair(it, false);
+
+				node_ref root(this, begin_update_());
+				insert_(root.get(), val);
+				end_update_(root);
+				++size_;
+				return ft::make_pair(find(val.first), true);
+			}
+
+			const_iterator insert(const_iterator, const value_type& val)
+			{
+				return insert(val).first;
+			}
+
+			template <typename InputIt>
+			void insert(InputIt first, InputIt last)
+			{
+				for (; first != last; ++first)
+					insert(*first);
+			}
+
+			/* C++17. there is no operator[], it would hand out a mapped
+				value other versions may share */
+			ft::pair<const_iterator, bool> insert_or_assign(const key_type& key,
+															const mapped_type& obj)
+			{
+				if (find(key) == end())
+					return insert(value_type(key, obj));
+
+				node_ref root(this, begin_update_());
+				assign_(root.get(), key, obj);
+				end_update_(root);
+				return ft::make_pair(find(key), false);
+			}
+
+			size_type erase(const key_type& key)
+			{
+				if (find(key) == end())
+					return 0;
+
+				node_ref root(this, begin_update_());
+				erase_(root.get(), key);
+				end_update_(root);
+				--size_;
+				return 1;
+			}
+
+			void erase(const_iterator position)
+			{
+				erase(position->first);
+			}
+
+			void clear()
+			{
+				release_(root_);
+				root_ = NULL;
+				size_ = 0;
+			}
+
+			void swap(persistent_map& other)
+			{
+				ft::swap(root_, other.root_);
+				ft::swap(size_, other.size_);
+				ft::swap(comp_, other.comp_);
+				ft::swap(alloc_, other.alloc_);
+				ft::swap(node_alloc_, other.node_alloc_);
+			}
+
+			key_compare key_comp() const { return comp_; }
+
+			const_iterator find(const key_type& key) const
+			{
+				const_iterator it(root_);
+
+				for (node_pointer node = root_; node != NULL; )
+				{
+					it.push_(node);
+					const int c = ft::compare_3way(comp_, key, node->val.first);
+					if (c == 0)
+						return it;
+					node = (c < 0) ? node->left : node->right;
+				}
+				return end();
+			}
+
+			size_type count(const key_type& key) const
+			{
+				return (find(key) != end()) ? 1 : 0;
+			}
+
+			/* the path is the one of the descent cut off at the last node
+				where it went left */
+			const_iterator lower_bound(const key_type& key) const
+			{
+				const_iterator	it(root_);
+				size_t			depth = 0;
+
+				for (node_pointer node = root_; node != NULL; )
+				{
+					it.push_(node);
+					if (!comp_(node->val.first, key))
+					{
+						depth = it.depth_;
+						node = node->left;
+					}
+					else
+						node = node->right;
+				}
+				it.depth_ = depth;
+				return it;
+			}
+
+			const_iterator upper_bound(const key_type& key) const
+			{
+				const_iterator	it(root_);
+				size_t			depth = 0;
+
+				for (node_pointer node = root_; node != NULL; )
+				{
+					it.push_(node);
+					if (comp_(key, node->val.first))
+					{
+						depth = it.depth_;
+						node = node->left;
+					}
+					else
+						node = node->right;
+				}
+				it.depth_ = depth;
+				return it;
+			}
+
+			ft::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+			{
+				return ft::make_pair(lower_bound(key), upper_bound(key));
+			}
+
+			allocator_type get_allocator() const { return alloc_; }
+
+
+		private:
+
+			static bool is_red_(const node_type* node) { return node != NULL && node->color == RED; }
+
+			static bool is_black_(const node_type* node)
+			{
+				return node != NULL && node->color == BLACK;
+			}
+
+			static node_pointer retain_(node_pointer node)
+			{
+				if (node != NULL)
+					node->refs.fetch_add(1, std::memory_order_relaxed);
+				return node;
+			}
+
+			/* frees the nodes whose last reference this was, along the right
+				spine in a loop and into the left subtrees recursively */
+			void release_(node_pointer node)
+			{
+				while (node != NULL && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					node_pointer right = node->right;
+
+					release_(node->left);
+					alloc_.destroy(&node->val);
+					node_alloc_.deallocate(node, 1);
+					node = right;
+				}
+			}
+
+			node_pointer create_(const value_type& val)
+			{
+				node_pointer node = node_alloc_.allocate(1);
+
+				try {
+					alloc_.construct(&node->val, val);
+				} catch (...) {
+					node_alloc_.deallocate(node, 1);
+					throw;
+				}
+				::new (static_cast<void*>(&node->refs)) std::atomic<size_t>(1);
+				node->stamp = stamp_;
+				node->left = NULL;
+				node->right = NULL;
+				node->color = RED;
+				return node;
+			}
+
+			/* the path copy: replaces the node at link with a private copy
+				unless the running update made it. other versions still own
+				the original, it is never freed here */
+			void make_new_(node_pointer& link)
+			{
+				if (link->stamp == stamp_)
+					return;
+
+				node_pointer node = create_(link->val);
+				node->color = link->color;
+				node->left = retain_(link->left);
+				node->right = retain_(link->right);
+				release_(link);
+				link = node;
+			}
+
+			static node_pointer detach_(node_pointer& link)
+			{
+				node_pointer node = link;
+				link = NULL;
+				return node;
+			}
+
+			/* the update works on its own reference to the root, root_
+				stays untouched until end_update_ swaps them */
+			node_pointer begin_update_()
+			{
+				stamp_ = persistent_stamp();
+				return retain_(root_);
+			}
+
+			void end_update_(node_ref& root)
+			{
+				if (is_red_(root.get()))
+				{
+					make_new_(root.get());
+					root.get()->color = BLACK;
+				}
+				release_(root_);
+				root_ = root.take();
+			}
+
+			/*
+				Kahrs' balance: a black node with a red child that has a red
+				child becomes a red node with two black children. link holds
+				a node of the running update.
+			*/
+			void balance_(node_pointer& link)
+			{
+				node_pointer t = link;
+
+				if (is_red_(t->left) && is_red_(t->right))
+				{
+					make_new_(t->left);
+					make_new_(t->right);
+					t->left->color = BLACK;
+					t->right->color = BLACK;
+					t->color = RED;
+				}
+				else if (is_red_(t->left) && is_red_(t->left->left))
+				{
+					make_new_(t->left);
+					node_pointer l = t->left;
+					make_new_(l->left);
+					l->left->color = BLACK;
+					t->left = l->right;
+					t->color = BLACK;
+					l->right = t;
+					l->color = RED;
+					link = l;
+				}
+				else if (is_red_(t->left) && is_red_(t->left->right))
+				{
+					make_new_(t->left);
+					node_pointer l = t->left;
+					make_new_(l->right);
+					node_pointer lr = l->right;
+					l->right = lr->left;
+					l->color = BLACK;
+					t->left = lr->right;
+					t->color = BLACK;
+					lr->left = l;
+					lr->right = t;
+					lr->color = RED;
+					link = lr;
+				}
+				else if (is_red_(t->right) && is_red_(t->right->right))
+				{
+					make_new_(t->right);
+					node_pointer r = t->right;
+					make_new_(r->right);
+					r->right->color = BLACK;
+					t->right = r->left;
+					t->color = BLACK;
+					r->left = t;
+					r->color = RED;
+					link = r;
+				}
+				else if (is_red_(t->right) && is_red_(t->right->left))
+				{
+					make_new_(t->right);
+					node_pointer r = t->right;
+					make_new_(r->left);
+					node_pointer rl = r->left;
+					t->right = rl->left;
+					t->color = BLACK;
+					r->left = rl->right;
+					r->color = BLACK;
+					rl->left = t;
+					rl->right = r;
+					rl->color = RED;
+					link = rl;
+				}
+				else
+					t->color = BLACK;
+			}
+
+			static bool has_red_pair_(const node_type* t)
+			{
+				return (is_red_(t->left) && (is_red_(t->left->left) || is_red_(t->left->right)))
+					|| (is_red_(t->right) && (is_red_(t->right->left) || is_red_(t->right->right)));
+			}
+
+			/* the key of val is not in the tree */
+			void insert_(node_pointer& link, const value_type& val)
+			{
+				if (link == NULL)
+				{
+					link = create_(val);
+					return;
+				}
+
+				make_new_(link);
+				node_pointer t = link;
+				if (comp_(val.first, t->val.first))
+					insert_(t->left, val);
+				else
+					insert_(t->right, val);
+				if (t->color == BLACK && has_red_pair_(t))
+					balance_(link);
+			}
+
+			/* key is in the tree */
+			void assign_(node_pointer& link, const key_type& key, const mapped_type& obj)
+			{
+				make_new_(link);
+
+				const int c = ft::compare_3way(comp_, key, link->val.first);
+				if (c < 0)
+					assign_(link->left, key, obj);
+				else if (c > 0)
+					assign_(link->right, key, obj);
+				else
+					link->val.second = obj;
+			}
+
+			/*
+				The left subtree at link lost one black node. Kahrs' balleft:
+					a red root of the subtree turns black,
+					a black sibling turns red and the node gets balanced,
+					a red sibling gives its black left child up as new root
+			*/
+			void balance_left_(node_pointer& link)
+			{
+				node_pointer t = link;
+
+				if (is_red_(t->left))
+				{
+					make_new_(t->left);
+					t->left->color = BLACK;
+					t->color = RED;
+				}
+				else if (is_black_(t->right))
+				{
+					make_new_(t->right);
+					t->right->color = RED;
+					t->color = BLACK;
+					balance_(link);
+				}
+				else
+				{
+					make_new_(t->right);
+					node_pointer r = t->right;
+					make_new_(r->left);
+					make_new_(r->right);
+					node_pointer rl = r->left;
+					r->right->color = RED;
+					t->right = rl->left;
+					t->color = BLACK;
+					r->left = rl->right;
+					r->color = BLACK;
+					rl->left = t;
+					rl->right = r;
+					rl->color = RED;
+					link = rl;
+					balance_(rl->right);
+				}
+			}
+
+			void balance_right_(node_pointer& link)
+			{
+				node_pointer t = link;
+
+				if (is_red_(t->right))
+				{
+					make_new_(t->right);
+					t->right->color = BLACK;
+					t->color = RED;
+				}
+				else if (is_black_(t->left))
+				{
+					make_new_(t->left);
+					t->left->color = RED;
+					t->color = BLACK;
+					balance_(link);
+				}
+				else
+				{
+					make_new_(t->left);
+					node_pointer l = t->left;
+					make_new_(l->right);
+					make_new_(l->left);
+					node_pointer lr = l->right;
+					l->left->color = RED;
+					l->right = lr->left;
+					l->color = BLACK;
+					t->left = lr->right;
+					t->color = BLACK;
+					lr->left = l;
+					lr->right = t;
+					lr->color = RED;
+					link = lr;
+					balance_(lr->left);
+				}
+			}
+
+			/* key is in the tree. the node with the key itself is not
+				copied, it is replaced by the join of its subtrees */
+			void erase_(node_pointer& link, const key_type& key)
+			{
+				const int c = ft::compare_3way(comp_, key, link->val.first);
+
+				if (c == 0)
+				{
+					node_pointer t = link;
+					link = join_(retain_(t->left), retain_(t->right));
+					release_(t);
+					return;
+				}
+
+				make_new_(link);
+				node_pointer t = link;
+				if (c < 0)
+				{
+					const bool black = is_black_(t->left);
+					erase_(t->left, key);
+					if (black)
+						balance_left_(link);
+					else
+						t->color = RED;
+				}
+				else
+				{
+					const bool black = is_black_(t->right);
+					erase_(t->right, key);
+					if (black)
+						balance_right_(link);
+					else
+						t->color = RED;
+				}
+			}
+
+			/* Kahrs' app: joins two trees of the same black height whose
+				keys are all smaller in a than in b. takes a reference on
+				both and returns one on the result */
+			node_pointer join_(node_pointer a_node, node_pointer b_node)
+			{
+				node_ref a(this, a_node);
+				node_ref b(this, b_node);
+
+				if (a.get() == NULL)
+					return b.take();
+				if (b.get() == NULL)
+					return a.take();
+
+				if (a.get()->color == b.get()->color)
+				{
+					make_new_(a.get());
+					make_new_(b.get());
+					node_ref bc(this, join_(detach_(a.get()->right), detach_(b.get()->left)));
+					if (is_red_(bc.get()))
+					{
+						make_new_(bc.get());
+						node_pointer m = bc.get();
+						a.get()->right = m->left;
+						b.get()->left = m->right;
+						m->left = a.take();
+						m->right = b.take();
+						return bc.take();
+					}
+					b.get()->left = bc.take();
+					a.get()->right = b.take();
+					if (a.get()->color == BLACK)
+						balance_left_(a.get());
+					return a.take();
+				}
+				if (is_red_(b.get()))
+				{
+					make_new_(b.get());
+					b.get()->left = join_(a.take(), detach_(b.get()->left));
+					return b.take();
+				}
+				make_new_(a.get());
+				a.get()->right = join_(detach_(a.get()->right), b.take());
+				return a.take();
+			}
+	};
+
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	bool operator==(const persistent_map<Key, T, Compare, Alloc>& lhs,
+					const persistent_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	bool operator!=(const persistent_map<Key, T, Compare, Alloc>& lhs,
+					const persistent_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	bool operator<(const persistent_map<Key, T, Compare, Alloc>& lhs,
+					const persistent_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	bool operator<=(const persistent_map<Key, T, Compare, Alloc>& lhs,
+					const persistent_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return !(rhs < lhs);
+	}
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	bool operator>(const persistent_map<Key, T, Compare, Alloc>& lhs,
+					const persistent_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return rhs < lhs;
+	}
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	bool operator>=(const persistent_map<Key, T, Compare, Alloc>& lhs,
+					const persistent_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return !(lhs < rhs);
+	}
+
+	template <typename Key, typename T, typename Compare, typename Alloc>
+	void swap(persistent_map<Key, T, Compare, Alloc>& lhs,
+				persistent_map<Key, T, Compare, Alloc>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+
+} // namespace ft
+
+#endif // PERSISTENT_MAP_HPP
@@ -1,12 +1,15 @@
-/* 
-    THEORY behind RED-BLACK-TREES 
+#ifndef RED_BLACK_TREE_HPP
+# define RED_BLACK_TREE_HPP
+
+/*
+    THEORY behind RED-BLACK-TREES
 
     Don't know exactly about the structure below the red black tree
     but with introsprection one might be able to figure it out.
 
     How would one go about that.
 
-    - function declarations 
+    - function declarations
         insert has an overload with a function with a type
         std::map::node_type which speaks for a separate node class
 
@@ -14,7 +17,7 @@
         auto &map.at()
 
 
-    
+
 
         As I remember from others working on it there are around 7 cases
         of rotation for insertion/deletion for the entire tree.
@@ -24,35 +27,179 @@
 
         requires a max of 2 rotations for self balancing even when tree is big
 
-    
+
 */
 
+#include <memory>		// std::allocator
+#include <cstddef>		// ptrdiff_t
+#include <functional>	// std::less
+#include <string>		// string_prefix
+#include <cstring>		// std::memcpy
+
 #include "iterator.hpp"
+#include "algorithm.hpp"
+#include "utility.hpp"
+#include "vector.hpp"
+
+/* hint to pull a node into the cache before the descent reaches it */
+#if defined(__GNUC__) || defined(__clang__)
+# define FT_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+# define FT_PREFETCH(addr) ((void)0)
+#endif
 
 namespace ft {
 
     enum NODE_COLOR { BLACK, RED };
 
 
-    /* 
+    /*
+        Key prefixes, an opt-in node layout for string keys.
+        A descent through a map<std::string, ...> follows a pointer into the
+        heap buffer of every key it compares against. With a prefix policy
+        each node also stores the first bytes of its key as an integer that
+        orders like the key itself, most comparisons are settled by that
+        integer and only a tie falls back to the comparator.
+
+        A policy provides the integer type and make(key). no_prefix is the
+        default and stores nothing.
+    */
+    struct no_prefix
+    {
+        typedef char        type;
+
+        template <typename Key>
+        static type make(const Key&) { return 0; }
+    };
+
+    /* the first 8 bytes big-endian, zero padded. std::string compares
+        its characters as unsigned char, so does this integer */
+    struct string_prefix
+    {
+        typedef unsigned long long  type;
+
+        static type make(const std::string& key)
+        {
+            const size_t    len = key.size();
+            type            prefix = 0;
+
+            for (size_t i = 0; i < sizeof(type); ++i)
+                prefix = (prefix << 8) | (i < len ? static_cast<unsigned char>(key[i]) : 0);
+            return prefix;
+        }
+    };
+
+    /* std::less for strings that opts into the prefix layout, use it as
+        the Compare of a map: ft::map<std::string, V, ft::prefix_less> */
+    struct prefix_less : public std::less<std::string>
+    {
+        typedef string_prefix       prefix_policy;
+    };
+
+    inline int compare_3way(const prefix_less&, const std::string& a, const std::string& b)
+    {
+        return three_way_traits<std::string>::compare(a, b);
+    }
+
+    /* the prefix_policy typedef of a comparator, no_prefix without one */
+    template <typename Compare>
+    struct prefix_policy_of
+    {
+        typedef char        yes[1];
+        typedef char        no[2];
+
+        template <typename C>
+        static yes& test(typename C::prefix_policy*);
+
+        template <typename C>
+        static no& test(...);
+
+        template <typename C, bool HasPolicy>
+        struct select { typedef no_prefix type; };
+
+        template <typename C>
+        struct select<C, true> { typedef typename C::prefix_policy type; };
+
+        typedef typename select<Compare, sizeof(test<Compare>(0)) == sizeof(yes)>::type    type;
+    };
+
+    /* empty for no_prefix, the empty base takes no space in the node */
+    template <typename Prefix>
+    struct node_prefix
+    {
+        typename Prefix::type       prefix;
+    };
+
+    template <>
+    struct node_prefix<no_prefix>
+    {};
+
+
+    /*
         It originally is implemented as a base class with with the metadata
         and inherited by a class that adds the value of the node. The base
         class additionally provides function to find the min and max of the tree.
 
+        Same here: the links and the balance data live in the node base of
+        the balancing policy, a Node only adds the value. Everything that
+        only relinks or recolors nodes works on base pointers, so it exists
+        once per balancing policy instead of once per value type (GNU does
+        the same with _Rb_tree_node_base). the red-black core below is not a
+        template at all.
+
+        The links point to the node base itself rather than to a common
+        link struct, the balance data of a child is one dereference away.
     */
-    template <typename T>
-    struct Node
+    template <typename Base>
+    struct tree_links
     {
-        typedef T                   value_type;
-        typedef Node<T>*            pointer;
-        typedef const Node<T>*      const_pointer;
+        Base*       parent;
+        Base*       left;
+        Base*       right;
 
-        Node() : val(), color(NODE_COLOR.RED), parent(NULL),
-            left(NULL), right() 
-        []
+        tree_links() : parent(NULL), left(NULL), right(NULL) {}
+    };
+
+    struct rb_node_base : public tree_links<rb_node_base>
+    {
+        NODE_COLOR      color;
+
+        rb_node_base() : color(RED) {}
+    };
+
+    struct avl_node_base : public tree_links<avl_node_base>
+    {
+        int             height;
 
-        explicit Node(T key, NODE_COLOR color)
-            : val(key), color(color), parent(NULL), left(NULL), right(NULL)
+        avl_node_base() : height(1) {}
+    };
+
+    struct wb_node_base : public tree_links<wb_node_base>
+    {
+        size_t          size;
+
+        wb_node_base() : size(1) {}
+    };
+
+    struct rb_balance;
+
+    /* the balancing policy decides what a node stores next to its links,
+        a color for red-black trees (see rb_balance and its siblings).
+        the node base comes first, a base pointer and the node share
+        their address */
+    template <typename T, typename Prefix = no_prefix, typename Balance = rb_balance>
+    struct Node : public Balance::node_base, public node_prefix<Prefix>
+    {
+        typedef T                                   value_type;
+        typedef Node<T, Prefix, Balance>*           pointer;
+        typedef const Node<T, Prefix, Balance>*     const_pointer;
+        typedef typename Balance::node_base         base_type;
+        typedef base_type*                          base_pointer;
+
+        Node() : val()
+        {}
+
+        explicit Node(const T& key) : val(key)
         {}
 
        /*
@@ -60,8 +207,8 @@ namespace ft {
         Usually a map doesn't hold the same value twice, otherwise we can
         copy a tree and therefore the underlying nodes might be copied too.
         */
-        Node(const Node& src) : val(src.val), color(src.color),
-            parent(src.parent), left(src.left), right(src.right)
+        Node(const Node& src) : Balance::node_base(src), node_prefix<Prefix>(src),
+            val(src.val)
         {}
 
 
@@ -70,10 +217,6 @@ namespace ft {
 
         public:
             value_type              val;
-            NODE_COLOR              color;
-            pointer                 parent;
-            pointer                 left;
-            pointer                 right;
     };
 
 
@@ -122,6 +265,558 @@ namespace ft {
     }
 
 
+    /*
+        The root hangs as the left child of the sentinel (nil_), which makes
+        the root a left child as well. The rotations and rebalancing functions
+        below rely on that, so they never need to special case the root when
+        relinking a parent.
+    */
+    template <typename NodePtr>
+    bool tree_is_left_child(NodePtr node)
+    {
+        return node == node->parent->left;
+    }
+
+    template <typename NodePtr>
+    void tree_rotate_left(NodePtr x)
+    {
+        NodePtr y = x->right;
+
+        x->right = y->left;
+        if (x->right != NULL)
+            x->right->parent = x;
+        y->parent = x->parent;
+        if (tree_is_left_child(x))
+            x->parent->left = y;
+        else
+            x->parent->right = y;
+        y->left = x;
+        x->parent = y;
+    }
+
+    template <typename NodePtr>
+    void tree_rotate_right(NodePtr x)
+    {
+        NodePtr y = x->left;
+
+        x->left = y->right;
+        if (x->left != NULL)
+            x->left->parent = x;
+        y->parent = x->parent;
+        if (tree_is_left_child(x))
+            x->parent->left = y;
+        else
+            x->parent->right = y;
+        y->right = x;
+        x->parent = y;
+    }
+
+    /* x is the freshly linked node, root the current root of the tree.
+        recolors up the tree as long as the uncle is red and ends with
+        at most two rotations */
+    inline void tree_insert_rebalance(rb_node_base* root, rb_node_base* x)
+    {
+        x->color = (x == root) ? BLACK : RED;
+        while (x != root && x->parent->color == RED)
+        {
+            if (tree_is_left_child(x->parent))
+            {
+                rb_node_base* uncle = x->parent->parent->right;
+                if (uncle != NULL && uncle->color == RED)
+                {
+                    x = x->parent;
+                    x->color = BLACK;
+                    x = x->parent;
+                    x->color = (x == root) ? BLACK : RED;
+                    uncle->color = BLACK;
+                }
+                else
+                {
+                    if (!tree_is_left_child(x))
+                    {
+                        x = x->parent;
+                        tree_rotate_left(x);
+                    }
+                    x = x->parent;
+                    x->color = BLACK;
+                    x = x->parent;
+                    x->color = RED;
+                    tree_rotate_right(x);
+                    break;
+                }
+            }
+            else
+            {
+                rb_node_base* uncle = x->parent->parent->left;
+                if (uncle != NULL && uncle->color == RED)
+                {
+                    x = x->parent;
+                    x->color = BLACK;
+                    x = x->parent;
+                    x->color = (x == root) ? BLACK : RED;
+                    uncle->color = BLACK;
+                }
+                else
+                {
+                    if (tree_is_left_child(x))
+                    {
+                        x = x->parent;
+                        tree_rotate_right(x);
+                    }
+                    x = x->parent;
+                    x->color = BLACK;
+                    x = x->parent;
+                    x->color = RED;
+                    tree_rotate_left(x);
+                    break;
+                }
+            }
+        }
+    }
+
+    /* unlinks z from the tree rooted at root and restores the red-black
+        properties. z itself is left untouched apart from its links so the
+        caller can destroy it afterwards. other nodes are relinked instead
+        of having their values swapped, iterators to them stay valid */
+    inline void tree_erase_rebalance(rb_node_base* root, rb_node_base* z)
+    {
+        rb_node_base* y = (z->left == NULL || z->right == NULL) ? z : tree_next(z);
+        rb_node_base* x = (y->left != NULL) ? y->left : y->right;
+        rb_node_base* w = NULL;
+
+        if (x != NULL)
+            x->parent = y->parent;
+        if (tree_is_left_child(y))
+        {
+            y->parent->left = x;
+            if (y != root)
+                w = y->parent->right;
+            else
+                root = x;
+        }
+        else
+        {
+            y->parent->right = x;
+            w = y->parent->left;
+        }
+
+        bool removed_black = (y->color == BLACK);
+        if (y != z)
+        {
+            y->parent = z->parent;
+            if (tree_is_left_child(z))
+                y->parent->left = y;
+            else
+                y->parent->right = y;
+            y->left = z->left;
+            y->left->parent = y;
+            y->right = z->right;
+            if (y->right != NULL)
+                y->right->parent = y;
+            y->color = z->color;
+            if (root == z)
+                root = y;
+        }
+
+        if (!removed_black || root == NULL)
+            return;
+        if (x != NULL)
+        {
+            x->color = BLACK;
+            return;
+        }
+
+        /* x is a NULL leaf that is missing one black node, w its sibling */
+        while (true)
+        {
+            if (!tree_is_left_child(w))
+            {
+                if (w->color == RED)
+                {
+                    w->color = BLACK;
+                    w->parent->color = RED;
+                    tree_rotate_left(w->parent);
+                    if (root == w->left)
+                        root = w;
+                    w = w->left->right;
+                }
+                if ((w->left == NULL || w->left->color == BLACK)
+                    && (w->right == NULL || w->right->color == BLACK))
+                {
+                    w->color = RED;
+                    x = w->parent;
+                    if (x == root || x->color == RED)
+                    {
+                        x->color = BLACK;
+                        break;
+                    }
+                    w = tree_is_left_child(x) ? x->parent->right : x->parent->left;
+                }
+                else
+                {
+                    if (w->right == NULL || w->right->color == BLACK)
+                    {
+                        w->left->color = BLACK;
+                        w->color = RED;
+                        tree_rotate_right(w);
+                        w = w->parent;
+                    }
+                    w->color = w->parent->color;
+                    w->parent->color = BLACK;
+                    w->right->color = BLACK;
+                    tree_rotate_left(w->parent);
+                    break;
+                }
+            }
+            else
+            {
+                if (w->color == RED)
+                {
+                    w->color = BLACK;
+                    w->parent->color = RED;
+                    tree_rotate_right(w->parent);
+                    if (root == w->right)
+                        root = w;
+                    w = w->right->left;
+                }
+                if ((w->left == NULL || w->left->color == BLACK)
+                    && (w->right == NULL || w->right->color == BLACK))
+                {
+                    w->color = RED;
+                    x = w->parent;
+                    if (x == root || x->color == RED)
+                    {
+                        x->color = BLACK;
+                        break;
+                    }
+                    w = tree_is_left_child(x) ? x->parent->right : x->parent->left;
+                }
+                else
+                {
+                    if (w->left == NULL || w->left->color == BLACK)
+                    {
+                        w->right->color = BLACK;
+                        w->color = RED;
+                        tree_rotate_left(w);
+                        w = w->parent;
+                    }
+                    w->color = w->parent->color;
+                    w->parent->color = BLACK;
+                    w->left->color = BLACK;
+                    tree_rotate_right(w->parent);
+                    break;
+                }
+            }
+        }
+    }
+
+    /* links the sorted nodes [first, first + n) into a perfectly balanced
+        subtree and returns its root. depth is the level of the returned
+        root. set(node, size, depth) fills in the balance data of every node
+        once its children are linked */
+    template <typename NodePtr, typename SetBalance>
+    NodePtr tree_build_balanced(NodePtr* first, size_t n, size_t depth, SetBalance set)
+    {
+        if (n == 0)
+            return NULL;
+
+        size_t      mid = n / 2;
+        NodePtr     node = first[mid];
+
+        node->left = tree_build_balanced(first, mid, depth + 1, set);
+        node->right = tree_build_balanced(first + mid + 1, n - mid - 1, depth + 1, set);
+        if (node->left != NULL)
+            node->left->parent = node;
+        if (node->right != NULL)
+            node->right->parent = node;
+        set(node, n, depth);
+        return node;
+    }
+
+    /* unlinks z like in a plain binary search tree. a node with two
+        children is replaced by its successor, which is stored in successor
+        (NULL otherwise) and takes over the links but not the balance data
+        of z. returns the lowest node whose subtree lost a node, the place
+        to start rebalancing from */
+    template <typename NodePtr>
+    NodePtr tree_unlink(NodePtr z, NodePtr& successor)
+    {
+        NodePtr start;
+        NodePtr y;
+
+        if (z->left == NULL || z->right == NULL)
+        {
+            successor = NULL;
+            y = (z->left != NULL) ? z->left : z->right;
+            start = z->parent;
+        }
+        else
+        {
+            successor = y = tree_min(z->right);
+            if (y->parent == z)
+                start = y;
+            else
+            {
+                start = y->parent;
+                start->left = y->right;
+                if (y->right != NULL)
+                    y->right->parent = start;
+                y->right = z->right;
+                y->right->parent = y;
+            }
+            y->left = z->left;
+            y->left->parent = y;
+        }
+        if (y != NULL)
+            y->parent = z->parent;
+        if (tree_is_left_child(z))
+            z->parent->left = y;
+        else
+            z->parent->right = y;
+        return start;
+    }
+
+
+    /*
+        Balancing policies, the last template parameter of rb_tree and map.
+
+        A policy provides the node_base a node inherits its links and its
+        balance data from, init(node) for a fresh leaf, insert_rebalance(root, x) after x
+        got linked, erase_rebalance(root, z) which unlinks z, and
+        build(first, n) which links n sorted nodes into a balanced tree and
+        returns its root. root->parent is always the sentinel.
+
+        rb_balance      red-black, the default. cheap updates, at most
+                        2 log n deep
+        avl_balance     about 1.44 log n deep, lookups visit fewer nodes in
+                        exchange for more rotations on updates
+        wb_balance      weight-balanced, every node knows the size of its
+                        subtree. the base for order statistics and join/split
+    */
+    struct rb_balance
+    {
+        typedef rb_node_base    node_base;
+
+        static void init(node_base* node) { node->color = RED; }
+
+        static void insert_rebalance(node_base* root, node_base* x)
+        {
+            tree_insert_rebalance(root, x);
+        }
+
+        static void erase_rebalance(node_base* root, node_base* z)
+        {
+            tree_erase_rebalance(root, z);
+        }
+
+        /* every level is black except the deepest one when it isn't
+            completely filled, which keeps the black height equal on all
+            paths. red_depth is that level, 0 for none */
+        struct set_color
+        {
+            size_t  red_depth;
+
+            void operator()(node_base* node, size_t, size_t depth) const
+            {
+                node->color = (red_depth != 0 && depth == red_depth) ? RED : BLACK;
+            }
+        };
+
+        template <typename NodePtr>
+        static NodePtr build(NodePtr* first, size_t n)
+        {
+            /* a tree of n nodes split in the middle is full down to
+                level floor(log2(n)), only that level may be partial */
+            size_t last_level = 0;
+            while ((size_t(2) << last_level) <= n)
+                ++last_level;
+
+            set_color set;
+            set.red_depth = ((size_t(2) << last_level) - 1 == n) ? 0 : last_level;
+            return tree_build_balanced(first, n, 0, set);
+        }
+    };
+
+    struct avl_balance
+    {
+        typedef avl_node_base   node_base;
+
+        static int height(const node_base* node) { return node == NULL ? 0 : node->height; }
+
+        static void update(node_base* node)
+        {
+            node->height = 1 + ft::max(height(node->left), height(node->right));
+        }
+
+        /* the subtrees of node differ by at most 2 in height. rotates if
+            needed and returns the root of the subtree */
+        static node_base* fix(node_base* node)
+        {
+            const int diff = height(node->left) - height(node->right);
+
+            if (diff > 1)
+            {
+                node_base* l = node->left;
+                if (height(l->left) < height(l->right))
+                {
+                    tree_rotate_left(l);
+                    update(l);
+                }
+                tree_rotate_right(node);
+            }
+            else if (diff < -1)
+            {
+                node_base* r = node->right;
+                if (height(r->right) < height(r->left))
+                {
+                    tree_rotate_right(r);
+                    update(r);
+                }
+                tree_rotate_left(node);
+            }
+            else
+            {
+                update(node);
+                return node;
+            }
+            update(node);
+            node = node->parent;
+            update(node);
+            return node;
+        }
+
+        /* walks up until a subtree keeps its height, above that
+            nothing changed */
+        static void fix_up(node_base* node, node_base* header)
+        {
+            while (node != header)
+            {
+                const int old = node->height;
+                node = fix(node);
+                if (node->height == old)
+                    break;
+                node = node->parent;
+            }
+        }
+
+        static void init(node_base* node) { node->height = 1; }
+
+        static void insert_rebalance(node_base* root, node_base* x)
+        {
+            fix_up(x->parent, root->parent);
+        }
+
+        static void erase_rebalance(node_base* root, node_base* z)
+        {
+            node_base* header = root->parent;
+            node_base* successor;
+            node_base* start = tree_unlink(z, successor);
+
+            if (successor != NULL)
+                successor->height = z->height;
+            fix_up(start, header);
+        }
+
+        struct set_height
+        {
+            void operator()(node_base* node, size_t, size_t) const { update(node); }
+        };
+
+        template <typename NodePtr>
+        static NodePtr build(NodePtr* first, size_t n)
+        {
+            return tree_build_balanced(first, n, 0, set_height());
+        }
+    };
+
+    /* BB[alpha] with the (delta, gamma) = (3, 2) parameters of Adams' trees,
+        which are proven to hold up under single inserts and erases.
+        weight is the subtree size + 1 */
+    struct wb_balance
+    {
+        typedef wb_node_base    node_base;
+
+        static const size_t delta = 3;
+        static const size_t gamma = 2;
+
+        static size_t weight(const node_base* node) { return (node == NULL ? 0 : node->size) + 1; }
+
+        static void update(node_base* node)
+        {
+            node->size = weight(node->left) + weight(node->right) - 1;
+        }
+
+        static node_base* fix(node_base* node)
+        {
+            if (delta * weight(node->left) < weight(node->right))
+            {
+                node_base* r = node->right;
+                if (weight(r->left) >= gamma * weight(r->right))
+                {
+                    tree_rotate_right(r);
+                    update(r);
+                }
+                tree_rotate_left(node);
+            }
+            else if (delta * weight(node->right) < weight(node->left))
+            {
+                node_base* l = node->left;
+                if (weight(l->right) >= gamma * weight(l->left))
+                {
+                    tree_rotate_left(l);
+                    update(l);
+                }
+                tree_rotate_right(node);
+            }
+            else
+            {
+                update(node);
+                return node;
+            }
+            update(node);
+            node = node->parent;
+            update(node);
+            return node;
+        }
+
+        /* every size up to the root changed, no early exit */
+        static void fix_up(node_base* node, node_base* header)
+        {
+            while (node != header)
+                node = fix(node)->parent;
+        }
+
+        static void init(node_base* node) { node->size = 1; }
+
+        static void insert_rebalance(node_base* root, node_base* x)
+        {
+            fix_up(x->parent, root->parent);
+        }
+
+        static void erase_rebalance(node_base* root, node_base* z)
+        {
+            node_base* header = root->parent;
+            node_base* successor;
+            node_base* start = tree_unlink(z, successor);
+
+            if (successor != NULL)
+                successor->size = z->size;
+            fix_up(start, header);
+        }
+
+        struct set_size
+        {
+            void operator()(node_base* node, size_t n, size_t) const { node->size = n; }
+        };
+
+        template <typename NodePtr>
+        static NodePtr build(NodePtr* first, size_t n)
+        {
+            return tree_build_balanced(first, n, 0, set_size());
+        }
+    };
+
+
 
     /*
         Has a helper class called 'header' to manage default initialization
@@ -130,44 +825,45 @@ namespace ft {
         Thought this might be something like a sentinel node, with default values
     */
 
-    
-    template <typename T>
+
+    template <typename T, typename NodeType = Node<T> >
     class tree_const_iterator;
 
 
-    template <typename T>
+    template <typename T, typename NodeType = Node<T> >
     class tree_iterator
     {
         public:
-            typedef bidirectional_iterator_tag      iterator_category; 
+            typedef bidirectional_iterator_tag      iterator_category;
             typedef T                               value_type;
             typedef T&                              reference;
             typedef T*                              pointer;
             typedef ptrdiff_t                       difference_type;
-            typedef tree_const_iterator             const_iterator;
+            typedef tree_const_iterator<T, NodeType>    const_iterator;
 
 
         private:
-            typedef ft::Node<T>::pointer            node_pointer;
-            typedef ft::Node<T>::const_pointer      const_pointer;
+            typedef typename NodeType::pointer      node_pointer;
+            typedef typename NodeType::base_pointer base_pointer;
 
 
         public:
             tree_iterator() : current_(NULL)
             {}
 
-            tree_iterator(node_pointer node) : current_(node)
+            explicit tree_iterator(node_pointer node) : current_(node)
             {}
 
-            /* 
+            /*
                 I do believe the requirements say that an iterator should be
                 copy constructible, as well as assignable.
             */
 
-            tree_iterator(const tree_iterator& src) : current_(src.current)
+            tree_iterator(const tree_iterator& src) : current_(src.current_)
             {}
 
             ~tree_iterator()
+            {}
 
             tree_iterator& operator=(const tree_iterator& src)
             {
@@ -178,17 +874,17 @@ namespace ft {
 
             node_pointer base() const { return current_; }
 
-            reference operator*() const { return current_.val; }
+            reference operator*() const { return current_->val; }
 
             pointer operator->() const { return &(operator*()); }
 
             tree_iterator& operator++()
             {
-                current_ = tree_next<node_pointer>(current_);
+                current_ = static_cast<node_pointer>(tree_next<base_pointer>(current_));
                 return *this;
             }
 
-            tree_iterator& operator++(int)
+            tree_iterator operator++(int)
             {
                 tree_iterator tmp = *this;
                 ++(*this);
@@ -197,11 +893,11 @@ namespace ft {
 
             tree_iterator& operator--()
             {
-                current_ = tree_prev<node_pointer>(current_);
+                current_ = static_cast<node_pointer>(tree_prev<base_pointer>(current_));
                 return *this;
             }
 
-            tree_iterator& operator--(int)
+            tree_iterator operator--(int)
             {
                 tree_iterator tmp = *this;
                 --(*this);
@@ -210,7 +906,7 @@ namespace ft {
 
 
 
-            /* 
+            /*
                 Do I really need an overload for equality operators?
                 What sense does it make to compare const iterators inside
                 the non-const iterator class?
@@ -230,43 +926,45 @@ namespace ft {
         private:
             node_pointer    current_;
     };
-    
 
-    template <typename T>
+
+    template <typename T, typename NodeType>
     class tree_const_iterator
     {
         public:
-            typedef bidirectional_iterator_tag      iterator_category; 
+            typedef bidirectional_iterator_tag      iterator_category;
             typedef T                               value_type;
-            typedef T&                              reference;
-            typedef T*                              pointer;
+            typedef const T&                        reference;
+            typedef const T*                        pointer;
             typedef ptrdiff_t                       difference_type;
-            typedef tree_iterator                   iterator;
+            typedef tree_iterator<T, NodeType>      iterator;
 
         private:
-            typedef ft::Node<T>::pointer            node_pointer;
-            typedef ft::Node<T>::const_pointer      const_pointer;
+            typedef typename NodeType::const_pointer    const_node_pointer;
+            typedef typename NodeType::pointer          node_pointer;
+            typedef typename NodeType::base_pointer     base_pointer;
 
 
         public:
             tree_const_iterator() : current_(NULL)
             {}
 
-            tree_const_iterator(node_pointer node) : current_(node)
+            explicit tree_const_iterator(const_node_pointer node) : current_(node)
             {}
 
-            /* 
+            /*
                 I do believe the requirements say that an iterator should be
                 copy constructible, as well as assignable.
             */
 
-            tree_const_iterator(const tree_iterator& src) : current_(src.current)
+            tree_const_iterator(const iterator& src) : current_(src.base())
             {}
 
-            tree_const_iterator(const tree_const_iterator& src) : current_(src.current)
+            tree_const_iterator(const tree_const_iterator& src) : current_(src.current_)
             {}
 
-            ~tree_iterator()
+            ~tree_const_iterator()
+            {}
 
             tree_const_iterator& operator=(const tree_const_iterator& src)
             {
@@ -277,17 +975,19 @@ namespace ft {
 
             const_node_pointer base() const { return current_; }
 
-            reference operator*() const { return current_.val; }
+            reference operator*() const { return current_->val; }
 
             pointer operator->() const { return &(operator*()); }
 
             tree_const_iterator& operator++()
             {
-                current_ = tree_next<node_pointer>(current_);
+                /* the same walk as for the iterator, one instantiation */
+                current_ = static_cast<node_pointer>(
+                    tree_next<base_pointer>(const_cast<node_pointer>(current_)));
                 return *this;
             }
 
-            tree_const_iterator& operator++(int)
+            tree_const_iterator operator++(int)
             {
                 tree_const_iterator tmp = *this;
                 ++(*this);
@@ -296,11 +996,12 @@ namespace ft {
 
             tree_const_iterator& operator--()
             {
-                current_ = tree_prev<node_pointer>(current_);
+                current_ = static_cast<node_pointer>(
+                    tree_prev<base_pointer>(const_cast<node_pointer>(current_)));
                 return *this;
             }
 
-            tree_const_iterator& operator--(int)
+            tree_const_iterator operator--(int)
             {
                 tree_const_iterator tmp = *this;
                 --(*this);
@@ -309,7 +1010,7 @@ namespace ft {
 
 
 
-            /* 
+            /*
                 Do I really need an overload for equality operators?
                 What sense does it make to compare const iterators inside
                 the non-const iterator class?
@@ -329,8 +1030,38 @@ namespace ft {
             const_node_pointer    current_;
     };
 
+    /* mixed comparisons, the iterator is converted to a const_iterator */
+    template <typename T, typename N>
+    bool operator==(const tree_iterator<T, N>& lhs, const tree_const_iterator<T, N>& rhs)
+    {
+        return tree_const_iterator<T, N>(lhs) == rhs;
+    }
+
+    template <typename T, typename N>
+    bool operator==(const tree_const_iterator<T, N>& lhs, const tree_iterator<T, N>& rhs)
+    {
+        return lhs == tree_const_iterator<T, N>(rhs);
+    }
+
+    template <typename T, typename N>
+    bool operator!=(const tree_iterator<T, N>& lhs, const tree_const_iterator<T, N>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <typename T, typename N>
+    bool operator!=(const tree_const_iterator<T, N>& lhs, const tree_iterator<T, N>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
 
-    template <typename T, typename Compare, typename Allocator>
+    /*
+        value_compare has to be callable with two value_types. The lookup
+        functions are templates on the key type, so the comparator may also
+        provide overloads taking a key on either side (see map::value_compare)
+    */
+    template <typename T, typename Compare, typename Allocator, typename Balance = rb_balance>
     class rb_tree
     {
         public:
@@ -338,9 +1069,13 @@ namespace ft {
             typedef Compare                                     value_compare;
             typedef Allocator                                   allocator_type;
 
-            typedef typename Node<value_type>                   node_type;
+            typedef typename prefix_policy_of<Compare>::type    prefix_policy;
+            typedef typename prefix_policy::type                prefix_type;
+            typedef Balance                                     balance_policy;
+            typedef Node<value_type, prefix_policy, Balance>    node_type;
             typedef typename node_type::pointer                 node_pointer;
             typedef typename node_type::const_pointer           const_node_pointer;
+            typedef typename node_type::base_pointer            base_pointer;
             typedef typename allocator_type::template \
             rebind<node_type>::other                            node_allocator_type;
             typedef typename allocator_type::pointer            pointer;
@@ -348,8 +1083,8 @@ namespace ft {
             typedef typename allocator_type::size_type          size_type;
             typedef typename allocator_type::difference_type    difference_type;
 
-            typedef ft::tree_iterator                           iterator;
-            typedef ft::tree_const_iterator                     const_iterator;
+            typedef ft::tree_iterator<value_type, node_type>        iterator;
+            typedef ft::tree_const_iterator<value_type, node_type>  const_iterator;
             typedef ft::reverse_iterator<iterator>              reverse_iterator;
             typedef ft::reverse_iterator<const_iterator>        const_reverse_iterator;
 
@@ -364,7 +1099,7 @@ namespace ft {
             */
             allocator_type          value_alloc_;
 
-            /* 
+            /*
                 A data structure needs a way to hold the elements of itself and relate
                 them to one another. This is achieved by wrapping them with another
                 structure in this case the Node class.
@@ -375,7 +1110,7 @@ namespace ft {
 
 
             /* it might be possible to implement the tree without a root/head node
-                but makes it easier. the leftmost node also helps with performance 
+                but makes it easier. the leftmost node also helps with performance
                 and is sugar for some operations */
 
             /*
@@ -384,86 +1119,405 @@ namespace ft {
             size_type               size_;
 
             /*
-                This is the placeholder for any Node that has no value
+                This is the placeholder for any Node that has no value.
+                It doubles as end(), its left child is the root of the tree
+                so that decrementing end() lands on the maximum.
             */
             node_pointer            nil_;
 
 
             node_pointer            leftmost_;
 
-        public:
+            /*
+                Nodes handed out by reserve(). A slab is allocated as one block
+                and only given back to the allocator with the tree, the nodes
+                of all slabs that aren't in use are kept in the free list
+                (linked through their right pointer) and reused first. The
+                slabs are sorted by address, so which one a node belongs to
+                is a binary search.
+            */
+            ft::vector<ft::pair<node_pointer, size_type> >     slabs_;
+            node_pointer            free_list_;
+            size_type               free_count_;
 
-            /* implicit default constructor */
+        public:
 
-            explicit rb_tree(const Compare& comp, const allocator_type& alloc)
-                : value_compare_(comp), value_alloc_(alloc), node_alloc(alloc), size_(0)
-            {}
+            explicit rb_tree(const Compare& comp, const allocator_type& alloc = allocator_type())
+                : value_compare_(comp), value_alloc_(alloc), node_alloc_(alloc),
+                size_(0), nil_(NULL), leftmost_(NULL), free_list_(NULL), free_count_(0)
+            {
+                init_nil_();
+            }
 
             rb_tree(const rb_tree& other)
                 : value_compare_(other.value_compare_), value_alloc_(other.value_alloc_),
-                node_alloc_(other.node_alloc_), size_(other.size_)
-            {}
+                node_alloc_(other.node_alloc_), size_(0), nil_(NULL), leftmost_(NULL),
+                free_list_(NULL), free_count_(0)
+            {
+                init_nil_();
+                try {
+                    copy_from_(other);
+                } catch (...) {
+                    clear();
+                    release_slabs_();
+                    node_alloc_.deallocate(nil_, 1);
+                    throw;
+                }
+            }
 
             ~rb_tree()
-            {}
+            {
+                clear();
+                release_slabs_();
+                node_alloc_.deallocate(nil_, 1);
+            }
 
             rb_tree& operator=(const rb_tree& src)
             {
-
+                if (this != &src)
+                {
+                    rb_tree tmp(src);
+                    swap(tmp);
+                }
+                return *this;
             }
 
 
             iterator begin() { return iterator(leftmost_); }
 
-            const_iterator begin() { return const_iterator(leftmost_); }
+            const_iterator begin() const { return const_iterator(leftmost_); }
 
             iterator end() { return iterator(nil_); }
 
-            const_iterator end() { return const_iterator(nil_); }
-
-            value_compare& value_comp() const { return value_compare_; }
+            const_iterator end() const { return const_iterator(nil_); }
 
             /* original implementation includes the reverse iterators
             inside the rb_tree class and not only in the map */
 
-
-
             const value_compare& value_comp() const { return value_compare_; }
 
             size_type size() const { return size_; }
 
             size_type max_size() const { return node_alloc_.max_size(); }
 
+            /* number of elements the tree can hold before it has to ask
+                the allocator for another node */
+            size_type capacity() const { return size_ + free_count_; }
+
+            /* makes room for n elements with a single allocation, the
+                nodes of the slab are handed out in address order */
+            void reserve(size_type n)
+            {
+                if (n <= capacity())
+                    return;
+
+                /* the room comes first, inserting the slab can't throw */
+                const size_type count = n - capacity();
+                if (slabs_.size() == slabs_.capacity())
+                    slabs_.reserve(slabs_.size() * 2 + 1);
+                node_pointer slab = node_alloc_.allocate(count);
+                slabs_.insert(slabs_.begin() + slab_after_(slab), ft::make_pair(slab, count));
+                for (size_type i = count; i > 0; --i)
+                {
+                    slab[i - 1].right = free_list_;
+                    free_list_ = &slab[i - 1];
+                }
+                free_count_ += count;
+            }
+
+            /*
+                Moves every element into one new slab, in order, so that an
+                in-order walk reads memory front to back. The shape is kept
+                unless rebalance is set, then the tree is rebuilt perfectly
+                balanced. Trivially relocatable values are moved by copying
+                their bytes, the others are copy constructed, should such a
+                copy throw the tree stays as it was. Spare nodes and the old
+                slabs are given back, capacity() == size() afterwards.
+                Invalidates all iterators.
+            */
+            void compact(bool rebalance)
+            {
+                typedef ft::vector<ft::pair<node_pointer, size_type> >  slab_vector;
+
+                ft::vector<node_pointer>    nodes(size_);
+                slab_vector                 fresh;
+                node_pointer                slab = NULL;
+
+                if (size_ != 0)
+                {
+                    fresh.reserve(1);
+                    slab = node_alloc_.allocate(size_);
+                    fresh.push_back(ft::make_pair(slab, size_));
+                }
+
+                typename is_trivially_relocatable<value_type>::type relocatable;
+                size_type i = 0;
+                try {
+                    for (node_pointer node = leftmost_; node != nil_; node = next_(node), ++i)
+                    {
+                        relocate_value_(slab + i, node, relocatable);
+                        nodes[i] = node;
+                    }
+                } catch (...) {
+                    while (i > 0)
+                        value_alloc_.destroy(&slab[--i].val);
+                    if (slab != NULL)
+                        node_alloc_.deallocate(slab, size_);
+                    throw;
+                }
+
+                /* nothing throws from here on. the node base holds the links
+                    as well, the old node remembers its new place in its
+                    parent link once they are copied */
+                for (i = 0; i < size_; ++i)
+                {
+                    node_pointer node = slab + i;
+                    static_cast<typename balance_policy::node_base&>(*node) = *nodes[i];
+                    static_cast<node_prefix<prefix_policy>&>(*node) = *nodes[i];
+                }
+                for (i = 0; i < size_; ++i)
+                {
+                    destroy_value_(nodes[i], relocatable);
+                    nodes[i]->parent = slab + i;
+                }
+                node_pointer root = (size_ != 0) ? node_(root_()->parent) : NULL;
+                if (!rebalance)
+                {
+                    for (i = 0; i < size_; ++i)
+                    {
+                        node_pointer node = slab + i;
+                        node->parent = (node->parent == nil_) ? nil_ : node->parent->parent;
+                        if (node->left != NULL)
+                            node->left = node->left->parent;
+                        if (node->right != NULL)
+                            node->right = node->right->parent;
+                    }
+                }
+
+                /* old nodes are either single allocations or part of a slab */
+                for (i = 0; i < size_; ++i)
+                {
+                    if (!in_slab_(nodes[i]))
+                        node_alloc_.deallocate(nodes[i], 1);
+                    nodes[i] = slab + i;
+                }
+                slabs_.swap(fresh);
+                for (i = 0; i < fresh.size(); ++i)
+                    node_alloc_.deallocate(fresh[i].first, fresh[i].second);
+                free_list_ = NULL;
+                free_count_ = 0;
+
+                if (rebalance)
+                    relink_sorted_(nodes);
+                else
+                {
+                    nil_->left = root;
+                    leftmost_ = (size_ != 0) ? slab : nil_;
+                }
+            }
+
             pair<iterator, bool> insert_unique(const value_type& val)
-            {}
+            {
+                node_pointer    parent;
+                base_pointer&   link = find_link_(parent, val);
+
+                if (link != NULL)
+                    return ft::make_pair(iterator(node_(link)), false);
+                node_pointer node = create_node_(val);
+                insert_node_at_(parent, link, node);
+                return ft::make_pair(iterator(node), true);
+            }
 
-            iterator insert_unique(interator pos, const value_type& val)
-            {}
+            /* the hint is used when val belongs right before it,
+                otherwise this is an ordinary insert */
+            iterator insert_unique(const_iterator pos, const value_type& val)
+            {
+                node_pointer hint = const_cast<node_pointer>(pos.base());
+
+                if (hint == nil_ || value_compare_(val, hint->val))
+                {
+                    node_pointer prev = (hint == leftmost_) ? NULL : prev_(hint);
+                    if (prev == NULL || value_compare_(prev->val, val))
+                    {
+                        node_pointer node = create_node_(val);
+                        if (hint->left == NULL)
+                            insert_node_at_(hint, hint->left, node);
+                        else
+                            insert_node_at_(prev, prev->right, node);
+                        return iterator(node);
+                    }
+                }
+                return insert_unique(val).first;
+            }
 
             template <typename InputIt>
             void insert_range_unique(InputIt first, InputIt last)
             {
                 for (; first != last; ++first)
-                    insert_unique(*first);
+                    insert_unique(end(), *first);
             }
 
-            pair<iterator, iterator> equal_range(const value_type& val)
-            {}
+            /* the multimap/multiset inserts. val goes after the elements
+                with an equivalent key, those keep their insertion order */
+            iterator insert_equal(const value_type& val)
+            {
+                return insert_equal_(val, false);
+            }
 
-            pair<const_iterator, const_iterator> equal_range(const value_type& val) const
-            {}
+            /* val goes right before the hint when the order allows it,
+                otherwise as close to the hint as it does (like std::multimap):
+                before the equivalent keys when the hint is smaller than val,
+                after them when it is bigger */
+            iterator insert_equal(const_iterator pos, const value_type& val)
+            {
+                node_pointer hint = const_cast<node_pointer>(pos.base());
 
-            void erase(const_iterator position)
-            {}
+                if (hint != nil_ && value_compare_(hint->val, val))
+                    return insert_equal_(val, true);
 
-            void erase_range(const_iterator first, const_iterator last)
-            {}
+                node_pointer prev = (hint == leftmost_) ? NULL : prev_(hint);
+                if (prev != NULL && value_compare_(val, prev->val))
+                    return insert_equal_(val, false);
 
-            size_type erase_unique(const value_type& val)
-            {}
+                node_pointer node = create_node_(val);
+                if (hint->left == NULL)
+                    insert_node_at_(hint, hint->left, node);
+                else
+                    insert_node_at_(prev, prev->right, node);
+                return iterator(node);
+            }
+
+            template <typename InputIt>
+            void insert_range_equal(InputIt first, InputIt last)
+            {
+                for (; first != last; ++first)
+                    insert_equal(end(), *first);
+            }
+
+            /* one descent down to the first node with an equivalent key,
+                below it the two bounds only search its left and right
+                subtree */
+            template <typename Key>
+            pair<iterator, iterator> equal_range(const Key& key)
+            {
+                pair<node_pointer, node_pointer> range = equal_range_(key);
+
+                return ft::make_pair(iterator(range.first), iterator(range.second));
+            }
+
+            template <typename Key>
+            pair<const_iterator, const_iterator> equal_range(const Key& key) const
+            {
+                pair<node_pointer, node_pointer> range
+                    = const_cast<rb_tree*>(this)->equal_range_(key);
+
+                return ft::make_pair(const_iterator(range.first), const_iterator(range.second));
+            }
+
+            /* returns the iterator following the erased element */
+            iterator erase(const_iterator position)
+            {
+                node_pointer node = const_cast<node_pointer>(position.base());
+                iterator     next(next_(node));
+
+                if (node == leftmost_)
+                    leftmost_ = next.base();
+                balance_policy::erase_rebalance(root_(), node);
+                destroy_node_(node);
+                --size_;
+                return next;
+            }
+
+            iterator erase_range(const_iterator first, const_iterator last)
+            {
+                if (first == begin() && last == end())
+                {
+                    clear();
+                    return end();
+                }
+                while (first != last)
+                    first = erase(first);
+                return iterator(const_cast<node_pointer>(last.base()));
+            }
+
+            template <typename Key>
+            size_type erase_unique(const Key& key)
+            {
+                iterator it = find(key);
+
+                if (it == end())
+                    return 0;
+                erase(it);
+                return 1;
+            }
+
+            template <typename Key>
+            size_type erase_equal(const Key& key)
+            {
+                pair<iterator, iterator>    range = equal_range(key);
+                const size_type             n = ft::distance(range.first, range.second);
+
+                erase_range(range.first, range.second);
+                return n;
+            }
+
+            /* removes every element for which pred returns true and
+                returns how many were removed. pred is called exactly once
+                per element, in order.
+
+                a handful of matches are erased one by one, every erase is
+                a relink plus a rebalance. once a good part of the tree goes
+                away it is cheaper to collect the survivors in order and link
+                them back into a balanced tree in one linear pass */
+            template <typename Predicate>
+            size_type erase_if(Predicate pred)
+            {
+                ft::vector<node_pointer>    doomed;
+
+                for (node_pointer node = leftmost_; node != nil_; node = next_(node))
+                {
+                    if (pred(node->val))
+                        doomed.push_back(node);
+                }
+
+                const size_type removed = doomed.size();
+                if (removed == 0)
+                    return 0;
+
+                if (removed < size_ / bulk_erase_ratio_)
+                {
+                    for (size_type i = 0; i < removed; ++i)
+                        erase(const_iterator(doomed[i]));
+                    return removed;
+                }
+
+                /* doomed is sorted in tree order, a merge walk is enough
+                    to tell the survivors apart */
+                ft::vector<node_pointer>    survivors;
+                size_type                   d = 0;
+
+                survivors.reserve(size_ - removed);
+                for (node_pointer node = leftmost_; node != nil_; node = next_(node))
+                {
+                    if (d < removed && doomed[d] == node)
+                        ++d;
+                    else
+                        survivors.push_back(node);
+                }
+                for (size_type i = 0; i < removed; ++i)
+                    destroy_node_(doomed[i]);
+                size_ -= removed;
+                relink_sorted_(survivors);
+                return removed;
+            }
 
             void clear()
-            {}
+            {
+                destroy_subtree_(root_());
+                nil_->left = NULL;
+                leftmost_ = nil_;
+                size_ = 0;
+            }
 
             /*
                 the original implementation uses
@@ -475,65 +1529,665 @@ namespace ft {
                    iterator find(const Key& k)
             */
 
-            iterator find(const value_type& val)
-            {}
+            /* stops at the first equal node, a single three-way comparison
+                per level (see compare_3way in algorithm.hpp) */
+            template <typename Key>
+            iterator find(const Key& key)
+            {
+                const prefix_type   kp = key_prefix_(key, prefix_policy());
+                node_pointer        node = root_();
+
+                while (node != NULL)
+                {
+                    const int c = compare_node_(key, kp, node);
+                    if (c < 0)
+                        node = node_(node->left);
+                    else if (c > 0)
+                        node = node_(node->right);
+                    else
+                        return iterator(node);
+                }
+                return end();
+            }
 
-            const_iterator find(const value_type& val) const
-            {}
+            template <typename Key>
+            const_iterator find(const Key& key) const
+            {
+                return const_cast<rb_tree*>(this)->find(key);
+            }
 
-            iterator lower_bound(const value_type& val)
-            {}
+            template <typename Key>
+            iterator lower_bound(const Key& key)
+            {
+                return iterator(lower_bound_(key));
+            }
 
-            const_iterator lower_bound(const value_type& val) const
-            {}
+            template <typename Key>
+            const_iterator lower_bound(const Key& key) const
+            {
+                return const_iterator(const_cast<rb_tree*>(this)->lower_bound_(key));
+            }
 
-            iterator upper_bound(const value_type& val)
-            {}
+            template <typename Key>
+            iterator upper_bound(const Key& key)
+            {
+                return iterator(upper_bound_(key));
+            }
 
-            const_iterator upper_bound(const value_type& val) const
-            {}
+            template <typename Key>
+            const_iterator upper_bound(const Key& key) const
+            {
+                return const_iterator(const_cast<rb_tree*>(this)->upper_bound_(key));
+            }
 
-            size_type count(const value_type& val) const
+            template <typename Key>
+            size_type count(const Key& key) const
             {
-                if (find(val) != end())
+                if (find(key) != end())
                     return 1;
                 else
                     return 0;
             }
 
-            /* finished */
+            /* O(log n + k) for k equivalent keys */
+            template <typename Key>
+            size_type count_equal(const Key& key) const
+            {
+                pair<const_iterator, const_iterator> range = equal_range(key);
+
+                return ft::distance(range.first, range.second);
+            }
+
+            /*
+                Finger search, the descent starts from hint instead of the root.
+                It climbs from hint until the subtree it reached has to contain
+                the answer and searches only that subtree. For a key d elements
+                away from hint the climb usually stops after O(log d) levels.
+                Two neighbours split high up in the tree still climb that far,
+                so the worst case stays O(log n).
+            */
+            template <typename Key>
+            iterator lower_bound_near(const_iterator hint, const Key& key)
+            {
+                return iterator(lower_bound_near_(const_cast<node_pointer>(hint.base()), key));
+            }
+
+            template <typename Key>
+            const_iterator lower_bound_near(const_iterator hint, const Key& key) const
+            {
+                return const_iterator(const_cast<rb_tree*>(this)->lower_bound_near_(
+                    const_cast<node_pointer>(hint.base()), key));
+            }
+
+            template <typename Key>
+            iterator find_near(const_iterator hint, const Key& key)
+            {
+                node_pointer node = lower_bound_near_(const_cast<node_pointer>(hint.base()), key);
+
+                if (node == nil_ || value_compare_(key, node->val))
+                    return end();
+                return iterator(node);
+            }
+
+            template <typename Key>
+            const_iterator find_near(const_iterator hint, const Key& key) const
+            {
+                return const_cast<rb_tree*>(this)->find_near(hint, key);
+            }
+
+            /*
+                Batched lookups for the keys in [first, last), one iterator per
+                key is written to out, in the order of the keys.
+                The descents for several keys run side by side one level at a
+                time, while one lane compares the next node of every other lane
+                is already on its way into the cache. With the tree bigger than
+                the cache the misses of the lanes overlap instead of adding up.
+            */
+            template <typename ForwardIt, typename OutputIt>
+            OutputIt find_batch(ForwardIt first, ForwardIt last, OutputIt out)
+            {
+                return bound_batch_<iterator>(first, last, out, batch_find);
+            }
+
+            template <typename ForwardIt, typename OutputIt>
+            OutputIt find_batch(ForwardIt first, ForwardIt last, OutputIt out) const
+            {
+                return const_cast<rb_tree*>(this)->template
+                    bound_batch_<const_iterator>(first, last, out, batch_find);
+            }
+
+            template <typename ForwardIt, typename OutputIt>
+            OutputIt lower_bound_batch(ForwardIt first, ForwardIt last, OutputIt out)
+            {
+                return bound_batch_<iterator>(first, last, out, batch_lower);
+            }
+
+            template <typename ForwardIt, typename OutputIt>
+            OutputIt lower_bound_batch(ForwardIt first, ForwardIt last, OutputIt out) const
+            {
+                return const_cast<rb_tree*>(this)->template
+                    bound_batch_<const_iterator>(first, last, out, batch_lower);
+            }
+
+            template <typename ForwardIt, typename OutputIt>
+            OutputIt upper_bound_batch(ForwardIt first, ForwardIt last, OutputIt out)
+            {
+                return bound_batch_<iterator>(first, last, out, batch_upper);
+            }
+
+            template <typename ForwardIt, typename OutputIt>
+            OutputIt upper_bound_batch(ForwardIt first, ForwardIt last, OutputIt out) const
+            {
+                return const_cast<rb_tree*>(this)->template
+                    bound_batch_<const_iterator>(first, last, out, batch_upper);
+            }
+
             void swap(rb_tree& other)
             {
-                ft::swap(value_compare_, other.value_compare);
+                ft::swap(value_compare_, other.value_compare_);
                 ft::swap(value_alloc_, other.value_alloc_);
                 ft::swap(node_alloc_, other.node_alloc_);
                 ft::swap(size_, other.size_);
                 ft::swap(nil_, other.nil_);
                 ft::swap(leftmost_, other.leftmost_);
+                slabs_.swap(other.slabs_);
+                ft::swap(free_list_, other.free_list_);
+                ft::swap(free_count_, other.free_count_);
             }
 
             allocator_type get_allocator() const { return value_alloc_; }
 
 
-                
-                
-                
-        private:
-            tree_type               tree_;
-    
-    };
+        protected:
 
+            /* below this share of the tree erase_if removes node by node */
+            static const size_type      bulk_erase_ratio_ = 4;
 
-} // namespace ft
+            /* descents a batched lookup keeps in flight at once */
+            static const size_type      batch_lanes_ = 8;
+
+            enum batch_mode { batch_lower, batch_upper, batch_find };
+
+            node_pointer root_() const { return node_(nil_->left); }
+
+            /* every link of the tree leads to a node_type or is NULL, the
+                node base is its first base so the cast costs nothing */
+            static node_pointer node_(base_pointer node) { return static_cast<node_pointer>(node); }
+
+            static node_pointer next_(node_pointer node) { return node_(tree_next<base_pointer>(node)); }
+
+            static node_pointer prev_(node_pointer node) { return node_(tree_prev<base_pointer>(node)); }
+
+            /* nil_ is never handed out as a value, only its links are
+                initialized. its val member stays unconstructed */
+            void init_nil_()
+            {
+                nil_ = node_alloc_.allocate(1);
+                balance_policy::init(nil_);
+                nil_->parent = NULL;
+                nil_->left = NULL;
+                nil_->right = NULL;
+                leftmost_ = nil_;
+            }
+
+            node_pointer create_node_(const value_type& val)
+            {
+                node_pointer node = allocate_node_();
+
+                try {
+                    value_alloc_.construct(&node->val, val);
+                } catch (...) {
+                    deallocate_node_(node);
+                    throw;
+                }
+                balance_policy::init(node);
+                node->parent = NULL;
+                node->left = NULL;
+                node->right = NULL;
+                set_prefix_(node, prefix_policy());
+                return node;
+            }
+
+            /*
+                Prefix handling, the no_prefix overloads compile down to
+                nothing. prefix_order_ compares the prefix of a key with the
+                one of a node: negative if the key is smaller, 0 on a tie.
+            */
+            void set_prefix_(node_pointer, no_prefix) {}
+
+            template <typename Policy>
+            void set_prefix_(node_pointer node, Policy)
+            {
+                node->prefix = value_compare_.prefix(node->val);
+            }
+
+            template <typename Key>
+            prefix_type key_prefix_(const Key&, no_prefix) const { return 0; }
+
+            template <typename Key, typename Policy>
+            prefix_type key_prefix_(const Key& key, Policy) const
+            {
+                return value_compare_.prefix(key);
+            }
+
+            static int prefix_order_(prefix_type, const_node_pointer, no_prefix) { return 0; }
+
+            template <typename Policy>
+            static int prefix_order_(prefix_type kp, const_node_pointer node, Policy)
+            {
+                if (kp < node->prefix)
+                    return -1;
+                return (node->prefix < kp) ? 1 : 0;
+            }
+
+            template <typename Key>
+            int compare_node_(const Key& key, prefix_type kp, const_node_pointer node) const
+            {
+                const int c = prefix_order_(kp, node, prefix_policy());
+
+                if (c != 0)
+                    return c;
+                return compare_3way(value_compare_, key, node->val);
+            }
+
+            /* compact() moves a value by its bytes when it may */
+            void relocate_value_(node_pointer dst, node_pointer src, true_type)
+            {
+                std::memcpy(static_cast<void*>(&dst->val), &src->val, sizeof(value_type));
+            }
+
+            void relocate_value_(node_pointer dst, node_pointer src, false_type)
+            {
+                value_alloc_.construct(&dst->val, src->val);
+            }
+
+            void destroy_value_(node_pointer, true_type) {}
+
+            void destroy_value_(node_pointer node, false_type)
+            {
+                value_alloc_.destroy(&node->val);
+            }
+
+            void destroy_node_(node_pointer node)
+            {
+                value_alloc_.destroy(&node->val);
+                deallocate_node_(node);
+            }
+
+            node_pointer allocate_node_()
+            {
+                if (free_list_ == NULL)
+                    return node_alloc_.allocate(1);
+
+                node_pointer node = free_list_;
+                free_list_ = node_(node->right);
+                --free_count_;
+                return node;
+            }
 
+            /* nodes of a slab go back to the free list, the others
+                straight back to the allocator */
+            void deallocate_node_(node_pointer node)
+            {
+                if (!in_slab_(node))
+                {
+                    node_alloc_.deallocate(node, 1);
+                    return;
+                }
+                node->right = free_list_;
+                free_list_ = node;
+                ++free_count_;
+            }
+
+            /* the number of slabs that start at or before node */
+            size_type slab_after_(node_pointer node) const
+            {
+                std::less<node_pointer>     less;
+                size_type                   first = 0;
+                size_type                   last = slabs_.size();
+
+                while (first < last)
+                {
+                    const size_type middle = first + (last - first) / 2;
+                    if (less(node, slabs_[middle].first))
+                        last = middle;
+                    else
+                        first = middle + 1;
+                }
+                return first;
+            }
+
+            bool in_slab_(node_pointer node) const
+            {
+                const size_type i = slab_after_(node);
+
+                return i != 0 && std::less<node_pointer>()(node, slabs_[i - 1].first + slabs_[i - 1].second);
+            }
+
+            /* only valid once every node is back on the free list */
+            void release_slabs_()
+            {
+                for (size_type i = 0; i < slabs_.size(); ++i)
+                    node_alloc_.deallocate(slabs_[i].first, slabs_[i].second);
+                slabs_.clear();
+                free_list_ = NULL;
+                free_count_ = 0;
+            }
 
-#include <string>
-#include <map>
+            void destroy_subtree_(node_pointer node)
+            {
+                while (node != NULL)
+                {
+                    destroy_subtree_(node_(node->right));
+                    node_pointer left = node_(node->left);
+                    destroy_node_(node);
+                    node = left;
+                }
+            }
 
-int main(void)
-{
-    std::map<int ,std::string>      tree_map = {{0, "introspection"},
-                                                {1, "nodes"}};
+            /* returns the child link where val is or would be inserted,
+                parent receives the node that link belongs to */
+            base_pointer& find_link_(node_pointer& parent, const value_type& val)
+            {
+                const prefix_type   kp = key_prefix_(val, prefix_policy());
+                base_pointer*       link = &nil_->left;
+
+                parent = nil_;
+                while (*link != NULL)
+                {
+                    parent = node_(*link);
+                    const int c = compare_node_(val, kp, parent);
+                    if (c < 0)
+                        link = &parent->left;
+                    else if (c > 0)
+                        link = &parent->right;
+                    else
+                        break;
+                }
+                return *link;
+            }
+
+            /* like find_link_ but never stops, an equivalent key sends
+                val to the right, or to the left with before */
+            base_pointer& find_link_equal_(node_pointer& parent, const value_type& val,
+                                            bool before)
+            {
+                const prefix_type   kp = key_prefix_(val, prefix_policy());
+                base_pointer*       link = &nil_->left;
+
+                parent = nil_;
+                while (*link != NULL)
+                {
+                    parent = node_(*link);
+                    const int c = compare_node_(val, kp, parent);
+                    if (c < 0 || (before && c == 0))
+                        link = &parent->left;
+                    else
+                        link = &parent->right;
+                }
+                return *link;
+            }
+
+            /* val before or after the elements with an equivalent key */
+            iterator insert_equal_(const value_type& val, bool before)
+            {
+                node_pointer    parent;
+                base_pointer&   link = find_link_equal_(parent, val, before);
+                node_pointer    node = create_node_(val);
+
+                insert_node_at_(parent, link, node);
+                return iterator(node);
+            }
+
+            void insert_node_at_(node_pointer parent, base_pointer& link, node_pointer node)
+            {
+                node->parent = parent;
+                link = node;
+                if (leftmost_ == nil_ || (parent == leftmost_ && &link == &parent->left))
+                    leftmost_ = node;
+                balance_policy::insert_rebalance(root_(), node);
+                ++size_;
+            }
+
+            template <typename Key>
+            node_pointer lower_bound_(const Key& key)
+            {
+                return lower_bound_in_(root_(), nil_, key, key_prefix_(key, prefix_policy()));
+            }
+
+            template <typename Key>
+            node_pointer upper_bound_(const Key& key)
+            {
+                return upper_bound_in_(root_(), nil_, key, key_prefix_(key, prefix_policy()));
+            }
+
+            /* the bounds within the subtree at node, result if the
+                subtree has none */
+            template <typename Key>
+            node_pointer lower_bound_in_(node_pointer node, node_pointer result, const Key& key,
+                                            prefix_type kp)
+            {
+                while (node != NULL)
+                {
+                    const int c = prefix_order_(kp, node, prefix_policy());
+                    if (c < 0 || (c == 0 && !value_compare_(node->val, key)))
+                    {
+                        result = node;
+                        node = node_(node->left);
+                    }
+                    else
+                        node = node_(node->right);
+                }
+                return result;
+            }
+
+            template <typename Key>
+            node_pointer upper_bound_in_(node_pointer node, node_pointer result, const Key& key,
+                                            prefix_type kp)
+            {
+                while (node != NULL)
+                {
+                    const int c = prefix_order_(kp, node, prefix_policy());
+                    if (c < 0 || (c == 0 && value_compare_(key, node->val)))
+                    {
+                        result = node;
+                        node = node_(node->left);
+                    }
+                    else
+                        node = node_(node->right);
+                }
+                return result;
+            }
+
+            /* above the first equivalent node both bounds take the same
+                path, the upper one remembers where it last went left */
+            template <typename Key>
+            pair<node_pointer, node_pointer> equal_range_(const Key& key)
+            {
+                const prefix_type   kp = key_prefix_(key, prefix_policy());
+                node_pointer        node = root_();
+                node_pointer        upper = nil_;
+
+                while (node != NULL)
+                {
+                    const int c = compare_node_(key, kp, node);
+                    if (c < 0)
+                    {
+                        upper = node;
+                        node = node_(node->left);
+                    }
+                    else if (c > 0)
+                        node = node_(node->right);
+                    else
+                        return ft::make_pair(lower_bound_in_(node_(node->left), node, key, kp),
+                                                upper_bound_in_(node_(node->right), upper, key, kp));
+                }
+                return ft::make_pair(upper, upper);
+            }
+
+            template <typename Key>
+            node_pointer lower_bound_near_(node_pointer hint, const Key& key)
+            {
+                if (root_() == NULL)
+                    return nil_;
+                if (hint == nil_)
+                    hint = node_(tree_max<base_pointer>(root_()));
+
+                node_pointer node = hint;
+                node_pointer result;
+
+                if (!value_compare_(hint->val, key))
+                {
+                    /* the answer is hint or lies before it. climb until the
+                        node left of the subtree is smaller than key */
+                    result = hint;
+                    while (node->parent != nil_)
+                    {
+                        if (!tree_is_left_child(node) && value_compare_(node_(node->parent)->val, key))
+                            break;
+                        node = node_(node->parent);
+                    }
+                }
+                else
+                {
+                    /* the answer lies after hint. climb until the node right
+                        of the subtree is not smaller than key, it is the
+                        answer unless the subtree holds a better one */
+                    result = nil_;
+                    while (node->parent != nil_)
+                    {
+                        if (tree_is_left_child(node) && !value_compare_(node_(node->parent)->val, key))
+                        {
+                            result = node_(node->parent);
+                            break;
+                        }
+                        node = node_(node->parent);
+                    }
+                }
+
+                while (node != NULL)
+                {
+                    if (!value_compare_(node->val, key))
+                    {
+                        result = node;
+                        node = node_(node->left);
+                    }
+                    else
+                        node = node_(node->right);
+                }
+                return result;
+            }
+
+            template <typename Iter, typename ForwardIt, typename OutputIt>
+            OutputIt bound_batch_(ForwardIt first, ForwardIt last, OutputIt out,
+                                    batch_mode mode)
+            {
+                ForwardIt       keys[batch_lanes_];
+                node_pointer    current[batch_lanes_];
+                node_pointer    result[batch_lanes_];
+
+                while (first != last)
+                {
+                    size_type lanes = 0;
+                    for (; lanes < batch_lanes_ && first != last; ++lanes, ++first)
+                    {
+                        keys[lanes] = first;
+                        current[lanes] = root_();
+                        result[lanes] = nil_;
+                    }
+
+                    /* one level per round for every lane still descending */
+                    size_type active = (root_() != NULL) ? lanes : 0;
+                    while (active > 0)
+                    {
+                        for (size_type i = 0; i < lanes; ++i)
+                        {
+                            node_pointer node = current[i];
+                            if (node == NULL)
+                                continue;
+
+                            bool go_left = (mode == batch_upper)
+                                ? value_compare_(*keys[i], node->val)
+                                : !value_compare_(node->val, *keys[i]);
+                            if (go_left)
+                            {
+                                result[i] = node;
+                                node = node_(node->left);
+                            }
+                            else
+                                node = node_(node->right);
+
+                            current[i] = node;
+                            if (node != NULL)
+                                FT_PREFETCH(node);
+                            else
+                                --active;
+                        }
+                    }
+
+                    for (size_type i = 0; i < lanes; ++i, ++out)
+                    {
+                        if (mode == batch_find && result[i] != nil_
+                            && value_compare_(*keys[i], result[i]->val))
+                            result[i] = nil_;
+                        *out = Iter(result[i]);
+                    }
+                }
+                return out;
+            }
+
+            /* replaces the current shape with a balanced tree of the
+                given nodes, which have to be in ascending order */
+            void relink_sorted_(ft::vector<node_pointer>& nodes)
+            {
+                const size_type n = nodes.size();
+
+                if (n == 0)
+                {
+                    nil_->left = NULL;
+                    leftmost_ = nil_;
+                    return;
+                }
+
+                node_pointer root = balance_policy::build(&nodes[0], n);
+                root->parent = nil_;
+                nil_->left = root;
+                leftmost_ = nodes[0];
+            }
+
+            /* structural copy, keeps the exact shape and balance data */
+            void copy_from_(const rb_tree& other)
+            {
+                if (other.root_() == NULL)
+                    return;
+                nil_->left = copy_subtree_(other.root_(), nil_);
+                leftmost_ = node_(tree_min<base_pointer>(root_()));
+                size_ = other.size_;
+            }
+
+            node_pointer copy_subtree_(const_node_pointer src, node_pointer parent)
+            {
+                node_pointer node = create_node_(src->val);
+
+                /* the balance data, the links still point into other */
+                static_cast<typename balance_policy::node_base&>(*node) = *src;
+                node->parent = parent;
+                node->left = NULL;
+                node->right = NULL;
+                try {
+                    if (src->left != NULL)
+                        node->left = copy_subtree_(node_(src->left), node);
+                    if (src->right != NULL)
+                        node->right = copy_subtree_(node_(src->right), node);
+                } catch (...) {
+                    destroy_subtree_(node);
+                    throw;
+                }
+                return node;
+            }
+    };
+
+
+} // namespace ft
 
-    return 0;
-}
\ No newline at end of file
+#endif // RED_BLACK_TREE_HPP
@@ -0,0 +1,414 @@
+#ifndef SHARDED_MAP_HPP
+# define SHARDED_MAP_HPP
+
+#include <functional>	// std::less, std::hash
+#include <memory>		// std::allocator
+#include <stdexcept>	// std::out_of_range
+#include <shared_mutex>	// std::shared_mutex
+#include <mutex>		// std::unique_lock
+
+#include "map.hpp"
+#include "vector.hpp"
+
+/*
+    A map split into Shards ft::maps, each behind its own reader-writer
+    lock. A sharding policy picks the shard of a key, by hash to spread
+    any workload evenly or by range to keep neighbouring keys together.
+    Threads working on different shards don't wait on each other, readers
+    of the same shard don't either.
+
+    Nothing hands out a reference into a shard, a lock would have to be
+    held for as long as it lives: lookups copy the mapped value out, or run
+    a function on the element under the lock with visit(). Ordered walks go
+    through a scan, which read-locks every shard while it lives and merges
+    the shards in key order.
+
+    A seqlock would make the readers cheaper still, but a reader racing a
+    writer would follow tree links the writer is rewriting; the tree needs
+    the readers to stay out.
+*/
+
+namespace ft {
+
+	/* Fibonacci hashing of std::hash, which is the identity for integers */
+	template <typename Key, typename Hash = std::hash<Key> >
+	struct hash_sharding
+	{
+		size_t operator()(const Key& key, size_t shards) const
+		{
+			const unsigned long long h = Hash()(key) * 0x9E3779B97F4A7C15ULL;
+
+			return static_cast<size_t>((h >> 32) % shards);
+		}
+	};
+
+	/* Shards - 1 sorted split keys, shard i holds the keys from split i - 1
+		up to split i. without splits everything goes to shard 0 */
+	template <typename Key, typename Compare = std::less<Key> >
+	class range_sharding
+	{
+		private:
+			ft::vector<Key>		splits_;
+			Compare				comp_;
+
+		public:
+			range_sharding() {}
+
+			template <typename InputIt>
+			range_sharding(InputIt first, InputIt last, const Compare& comp = Compare())
+				: splits_(first, last), comp_(comp)
+			{}
+
+			size_t operator()(const Key& key, size_t shards) const
+			{
+				size_t first = 0;
+				size_t count = splits_.size();
+
+				/* upper_bound */
+				while (count > 0)
+				{
+					const size_t half = count / 2;
+					if (!comp_(key, splits_[first + half]))
+					{
+						first += half + 1;
+						count -= half + 1;
+					}
+					else
+						count = half;
+				}
+				return (first < shards) ? first : shards - 1;
+			}
+	};
+
+
+	/* a k-way merge of the shards, a binary heap of shard cursors ordered
+		by their current key */
+	template <typename MapIterator, typename Compare, size_t Shards>
+	class sharded_map_iterator
+	{
+		public:
+			typedef forward_iterator_tag								iterator_category;
+			typedef typename iterator_traits<MapIterator>::value_type	value_type;
+			typedef typename iterator_traits<MapIterator>::reference	reference;
+			typedef typename iterator_traits<MapIterator>::pointer		pointer;
+			typedef ptrdiff_t											difference_type;
+
+		private:
+			MapIterator		pos_[Shards];
+			MapIterator		end_[Shards];
+			size_t			heap_[Shards];
+			size_t			heap_size_;
+			Compare			comp_;
+
+		public:
+			sharded_map_iterator() : heap_size_(0)
+			{}
+
+			/* the cursor of shard i is [first[i], last[i]) */
+			sharded_map_iterator(const MapIterator* first, const MapIterator* last,
+									const Compare& comp)
+				: heap_size_(0), comp_(comp)
+			{
+				for (size_t i = 0; i < Shards; ++i)
+				{
+					pos_[i] = first[i];
+					end_[i] = last[i];
+					if (first[i] != last[i])
+						heap_[heap_size_++] = i;
+				}
+				for (size_t i = heap_size_ / 2; i-- > 0; )
+					sift_down_(i);
+			}
+
+			reference operator*() const { return *pos_[heap_[0]]; }
+
+			pointer operator->() const { return &*pos_[heap_[0]]; }
+
+			sharded_map_iterator& operator++()
+			{
+				const size_t top = heap_[0];
+
+				if (++pos_[top] == end_[top])
+					heap_[0] = heap_[--heap_size_];
+				sift_down_(0);
+				return *this;
+			}
+
+			sharded_map_iterator operator++(int)
+			{
+				sharded_map_iterator tmp = *this;
+				++(*this);
+				return tmp;
+			}
+
+			friend bool operator==(const sharded_map_iterator& lhs, const sharded_map_iterator& rhs)
+			{
+				if (lhs.heap_size_ == 0 || rhs.heap_size_ == 0)
+					return lhs.heap_size_ == rhs.heap_size_;
+				return &*lhs == &*rhs;
+			}
+
+			friend bool operator!=(const sharded_map_iterator& lhs, const sharded_map_iterator& rhs)
+			{
+				return !(lhs == rhs);
+			}
+
+		private:
+			bool less_(size_t a, size_t b) const
+			{
+				return comp_(pos_[heap_[a]]->first, pos_[heap_[b]]->first);
+			}
+
+			void sift_down_(size_t i)
+			{
+				for (;;)
+				{
+					size_t smallest = i;
+					const size_t left = 2 * i + 1;
+					if (left < heap_size_ && less_(left, smallest))
+						smallest = left;
+					if (left + 1 < heap_size_ && less_(left + 1, smallest))
+						smallest = left + 1;
+					if (smallest == i)
+						return;
+					ft::swap(heap_[i], heap_[smallest]);
+					i = smallest;
+				}
+			}
+	};
+
+
+	template <typename Key, typename T, size_t Shards = 16, typename Compare = std::less<Key>,
+				typename Sharding = hash_sharding<Key>,
+				typename Allocator = std::allocator<ft::pair<const Key, T> > >
+	class sharded_map
+	{
+		public:
+			typedef Key													key_type;
+			typedef T													mapped_type;
+			typedef ft::pair<const Key, T>								value_type;
+			typedef Compare												key_compare;
+			typedef Sharding											sharding_type;
+			typedef Allocator											allocator_type;
+			typedef typename allocator_type::size_type					size_type;
+			typedef typename allocator_type::difference_type			difference_type;
+
+			typedef ft::map<Key, T, Compare, Allocator>					shard_map_type;
+			typedef sharded_map_iterator<typename shard_map_type::const_iterator,
+											Compare, Shards>			const_iterator;
+
+			static const size_t		shard_count = Shards;
+
+		private:
+			/* a shard per cache line at least, the locks don't share one */
+			struct alignas(64) shard
+			{
+				mutable std::shared_mutex	lock;
+				shard_map_type				map;
+			};
+
+			typedef std::shared_lock<std::shared_mutex>		read_lock;
+			typedef std::unique_lock<std::shared_mutex>		write_lock;
+
+			shard			shards_[Shards];
+			sharding_type	sharding_;
+			key_compare		comp_;
+
+			sharded_map(const sharded_map&);
+			sharded_map& operator=(const sharded_map&);
+
+		public:
+
+			/*
+				Read-locks every shard while it lives, in index order; the
+				map only ever takes a single lock, so no deadlock. Writers
+				wait for the scan to end, keep it short.
+			*/
+			class scan
+			{
+				private:
+					const sharded_map&	map_;
+
+					scan(const scan&);
+					scan& operator=(const scan&);
+
+				public:
+					explicit scan(const sharded_map& map) : map_(map)
+					{
+						for (size_t i = 0; i < Shards; ++i)
+							map_.shards_[i].lock.lock_shared();
+					}
+
+					~scan()
+					{
+						for (size_t i = Shards; i-- > 0; )
+							map_.shards_[i].lock.unlock_shared();
+					}
+
+					const_iterator begin() const
+					{
+						typename shard_map_type::const_iterator first[Shards];
+						typename shard_map_type::const_iterator last[Shards];
+
+						for (size_t i = 0; i < Shards; ++i)
+						{
+							first[i] = map_.shards_[i].map.begin();
+							last[i] = map_.shards_[i].map.end();
+						}
+						return const_iterator(first, last, map_.comp_);
+					}
+
+					const_iterator end() const { return const_iterator(); }
+
+					/* exact, nothing changes during the scan */
+					size_type size() const
+					{
+						size_type n = 0;
+
+						for (size_t i = 0; i < Shards; ++i)
+							n += map_.shards_[i].map.size();
+						return n;
+					}
+			};
+
+			explicit sharded_map(const Sharding& sharding = Sharding(),
+									const Compare& comp = Compare())
+				: sharding_(sharding), comp_(comp)
+			{
+				for (size_t i = 0; i < Shards; ++i)
+					shards_[i].map = shard_map_type(comp);
+			}
+
+			/* the sum of the shards one after another, exact only when no
+				update is running */
+			size_type size() const
+			{
+				size_type n = 0;
+
+				for (size_t i = 0; i < Shards; ++i)
+				{
+					read_lock lock(shards_[i].lock);
+					n += shards_[i].map.size();
+				}
+				return n;
+			}
+
+			bool empty() const { return size() == 0; }
+
+			bool insert(const value_type& val)
+			{
+				shard&		s = shard_(val.first);
+				write_lock	lock(s.lock);
+
+				return s.map.insert(val).second;
+			}
+
+			template <typename InputIt>
+			void insert(InputIt first, InputIt last)
+			{
+				for (; first != last; ++first)
+					insert(*first);
+			}
+
+			/* true if the key was new */
+			bool insert_or_assign(const key_type& key, const mapped_type& obj)
+			{
+				shard&		s = shard_(key);
+				write_lock	lock(s.lock);
+
+				ft::pair<typename shard_map_type::iterator, bool> res
+					= s.map.insert(ft::make_pair(key, obj));
+				if (!res.second)
+					res.first->second = obj;
+				return res.second;
+			}
+
+			size_type erase(const key_type& key)
+			{
+				shard&		s = shard_(key);
+				write_lock	lock(s.lock);
+
+				return s.map.erase(key);
+			}
+
+			void clear()
+			{
+				for (size_t i = 0; i < Shards; ++i)
+				{
+					write_lock lock(shards_[i].lock);
+					shards_[i].map.clear();
+				}
+			}
+
+			size_type count(const key_type& key) const
+			{
+				const shard&	s = shard_(key);
+				read_lock		lock(s.lock);
+
+				return s.map.count(key);
+			}
+
+			/* copies the mapped value to obj if the key is there */
+			bool find(const key_type& key, mapped_type& obj) const
+			{
+				const shard&	s = shard_(key);
+				read_lock		lock(s.lock);
+
+				typename shard_map_type::const_iterator it = s.map.find(key);
+				if (it == s.map.end())
+					return false;
+				obj = it->second;
+				return true;
+			}
+
+			mapped_type at(const key_type& key) const
+			{
+				mapped_type obj;
+
+				if (!find(key, obj))
+					throw std::out_of_range("ft::sharded_map");
+				return obj;
+			}
+
+			/* f(value_type&) under the write lock of the key's shard. false
+				if the key isn't there, f mustn't touch the map */
+			template <typename Function>
+			bool visit(const key_type& key, Function f)
+			{
+				shard&		s = shard_(key);
+				write_lock	lock(s.lock);
+
+				typename shard_map_type::iterator it = s.map.find(key);
+				if (it == s.map.end())
+					return false;
+				f(*it);
+				return true;
+			}
+
+			/* f(const value_type&) under the read lock */
+			template <typename Function>
+			bool visit(const key_type& key, Function f) const
+			{
+				const shard&	s = shard_(key);
+				read_lock		lock(s.lock);
+
+				typename shard_map_type::const_iterator it = s.map.find(key);
+				if (it == s.map.end())
+					return false;
+				f(*it);
+				return true;
+			}
+
+			key_compare key_comp() const { return comp_; }
+
+			sharding_type sharding() const { return sharding_; }
+
+		private:
+			shard& shard_(const key_type& key) { return shards_[sharding_(key, Shards)]; }
+
+			const shard& shard_(const key_type& key) const { return shards_[sharding_(key, Shards)]; }
+	};
+
+} // namespace ft
+
+#endif // SHARDED_MAP_HPP
@@ -0,0 +1,686 @@
+#ifndef SMALL_MAP_HPP
+# define SMALL_MAP_HPP
+
+#include <functional>	// std::less
+#include <memory>		// std::allocator
+#include <stdexcept>	// std::out_of_range
+#include <cstring>		// std::memcpy
+#include <type_traits>	// std::is_convertible
+
+#include "map.hpp"
+
+/*
+    A map for the common case of a handful of elements. Up to N elements
+    live inside the object in a sorted array, no node and no allocation.
+    Inserting the (N + 1)th element moves everything into an ft::map and
+    the small_map keeps forwarding to it from then on. clear() brings it
+    back to the inline array.
+
+    The interface is the one of ft::map. The iterators are bidirectional
+    like the ones of map and wrap either a slot of the array or a map
+    iterator. Switching to the map invalidates all iterators, while inline
+    an insert or erase invalidates the iterators behind the position.
+*/
+
+namespace ft {
+
+	template <typename Pointer, typename Reference, typename TreeIterator>
+	class small_map_iterator
+	{
+		public:
+			typedef bidirectional_iterator_tag							iterator_category;
+			typedef typename iterator_traits<TreeIterator>::value_type	value_type;
+			typedef Reference											reference;
+			typedef Pointer												pointer;
+			typedef ptrdiff_t											difference_type;
+
+		private:
+			/* set while the elements are inline, NULL once they are in the map */
+			pointer			slot_;
+			TreeIterator	node_;
+
+		public:
+			small_map_iterator() : slot_(NULL), node_()
+			{}
+
+			explicit small_map_iterator(pointer slot) : slot_(slot), node_()
+			{}
+
+			explicit small_map_iterator(const TreeIterator& node) : slot_(NULL), node_(node)
+			{}
+
+			/* iterator to const_iterator, not the other way */
+			template <typename P, typename R, typename I>
+			small_map_iterator(const small_map_iterator<P, R, I>& other,
+								typename ft::enable_if<std::is_convertible<P, Pointer>::value>::type* = 0)
+				: slot_(other.slot()), node_(other.node())
+			{}
+
+			pointer slot() const { return slot_; }
+
+			TreeIterator node() const { return node_; }
+
+			reference operator*() const
+			{
+				if (slot_ != NULL)
+					return *slot_;
+				return *node_;
+			}
+
+			pointer operator->() const { return &(operator*()); }
+
+			small_map_iterator& operator++()
+			{
+				if (slot_ != NULL)
+					++slot_;
+				else
+					++node_;
+				return *this;
+			}
+
+			small_map_iterator operator++(int)
+			{
+				small_map_iterator tmp = *this;
+				++(*this);
+				return tmp;
+			}
+
+			small_map_iterator& operator--()
+			{
+				if (slot_ != NULL)
+					--slot_;
+				else
+					--node_;
+				return *this;
+			}
+
+			small_map_iterator operator--(int)
+			{
+				small_map_iterator tmp = *this;
+				--(*this);
+				return tmp;
+			}
+	};
+
+	template <typename P1, typename R1, typename I1, typename P2, typename R2, typename I2>
+	bool operator==(const small_map_iterator<P1, R1, I1>& lhs,
+					const small_map_iterator<P2, R2, I2>& rhs)
+	{
+		return lhs.slot() == rhs.slot() && lhs.node() == rhs.node();
+	}
+
+	template <typename P1, typename R1, typename I1, typename P2, typename R2, typename I2>
+	bool operator!=(const small_map_iterator<P1, R1, I1>& lhs,
+					const small_map_iterator<P2, R2, I2>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+
+	template <typename Key, typename T, size_t N, typename Compare = std::less<Key>,
+				typename Allocator = std::allocator<ft::pair<const Key, T> > >
+	class small_map
+	{
+		public:
+			typedef Key													key_type;
+			typedef T													mapped_type;
+			typedef ft::pair<const Key, T>								value_type;
+			typedef Compare												key_compare;
+			typedef Allocator											allocator_type;
+			typedef typename allocator_type::reference					reference;
+			typedef typename allocator_type::const_reference			const_reference;
+			typedef typename allocator_type::pointer					pointer;
+			typedef typename allocator_type::const_pointer				const_pointer;
+			typedef typename allocator_type::size_type					size_type;
+			typedef typename allocator_type::difference_type			difference_type;
+
+			typedef ft::map<Key, T, Compare, Allocator>					map_type;
+			typedef typename map_type::value_compare					value_compare;
+
+			typedef small_map_iterator<pointer, reference,
+							typename map_type::iterator>				iterator;
+			typedef small_map_iterator<const_pointer, const_reference,
+							typename map_type::const_iterator>			const_iterator;
+			typedef ft::reverse_iterator<iterator>						reverse_iterator;
+			typedef ft::reverse_iterator<const_iterator>				const_reverse_iterator;
+
+		private:
+			typedef typename allocator_type::template
+				rebind<map_type>::other									map_allocator_type;
+			/* the one the map allocates its nodes with */
+			typedef typename ft::rb_tree<value_type, value_compare,
+						allocator_type>::node_allocator_type			node_allocator_type;
+
+			/* value_compare is only built by a map, or by what derives
+				from it */
+			struct value_compare_maker_ : public value_compare
+			{
+				explicit value_compare_maker_(const key_compare& comp) : value_compare(comp)
+				{}
+			};
+
+			static_assert(N > 0, "ft::small_map needs room for at least one element");
+
+			alignas(value_type) unsigned char	storage_[sizeof(value_type) * N];
+			size_type							count_;
+			map_type*							spill_;
+			key_compare							comp_;
+			allocator_type						alloc_;
+
+		public:
+
+			explicit small_map(const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+				: count_(0), spill_(NULL), comp_(comp), alloc_(alloc)
+			{}
+
+			template <typename InputIt>
+			small_map(InputIt first, InputIt last, const Compare& comp = Compare(),
+						const Allocator& alloc = Allocator())
+				: count_(0), spill_(NULL), comp_(comp), alloc_(alloc)
+			{
+				try {
+					insert(first, last);
+				} catch (...) {
+					clear();
+					throw;
+				}
+			}
+
+			small_map(const small_map& other)
+				: count_(0), spill_(NULL), comp_(other.comp_), alloc_(other.alloc_)
+			{
+				if (other.spill_ != NULL)
+				{
+					spill_ = create_map_(*other.spill_);
+					return;
+				}
+				try {
+					for (; count_ < other.count_; ++count_)
+						alloc_.construct(slots_() + count_, other.slots_()[count_]);
+				} catch (...) {
+					clear();
+					throw;
+				}
+			}
+
+			~small_map()
+			{
+				clear();
+			}
+
+			small_map& operator=(const small_map& other)
+			{
+				if (this != &other)
+				{
+					small_map tmp(other);
+					swap(tmp);
+				}
+				return *this;
+			}
+
+
+			iterator begin()
+			{
+				if (spill_ != NULL)
+					return iterator(spill_->begin());
+				return iterator(slots_());
+			}
+
+			const_iterator begin() const
+			{
+				if (spill_ != NULL)
+					return const_iterator(static_cast<const map_type*>(spill_)->begin());
+				return const_iterator(slots_());
+			}
+
+			iterator end()
+			{
+				if (spill_ != NULL)
+					return iterator(spill_->end());
+				return iterator(slots_() + count_);
+			}
+
+			const_iterator end() const
+			{
+				if (spill_ != NULL)
+					return const_iterator(static_cast<const map_type*>(spill_)->end());
+				return const_iterator(slots_() + count_);
+			}
+
+			reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+			const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+			reverse_iterator rend() { return reverse_iterator(begin()); }
+
+			const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+			bool empty() const { return size() == 0; }
+
+			size_type size() const { return (spill_ != NULL) ? spill_->size() : count_; }
+
+			size_type max_size() const { return node_allocator_type(alloc_).max_size(); }
+
+			/* not part of std::map. true while the elements live in the object */
+			bool is_inline() const { return spill_ == NULL; }
+
+			mapped_type& operator[](const key_type& key)
+			{
+				if (spill_ != NULL)
+					return (*spill_)[key];
+
+				size_type idx = lower_bound_index_(key);
+				if (idx == count_ || comp_(key, slots_()[idx].first))
+					return insert_at_(idx, value_type(key, mapped_type()))->second;
+				return slots_()[idx].second;
+			}
+
+			mapped_type& at(const key_type& key)
+			{
+				iterator it = find(key);
+
+				if (it == end())
+					throw std::out_of_range("ft::small_map");
+				return it->second;
+			}
+
+			const mapped_type& at(const key_type& key) const
+			{
+				const_iterator it = find(key);
+
+				if (it == end())
+					throw std::out_of_range("ft::small_map");
+				return it->second;
+			}
+
+			ft::pair<iterator, bool> insert(const value_type& val)
+			{
+				if (spill_ != NULL)
+				{
+					ft::pair<typename map_type::iterator, bool> ret = spill_->insert(val);
+					return ft::make_pair(iterator(ret.first), ret.second);
+				}
+
+				size_type idx = lower_bound_index_(val.first);
+				if (idx < count_ && !comp_(val.first, slots_()[idx].first))
+					return ft::make_pair(iterator(slots_() + idx), false);
+				return ft::make_pair(insert_at_(idx, val), true);
+			}
+
+			iterator insert(iterator position, const value_type& val)
+			{
+				if (spill_ != NULL)
+					return iterator(spill_->insert(position.node(), val));
+				return insert(val).first;
+			}
+
+			template <typename InputIt>
+			void insert(InputIt first, InputIt last)
+			{
+				for (; first != last; ++first)
+					insert(*first);
+			}
+
+			iterator erase(iterator position)
+			{
+				if (spill_ != NULL)
+					return iterator(spill_->erase(position.node()));
+
+				size_type idx = position.slot() - slots_();
+				erase_at_(idx, idx + 1);
+				return iterator(slots_() + idx);
+			}
+
+			iterator erase(iterator first, iterator last)
+			{
+				if (spill_ != NULL)
+					return iterator(spill_->erase(first.node(), last.node()));
+
+				size_type idx = first.slot() - slots_();
+				erase_at_(idx, last.slot() - slots_());
+				return iterator(slots_() + idx);
+			}
+
+			size_type erase(const key_type& key)
+			{
+				if (spill_ != NULL)
+					return spill_->erase(key);
+
+				iterator it = find(key);
+				if (it == end())
+					return 0;
+				erase(it);
+				return 1;
+			}
+
+			/* also gives the map back, the elements are inline afterwards */
+			void clear()
+			{
+				if (spill_ != NULL)
+				{
+					destroy_map_(spill_);
+					spill_ = NULL;
+				}
+				erase_at_(0, count_);
+			}
+
+			/*
+				Maps change owner by a pointer swap. Inline elements are
+				copied: into the unused array of a spilled other, so a
+				throwing copy leaves both as they were. When both are inline
+				the elements are swapped as bytes if they are trivially
+				relocatable, otherwise one side goes through a copy and a
+				throwing copy may leave it with fewer elements.
+			*/
+			void swap(small_map& other)
+			{
+				if (spill_ != NULL && other.spill_ != NULL)
+					ft::swap(spill_, other.spill_);
+				else if (spill_ != NULL)
+					other.hand_over_(*this);
+				else if (other.spill_ != NULL)
+					hand_over_(other);
+				else
+				{
+					swap_inline_(other, typename is_trivially_relocatable<value_type>::type());
+					return;
+				}
+				ft::swap(comp_, other.comp_);
+				ft::swap(alloc_, other.alloc_);
+			}
+
+			key_compare key_comp() const { return comp_; }
+
+			value_compare value_comp() const { return value_compare_maker_(comp_); }
+
+			iterator find(const key_type& key)
+			{
+				if (spill_ != NULL)
+					return iterator(spill_->find(key));
+
+				size_type idx = lower_bound_index_(key);
+				if (idx == count_ || comp_(key, slots_()[idx].first))
+					return end();
+				return iterator(slots_() + idx);
+			}
+
+			const_iterator find(const key_type& key) const
+			{
+				return const_cast<small_map*>(this)->find(key);
+			}
+
+			size_type count(const key_type& key) const
+			{
+				return (find(key) != end()) ? 1 : 0;
+			}
+
+			iterator lower_bound(const key_type& key)
+			{
+				if (spill_ != NULL)
+					return iterator(spill_->lower_bound(key));
+				return iterator(slots_() + lower_bound_index_(key));
+			}
+
+			const_iterator lower_bound(const key_type& key) const
+			{
+				return const_cast<small_map*>(this)->lower_bound(key);
+			}
+
+			iterator upper_bound(const key_type& key)
+			{
+				if (spill_ != NULL)
+					return iterator(spill_->upper_bound(key));
+				return iterator(slots_() + upper_bound_index_(key));
+			}
+
+			const_iterator upper_bound(const key_type& key) const
+			{
+				return const_cast<small_map*>(this)->upper_bound(key);
+			}
+
+			ft::pair<iterator, iterator> equal_range(const key_type& key)
+			{
+				return ft::make_pair(lower_bound(key), upper_bound(key));
+			}
+
+			ft::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+			{
+				return ft::make_pair(lower_bound(key), upper_bound(key));
+			}
+
+			allocator_type get_allocator() const { return alloc_; }
+
+
+		private:
+
+			pointer slots_() { return reinterpret_cast<pointer>(storage_); }
+
+			const_pointer slots_() const { return reinterpret_cast<const_pointer>(storage_); }
+
+			/* N is small, counting the smaller keys beats a binary search and
+				has no branch that depends on the keys */
+			size_type lower_bound_index_(const key_type& key) const
+			{
+				size_type idx = 0;
+
+				for (size_type i = 0; i < count_; ++i)
+					idx += comp_(slots_()[i].first, key);
+				return idx;
+			}
+
+			size_type upper_bound_index_(const key_type& key) const
+			{
+				size_type idx = 0;
+
+				for (size_type i = 0; i < count_; ++i)
+					idx += !comp_(key, slots_()[i].first);
+				return idx;
+			}
+
+			/* the keys are const, elements are moved by copy constructing
+				them one slot further and destroying the old one. should a copy
+				throw, the elements behind the gap are dropped so the array
+				stays contiguous */
+			iterator insert_at_(size_type idx, const value_type& val)
+			{
+				if (count_ == N)
+				{
+					spill_to_map_();
+					return insert(val).first;
+				}
+
+				pointer		slots = slots_();
+				size_type	j = count_;
+
+				try {
+					for (; j > idx; --j)
+					{
+						alloc_.construct(slots + j, slots[j - 1]);
+						alloc_.destroy(slots + j - 1);
+					}
+					alloc_.construct(slots + idx, val);
+				} catch (...) {
+					for (size_type k = j + 1; k <= count_; ++k)
+						alloc_.destroy(slots + k);
+					count_ = j;
+					throw;
+				}
+				++count_;
+				return iterator(slots + idx);
+			}
+
+			void erase_at_(size_type first, size_type last)
+			{
+				pointer		slots = slots_();
+				size_type	j = first;
+
+				for (size_type i = first; i < last; ++i)
+					alloc_.destroy(slots + i);
+				try {
+					for (size_type i = last; i < count_; ++i, ++j)
+					{
+						alloc_.construct(slots + j, slots[i]);
+						alloc_.destroy(slots + i);
+					}
+				} catch (...) {
+					for (size_type i = j + (last - first); i < count_; ++i)
+						alloc_.destroy(slots + i);
+					count_ = j;
+					throw;
+				}
+				count_ = j;
+			}
+
+			/* the array is full, its elements move into a map that gets
+				room for twice as many in one block */
+			void spill_to_map_()
+			{
+				map_type* m = create_map_(map_type(comp_, alloc_));
+
+				try {
+					m->reserve(N * 2);
+					for (size_type i = 0; i < count_; ++i)
+						m->insert(m->end(), slots_()[i]);
+				} catch (...) {
+					destroy_map_(m);
+					throw;
+				}
+				erase_at_(0, count_);
+				spill_ = m;
+			}
+
+			/* this is inline, spilled is not: the elements are copied into
+				the array of spilled first, the rest can't throw */
+			void hand_over_(small_map& spilled)
+			{
+				pointer		slots = spilled.slots_();
+				size_type	n = 0;
+
+				try {
+					for (; n < count_; ++n)
+						alloc_.construct(slots + n, slots_()[n]);
+				} catch (...) {
+					while (n > 0)
+						alloc_.destroy(slots + --n);
+					throw;
+				}
+				erase_at_(0, count_);
+				spilled.count_ = n;
+				spill_ = spilled.spill_;
+				spilled.spill_ = NULL;
+			}
+
+			void swap_inline_(small_map& other, true_type)
+			{
+				unsigned char	buffer[sizeof(storage_)];
+
+				std::memcpy(buffer, storage_, sizeof(storage_));
+				std::memcpy(storage_, other.storage_, sizeof(storage_));
+				std::memcpy(other.storage_, buffer, sizeof(storage_));
+				ft::swap(count_, other.count_);
+				ft::swap(comp_, other.comp_);
+				ft::swap(alloc_, other.alloc_);
+			}
+
+			void swap_inline_(small_map& other, false_type)
+			{
+				small_map tmp(other);
+
+				other.clear();
+				other.take_(*this);
+				clear();
+				take_(tmp);
+			}
+
+			/* moves the elements of an empty-handed other into this empty map */
+			void take_(small_map& other)
+			{
+				comp_ = other.comp_;
+				alloc_ = other.alloc_;
+				if (other.spill_ != NULL)
+				{
+					spill_ = other.spill_;
+					other.spill_ = NULL;
+					return;
+				}
+				for (; count_ < other.count_; ++count_)
+					alloc_.construct(slots_() + count_, other.slots_()[count_]);
+				other.clear();
+			}
+
+			map_type* create_map_(const map_type& src)
+			{
+				map_allocator_type	map_alloc(alloc_);
+				map_type*			m = map_alloc.allocate(1);
+
+				try {
+					map_alloc.construct(m, src);
+				} catch (...) {
+					map_alloc.deallocate(m, 1);
+					throw;
+				}
+				return m;
+			}
+
+			void destroy_map_(map_type* m)
+			{
+				map_allocator_type	map_alloc(alloc_);
+
+				map_alloc.destroy(m);
+				map_alloc.deallocate(m, 1);
+			}
+	};
+
+
+	template <typename Key, typename T, size_t N, typename Compare, typename Alloc>
+	bool operator==(const small_map<Key, T, N, Compare, Alloc>& lhs,
+					const small_map<Key, T, N, Compare, Alloc>& rhs)
+	{
+		return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template <typename Key, typename T, size_t N, typename Compare, typename Alloc>
+	bool operator!=(const small_map<Key, T, N, Compare, Alloc>& lhs,
+					const small_map<Key, T, N, Compare, Alloc>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <typename Key, typename T, size_t N, typename Compare, typename Alloc>
+	bool operator<(const small_map<Key, T, N, Compare, Alloc>& lhs,
+					const small_map<Key, T, N, Compare, Alloc>& rhs)
+	{
+		return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template <typename Key, typename T, size_t N, typename Compare, typename Alloc>
+	bool operator<=(const small_map<Key, T, N, Compare, Alloc>& lhs,
+					const small_map<Key, T, N, Compare, Alloc>& rhs)
+	{
+		return !(rhs < lhs);
+	}
+
+	template <typename Key, typename T, size_t N, typename Compare, typename Alloc>
+	bool operator>(const small_map<Key, T, N, Compare, Alloc>& lhs,
+					const small_map<Key, T, N, Compare, Alloc>& rhs)
+	{
+		return rhs < lhs;
+	}
+
+	template <typename Key, typename T, size_t N, typename Compare, typename Alloc>
+	bool operator>=(const small_map<Key, T, N, Compare, Alloc>& lhs,
+					const small_map<Key, T, N, Compare, Alloc>& rhs)
+	{
+		return !(lhs < rhs);
+	}
+
+	template <typename Key, typename T, size_t N, typename Compare, typename Alloc>
+	void swap(small_map<Key, T, N, Compare, Alloc>& lhs,
+				small_map<Key, T, N, Compare, Alloc>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+
+} // namespace ft
+
+#endif // SMALL_MAP_HPP
@@ -0,0 +1,123 @@
+#ifndef SMALL_VECTOR_HPP
+# define SMALL_VECTOR_HPP
+
+#include <cstddef>		// size_t
+#include <memory>		// std::allocator
+
+#include "vector.hpp"
+
+/*
+    A vector that keeps its first N elements inside the object. Most of
+    the vectors out there hold a handful of elements, an ft::vector pays a
+    heap allocation for each of them anyway. small_vector starts on a
+    buffer of N elements of its own and only goes to the allocator once it
+    grows beyond that, from there on it behaves like ft::vector (same
+    growth, same block on the heap). clear() keeps the heap block, like the
+    capacity of a vector.
+
+        ft::small_vector<int, 16>   v;
+        for (int i = 0; i < 16; ++i)
+            v.push_back(i);         // no allocation so far
+        v.push_back(16);            // the 17 elements move to the heap
+
+    It is a basic_vector (vector.hpp) like ft::vector, the same code with
+    another storage, so the interface and the iterators are the ones of
+    ft::vector. What differs: the object is N elements bigger, and a swap
+    with a vector that is still on its buffer swaps the elements, not the
+    blocks, so it is O(n) and invalidates the iterators.
+*/
+
+namespace ft {
+
+	/* heap_storage plus the buffer, the initial block of the vector */
+	template <typename T, size_t N, typename Allocator>
+	struct small_storage : public heap_storage<T, Allocator>
+	{
+		typedef heap_storage<T, Allocator>				base_type;
+		typedef typename base_type::size_type			size_type;
+		typedef typename base_type::pointer				pointer;
+		typedef typename base_type::const_pointer		const_pointer;
+		typedef ft::true_type							has_inline;
+
+		alignas(T) unsigned char	buffer_[N * sizeof(T)];
+
+		explicit small_storage(const Allocator& alloc = Allocator())
+			: base_type(alloc)
+		{}
+
+		/* the allocator, not the buffer: whatever is in there belongs to
+			the other vector */
+		small_storage(const small_storage& other)
+			: base_type(other)
+		{}
+
+		small_storage& operator=(const small_storage& other)
+		{
+			base_type::operator=(other);
+			return *this;
+		}
+
+		pointer initial() const
+		{
+			return reinterpret_cast<pointer>(const_cast<unsigned char*>(buffer_));
+		}
+
+		size_type initial_capacity() const { return N; }
+
+		bool is_inline(const_pointer p) const { return p == initial(); }
+	};
+
+
+	template <typename T, size_t N, typename Allocator = std::allocator<T> >
+	class small_vector : public basic_vector<T, small_storage<T, N, Allocator> >
+	{
+		private:
+			typedef basic_vector<T, small_storage<T, N, Allocator> >	base_type;
+			typedef typename base_type::storage_type					storage_type;
+
+		public:
+			typedef Allocator											allocator_type;
+			typedef typename base_type::value_type						value_type;
+			typedef typename base_type::size_type						size_type;
+
+			static const size_type		inline_capacity = N;
+
+			static_assert(N > 0, "ft::small_vector needs room for at least one element");
+
+			explicit small_vector(const allocator_type &alloc = allocator_type())
+				: base_type(storage_type(alloc))
+			{}
+
+			explicit small_vector(size_type n, const value_type &val = value_type(),
+									const allocator_type &alloc = allocator_type())
+				: base_type(n, val, storage_type(alloc))
+			{}
+
+			template <typename InputIterator>
+			small_vector(InputIterator first, InputIterator last, const allocator_type &alloc = allocator_type(),
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = 0)
+				: base_type(first, last, storage_type(alloc))
+			{}
+
+			allocator_type get_allocator() const
+			{
+				return this->storage_.alloc_;
+			}
+
+			/* not part of std::vector: whether the elements are still
+				inside the object */
+			bool is_inline() const
+			{
+				return this->storage_.is_inline(this->begin_);
+			}
+	};
+
+	template <typename T, size_t N, typename Alloc>
+	void swap(small_vector<T, N, Alloc>& lhs, small_vector<T, N, Alloc>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+
+} // namespace ft
+
+#endif // SMALL_VECTOR_HPP
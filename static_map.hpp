@@ -0,0 +1,370 @@
+#ifndef STATIC_MAP_HPP
+# define STATIC_MAP_HPP
+
+#include <cstddef>		// size_t
+#include <functional>	// std::less, std::equal_to
+#include <stdexcept>	// std::out_of_range, std::logic_error
+#include <string_view>
+#include <utility>		// std::index_sequence
+#include <stdint.h>		// uint64_t
+
+#include "algorithm.hpp"
+#include "utility.hpp"
+#include "type_traits.hpp"
+
+/*
+    Lookup tables built by the compiler, for keyword -> handler tables
+    and the like that would otherwise be an ft::map filled at startup.
+
+    static_map copies its N elements and sorts them by key in the
+    constructor, which is constexpr: a constexpr static_map is sorted while
+    compiling and ends up in read-only data, no allocation and no
+    initialization at run time. A lookup is a binary search over one array.
+
+    static_unordered_map keeps the elements in the order they were given
+    and builds a perfect hash for them, also while compiling: a lookup is
+    two hashes, one index and one key comparison. It needs a hash the
+    compiler can evaluate, static_hash has one for integers and string
+    views (a std::string_view, not a std::string).
+
+    The perfect hash is "hash and displace": the keys are hashed into
+    buckets, and the buckets, largest first, each get the first seed that
+    puts all of their keys into free slots. A lookup hashes to the bucket,
+    then with its seed to the slot. Twice as many slots as keys keep the
+    search short.
+
+    Both reject a duplicate key by throwing from the constructor, which
+    stops the compilation of a constexpr table.
+*/
+
+namespace ft {
+
+	/* 64-bit FNV-1a for strings, integers as they are; static_hash_mix
+		spreads either */
+	template <typename Key, typename Enable = void>
+	struct static_hash;
+
+	template <typename Key>
+	struct static_hash<Key, typename ft::enable_if<ft::is_integral<Key>::value>::type>
+	{
+		constexpr uint64_t operator()(Key key) const
+		{
+			return static_cast<uint64_t>(key);
+		}
+	};
+
+	template <>
+	struct static_hash<std::string_view>
+	{
+		constexpr uint64_t operator()(std::string_view key) const
+		{
+			uint64_t h = 0xcbf29ce484222325ULL;
+
+			for (size_t i = 0; i < key.size(); ++i)
+				h = (h ^ static_cast<unsigned char>(key[i])) * 0x100000001b3ULL;
+			return h;
+		}
+	};
+
+	constexpr uint64_t static_hash_mix(uint64_t h, uint64_t seed)
+	{
+		h = (h ^ seed) * 0x9E3779B97F4A7C15ULL;
+		return h ^ (h >> 32);
+	}
+
+
+	template <typename Key, typename T, size_t N, typename Compare = std::less<Key> >
+	class static_map
+	{
+		public:
+			typedef Key											key_type;
+			typedef T											mapped_type;
+			/* not pair<const Key, T>, the constructor sorts by assignment.
+				the elements are only handed out as const */
+			typedef ft::pair<Key, T>							value_type;
+			typedef Compare										key_compare;
+			typedef size_t										size_type;
+			typedef ptrdiff_t									difference_type;
+			typedef const value_type&							const_reference;
+			typedef const value_type*							const_pointer;
+			typedef const value_type*							const_iterator;
+			typedef const_iterator								iterator;
+
+			static_assert(N > 0, "ft::static_map needs at least one element");
+
+		private:
+			value_type		values_[N];
+			key_compare		comp_;
+
+		public:
+			constexpr static_map(const value_type (&values)[N], const Compare& comp = Compare())
+				: static_map(values, comp, std::make_index_sequence<N>())
+			{}
+
+			constexpr const_iterator begin() const { return values_; }
+
+			constexpr const_iterator end() const { return values_ + N; }
+
+			constexpr bool empty() const { return false; }
+
+			constexpr size_type size() const { return N; }
+
+			constexpr const_iterator lower_bound(const key_type& key) const
+			{
+				size_type first = 0;
+				size_type count = N;
+
+				while (count > 0)
+				{
+					const size_type half = count / 2;
+					if (comp_(values_[first + half].first, key))
+					{
+						first += half + 1;
+						count -= half + 1;
+					}
+					else
+						count = half;
+				}
+				return values_ + first;
+			}
+
+			constexpr const_iterator upper_bound(const key_type& key) const
+			{
+				const_iterator it = lower_bound(key);
+
+				return (it != end() && !comp_(key, it->first)) ? it + 1 : it;
+			}
+
+			constexpr const_iterator find(const key_type& key) const
+			{
+				const_iterator it = lower_bound(key);
+
+				return (it != end() && !comp_(key, it->first)) ? it : end();
+			}
+
+			constexpr size_type count(const key_type& key) const
+			{
+				return find(key) != end();
+			}
+
+			constexpr const mapped_type& at(const key_type& key) const
+			{
+				const_iterator it = find(key);
+
+				if (it == end())
+					throw std::out_of_range("ft::static_map");
+				return it->second;
+			}
+
+			constexpr key_compare key_comp() const { return comp_; }
+
+		private:
+			template <size_t... I>
+			constexpr static_map(const value_type (&values)[N], const Compare& comp,
+									std::index_sequence<I...>)
+				: values_{ values[I]... }, comp_(comp)
+			{
+				/* insertion sort, tables are small and it is the compiler's
+					time */
+				for (size_type i = 1; i < N; ++i)
+					for (size_type j = i; j > 0 && comp_(values_[j].first, values_[j - 1].first); --j)
+						ft::swap(values_[j], values_[j - 1]);
+				for (size_type i = 1; i < N; ++i)
+					if (!comp_(values_[i - 1].first, values_[i].first))
+						throw std::logic_error("ft::static_map: duplicate key");
+			}
+	};
+
+
+	template <typename Key, typename T, size_t N, typename Hash = static_hash<Key>,
+				typename KeyEqual = std::equal_to<Key> >
+	class static_unordered_map
+	{
+		public:
+			typedef Key											key_type;
+			typedef T											mapped_type;
+			typedef ft::pair<Key, T>							value_type;
+			typedef Hash										hasher;
+			typedef KeyEqual									key_equal;
+			typedef size_t										size_type;
+			typedef ptrdiff_t									difference_type;
+			typedef const value_type&							const_reference;
+			typedef const value_type*							const_pointer;
+			typedef const value_type*							const_iterator;
+			typedef const_iterator								iterator;
+
+			static_assert(N > 0, "ft::static_unordered_map needs at least one element");
+
+		private:
+			static constexpr size_type slots_for_(size_type n)
+			{
+				size_type slots = 2;
+
+				while (slots < 2 * n)
+					slots *= 2;
+				return slots;
+			}
+
+			/* powers of 2, the hashes are masked */
+			static const size_type		slot_count = slots_for_(N);
+			static const size_type		bucket_count = slot_count / 2;
+			/* attempts per bucket before giving up on the first seed */
+			static const uint64_t		max_seed = 1 << 16;
+
+			value_type		values_[N];
+			/* the index in values_ of the key in each slot, N if free */
+			size_type		slots_[slot_count];
+			uint64_t		seeds_[bucket_count];
+			uint64_t		first_seed_;
+			hasher			hash_;
+			key_equal		eq_;
+
+		public:
+			constexpr static_unordered_map(const value_type (&values)[N], const Hash& hash = Hash(),
+											const KeyEqual& eq = KeyEqual())
+				: static_unordered_map(values, hash, eq, std::make_index_sequence<N>())
+			{}
+
+			constexpr const_iterator begin() const { return values_; }
+
+			constexpr const_iterator end() const { return values_ + N; }
+
+			constexpr bool empty() const { return false; }
+
+			constexpr size_type size() const { return N; }
+
+			constexpr const_iterator find(const key_type& key) const
+			{
+				const uint64_t	h = hash_(key);
+				const size_type	bucket = static_hash_mix(h, first_seed_) & (bucket_count - 1);
+				const size_type	i = slots_[static_hash_mix(h, seeds_[bucket]) & (slot_count - 1)];
+
+				return (i != N && eq_(values_[i].first, key)) ? values_ + i : end();
+			}
+
+			constexpr size_type count(const key_type& key) const
+			{
+				return find(key) != end();
+			}
+
+			constexpr const mapped_type& at(const key_type& key) const
+			{
+				const_iterator it = find(key);
+
+				if (it == end())
+					throw std::out_of_range("ft::static_unordered_map");
+				return it->second;
+			}
+
+			constexpr hasher hash_function() const { return hash_; }
+
+			constexpr key_equal key_eq() const { return eq_; }
+
+		private:
+			template <size_t... I>
+			constexpr static_unordered_map(const value_type (&values)[N], const Hash& hash,
+											const KeyEqual& eq, std::index_sequence<I...>)
+				: values_{ values[I]... }, slots_(), seeds_(), first_seed_(0), hash_(hash), eq_(eq)
+			{
+				for (size_type i = 0; i < N; ++i)
+					for (size_type j = i + 1; j < N; ++j)
+						if (eq_(values_[i].first, values_[j].first))
+							throw std::logic_error("ft::static_unordered_map: duplicate key");
+
+				for (uint64_t seed = 1; ; ++seed)
+				{
+					if (seed == 16)
+						throw std::logic_error("ft::static_unordered_map: no perfect hash");
+					if (build_(seed))
+						return;
+				}
+			}
+
+			/* false if some bucket finds no seed */
+			constexpr bool build_(uint64_t first_seed)
+			{
+				uint64_t	hashes[N] = {};
+				size_type	buckets[N] = {};
+				size_type	sizes[bucket_count] = {};
+				size_type	largest = 0;
+
+				first_seed_ = first_seed;
+				for (size_type i = 0; i < slot_count; ++i)
+					slots_[i] = N;
+				for (size_type i = 0; i < N; ++i)
+				{
+					hashes[i] = hash_(values_[i].first);
+					buckets[i] = static_hash_mix(hashes[i], first_seed) & (bucket_count - 1);
+					largest = ft::max(largest, ++sizes[buckets[i]]);
+				}
+
+				for (size_type size = largest; size > 0; --size)
+					for (size_type b = 0; b < bucket_count; ++b)
+					{
+						if (sizes[b] != size)
+							continue;
+
+						size_type	members[N] = {};
+						size_type	n = 0;
+						for (size_type i = 0; i < N; ++i)
+							if (buckets[i] == b)
+								members[n++] = i;
+
+						if (!place_(hashes, members, n, b))
+							return false;
+					}
+				return true;
+			}
+
+			/* the first seed that sends the n keys of bucket b to n free
+				slots, and takes them */
+			constexpr bool place_(const uint64_t (&hashes)[N], const size_type (&members)[N],
+									size_type n, size_type b)
+			{
+				for (uint64_t seed = 1; seed < max_seed; ++seed)
+				{
+					size_type	taken[N] = {};
+					bool		fits = true;
+
+					for (size_type k = 0; k < n && fits; ++k)
+					{
+						taken[k] = static_hash_mix(hashes[members[k]], seed) & (slot_count - 1);
+						fits = (slots_[taken[k]] == N);
+						for (size_type j = 0; j < k && fits; ++j)
+							fits = (taken[j] != taken[k]);
+					}
+					if (!fits)
+						continue;
+
+					for (size_type k = 0; k < n; ++k)
+						slots_[taken[k]] = members[k];
+					seeds_[b] = seed;
+					return true;
+				}
+				return false;
+			}
+	};
+
+
+	/* the size comes from the braced list:
+		constexpr auto keywords = ft::make_static_map<std::string_view, int>({
+			{ "if", 1 }, { "else", 2 }, { "while", 3 } }); */
+	template <typename Key, typename T, typename Compare = std::less<Key>, size_t N>
+	constexpr static_map<Key, T, N, Compare>
+	make_static_map(const ft::pair<Key, T> (&values)[N], const Compare& comp = Compare())
+	{
+		return static_map<Key, T, N, Compare>(values, comp);
+	}
+
+	template <typename Key, typename T, typename Hash = static_hash<Key>,
+				typename KeyEqual = std::equal_to<Key>, size_t N>
+	constexpr static_unordered_map<Key, T, N, Hash, KeyEqual>
+	make_static_unordered_map(const ft::pair<Key, T> (&values)[N], const Hash& hash = Hash(),
+								const KeyEqual& eq = KeyEqual())
+	{
+		return static_unordered_map<Key, T, N, Hash, KeyEqual>(values, hash, eq);
+	}
+
+} // namespace ft
+
+#endif // STATIC_MAP_HPP
@@ -0,0 +1,150 @@
+#ifndef STATIC_VECTOR_HPP
+# define STATIC_VECTOR_HPP
+
+#include <cassert>
+#include <cstddef>		// size_t, ptrdiff_t
+#include <cstdlib>		// std::abort
+#include <new>			// placement new
+#include <stdexcept>	// std::length_error
+
+#include "vector.hpp"
+
+/*
+    A vector with a capacity fixed at compile time. The N elements live
+    inside the object, there is no allocator, nothing is ever allocated and
+    nothing ever moves: an element stays at its address until it is
+    erased, iterators only go invalid behind an insert or erase.
+
+        ft::static_vector<int, 64>                  v;
+        ft::stack<int, ft::static_vector<int, 64> > st;
+
+    It is a basic_vector (vector.hpp) like ft::vector, so the modifiers and
+    the iterators are the ones of ft::vector, capacity() is N. Growing
+    beyond N is an overflow, what happens then is the Overflow policy:
+
+        throw_on_overflow     std::length_error("ft::static_vector"), after
+                              push_back, insert or resize the vector
+                              stays as it was (the default)
+        assert_on_overflow    an assert in a debug build, std::abort() with
+                              NDEBUG. for code that can't have exceptions
+
+    The check costs the same in both, push_back compares against the
+    capacity anyway to know when to grow, the policy only runs once that
+    comparison fails. A swap swaps the elements, O(n).
+*/
+
+namespace ft {
+
+	struct throw_on_overflow
+	{
+		[[noreturn]] static void overflow()
+		{
+			throw std::length_error("ft::static_vector");
+		}
+	};
+
+	struct assert_on_overflow
+	{
+		[[noreturn]] static void overflow()
+		{
+			assert(!"ft::static_vector: overflow");
+			std::abort();
+		}
+	};
+
+
+	/* the buffer is the only block, anything bigger is an overflow */
+	template <typename T, size_t N, typename Overflow>
+	struct static_storage
+	{
+		typedef size_t								size_type;
+		typedef ptrdiff_t							difference_type;
+		typedef T&									reference;
+		typedef const T&							const_reference;
+		typedef T*									pointer;
+		typedef const T*							const_pointer;
+		typedef ft::true_type						has_inline;
+
+		alignas(T) unsigned char	buffer_[N * sizeof(T)];
+
+		static_storage()
+		{}
+
+		/* nothing to copy, the elements are the business of the vector */
+		static_storage(const static_storage&)
+		{}
+
+		static_storage& operator=(const static_storage&) { return *this; }
+
+		pointer initial() const
+		{
+			return reinterpret_cast<pointer>(const_cast<unsigned char*>(buffer_));
+		}
+
+		size_type initial_capacity() const { return N; }
+
+		/* basic_vector asks for a block only beyond initial_capacity() */
+		pointer allocate(size_type) { overflow(); }
+
+		void deallocate(pointer, size_type) {}
+
+		size_type extend(pointer, size_type, size_type) const { return 0; }
+
+		bool is_inline(const_pointer) const { return true; }
+
+		void construct(pointer p, const_reference val) { ::new (static_cast<void*>(p)) T(val); }
+
+		void destroy(pointer p) { p->~T(); }
+
+		size_type max_size() const { return N; }
+
+		[[noreturn]] void overflow() const { Overflow::overflow(); }
+
+		void swap(static_storage&) {}
+	};
+
+
+	template <typename T, size_t N, typename Overflow = throw_on_overflow>
+	class static_vector : public basic_vector<T, static_storage<T, N, Overflow> >
+	{
+		private:
+			typedef basic_vector<T, static_storage<T, N, Overflow> >	base_type;
+			typedef typename base_type::storage_type					storage_type;
+
+		public:
+			typedef typename base_type::value_type						value_type;
+			typedef typename base_type::size_type						size_type;
+			typedef Overflow											overflow_policy;
+
+			static_assert(N > 0, "ft::static_vector needs room for at least one element");
+
+			static_vector()
+				: base_type(storage_type())
+			{}
+
+			explicit static_vector(size_type n, const value_type &val = value_type())
+				: base_type(n, val, storage_type())
+			{}
+
+			template <typename InputIterator>
+			static_vector(InputIterator first, InputIterator last,
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = 0)
+				: base_type(first, last, storage_type())
+			{}
+
+			/* not part of std::vector: whether n more elements fit */
+			bool has_room(size_type n = 1) const
+			{
+				return n <= N - this->size();
+			}
+	};
+
+	template <typename T, size_t N, typename Overflow>
+	void swap(static_vector<T, N, Overflow>& lhs, static_vector<T, N, Overflow>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+
+} // namespace ft
+
+#endif // STATIC_VECTOR_HPP
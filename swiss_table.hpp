@@ -0,0 +1,574 @@
+#ifndef SWISS_TABLE_HPP
+# define SWISS_TABLE_HPP
+
+#include <memory>		// std::allocator
+#include <cstddef>		// ptrdiff_t
+#include <cstring>		// std::memcpy, std::memset
+#include <stdint.h>		// uintptr_t
+#include <type_traits>	// std::is_convertible
+
+#include "iterator.hpp"
+#include "algorithm.hpp"
+#include "utility.hpp"
+#include "type_traits.hpp"
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+# define FT_SWISS_SSE2 1
+#endif
+
+/*
+    The open addressing table behind unordered_map and unordered_set, in
+    the Swiss table family (Abseil's flat_hash_map, Boost's
+    unordered_flat_map, which this one is closest to).
+
+    The slots come in groups of 15. Each group has 16 control bytes, one per
+    slot and a last one of overflow bits. A control byte is 0 for an empty
+    slot, otherwise 0x80 and 7 bits of the hash, so one SSE2 compare finds
+    the few slots of a group worth comparing the key against. Groups are
+    probed quadratically, the rest of the hash picks the first one.
+
+    An insert that passes a full group sets one of the 8 overflow bits of
+    the group, picked by 3 more bits of the hash. A lookup stops at the
+    first group without its bit set, so erase can empty a slot without
+    leaving a tombstone. Bits are only reset by a rehash; an erase from a
+    group that has overflowed lowers the load limit instead, so the next
+    rehash comes sooner and the probes stay short.
+
+    The last slot of the last group is a sentinel that is never filled, the
+    iterators stop on it. Without SSE2 the group is scanned byte by byte.
+*/
+
+namespace ft {
+
+	struct swiss_group
+	{
+		static const unsigned	slots = 15;
+		static const unsigned	slot_mask = 0x7FFF;
+
+		static const unsigned char	empty = 0;
+		static const unsigned char	sentinel = 1;
+
+		alignas(16) unsigned char	bytes[16];
+
+		unsigned char& overflow() { return bytes[15]; }
+
+		unsigned char overflow() const { return bytes[15]; }
+
+		/* bit i set if slot i holds control byte c */
+		unsigned match(unsigned char c) const
+		{
+#ifdef FT_SWISS_SSE2
+			const __m128i group = _mm_load_si128(reinterpret_cast<const __m128i*>(bytes));
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(c))))
+					& slot_mask;
+#else
+			return match_scalar(c);
+#endif
+		}
+
+		unsigned match_empty() const { return match(empty); }
+
+		/* the slots in use, and the sentinel */
+		unsigned match_used() const { return ~match_empty() & slot_mask; }
+
+		unsigned match_scalar(unsigned char c) const
+		{
+			unsigned mask = 0;
+
+			for (unsigned i = 0; i < slots; ++i)
+				if (bytes[i] == c)
+					mask |= 1u << i;
+			return mask;
+		}
+	};
+
+	template <typename Pair>
+	struct select_first
+	{
+		typedef typename Pair::first_type	result_type;
+
+		const result_type& operator()(const Pair& pair) const { return pair.first; }
+	};
+
+	template <typename T>
+	struct identity
+	{
+		typedef T	result_type;
+
+		const T& operator()(const T& value) const { return value; }
+	};
+
+
+	template <typename Value, typename Pointer, typename Reference>
+	class swiss_iterator
+	{
+		public:
+			typedef forward_iterator_tag		iterator_category;
+			typedef Value						value_type;
+			typedef Reference					reference;
+			typedef Pointer						pointer;
+			typedef ptrdiff_t					difference_type;
+
+		private:
+			const unsigned char*	ctrl_;
+			Value*					slot_;
+
+		public:
+			swiss_iterator() : ctrl_(NULL), slot_(NULL)
+			{}
+
+			swiss_iterator(const unsigned char* ctrl, Value* slot) : ctrl_(ctrl), slot_(slot)
+			{}
+
+			/* iterator to const_iterator, not the other way */
+			template <typename P, typename R>
+			swiss_iterator(const swiss_iterator<Value, P, R>& other,
+							typename ft::enable_if<std::is_convertible<P, Pointer>::value>::type* = 0)
+				: ctrl_(other.ctrl()), slot_(other.slot())
+			{}
+
+			const unsigned char* ctrl() const { return ctrl_; }
+
+			Value* slot() const { return slot_; }
+
+			reference operator*() const { return *slot_; }
+
+			pointer operator->() const { return slot_; }
+
+			swiss_iterator& operator++()
+			{
+				++ctrl_;
+				++slot_;
+				skip_empty();
+				return *this;
+			}
+
+			swiss_iterator operator++(int)
+			{
+				swiss_iterator tmp = *this;
+				++(*this);
+				return tmp;
+			}
+
+			/* moves on to the first slot in use from here, a group at a
+				time. the overflow byte is never in the mask, passing it
+				moves the control pointer but not the slot */
+			void skip_empty()
+			{
+				for (;;)
+				{
+					const unsigned offset = reinterpret_cast<uintptr_t>(ctrl_) & 15;
+					const swiss_group* group = reinterpret_cast<const swiss_group*>(ctrl_ - offset);
+					const unsigned mask = group->match_used() >> offset;
+					if (mask != 0)
+					{
+						const unsigned n = __builtin_ctz(mask);
+						ctrl_ += n;
+						slot_ += n;
+						return;
+					}
+					ctrl_ += 16 - offset;
+					slot_ += swiss_group::slots - offset;
+				}
+			}
+	};
+
+	template <typename Value, typename P1, typename R1, typename P2, typename R2>
+	bool operator==(const swiss_iterator<Value, P1, R1>& lhs, const swiss_iterator<Value, P2, R2>& rhs)
+	{
+		return lhs.ctrl() == rhs.ctrl();
+	}
+
+	template <typename Value, typename P1, typename R1, typename P2, typename R2>
+	bool operator!=(const swiss_iterator<Value, P1, R1>& lhs, const swiss_iterator<Value, P2, R2>& rhs)
+	{
+		return lhs.ctrl() != rhs.ctrl();
+	}
+
+
+	template <typename Value, typename Key, typename KeyOfValue, typename Hash,
+				typename KeyEqual, typename Allocator>
+	class swiss_table
+	{
+		public:
+			typedef Key															key_type;
+			typedef Value														value_type;
+			typedef Hash														hasher;
+			typedef KeyEqual													key_equal;
+			typedef Allocator													allocator_type;
+			typedef typename allocator_type::size_type							size_type;
+			typedef typename allocator_type::difference_type					difference_type;
+			typedef swiss_iterator<value_type, value_type*, value_type&>		iterator;
+			typedef swiss_iterator<value_type, const value_type*,
+									const value_type&>							const_iterator;
+
+		private:
+			typedef typename allocator_type::template
+				rebind<swiss_group>::other										group_allocator_type;
+
+			swiss_group*			groups_;
+			value_type*				slots_;
+			/* 0 or a power of 2 */
+			size_type				group_count_;
+			size_type				size_;
+			/* a rehash once size_ would pass it */
+			size_type				max_load_;
+			hasher					hash_;
+			key_equal				eq_;
+			KeyOfValue				key_of_;
+			allocator_type			alloc_;
+			group_allocator_type	group_alloc_;
+
+		public:
+			explicit swiss_table(size_type n = 0, const Hash& hash = Hash(),
+									const KeyEqual& eq = KeyEqual(), const Allocator& alloc = Allocator())
+				: groups_(NULL), slots_(NULL), group_count_(0), size_(0), max_load_(0),
+				hash_(hash), eq_(eq), alloc_(alloc), group_alloc_(alloc)
+			{
+				if (n != 0)
+					rehash_(groups_for_(n));
+			}
+
+			swiss_table(const swiss_table& other)
+				: groups_(NULL), slots_(NULL), group_count_(0), size_(0), max_load_(0),
+				hash_(other.hash_), eq_(other.eq_), alloc_(other.alloc_), group_alloc_(other.group_alloc_)
+			{
+				if (other.size_ == 0)
+					return;
+				allocate_(groups_for_(other.size_));
+				try {
+					for (const_iterator it = other.begin(); it != other.end(); ++it)
+					{
+						place_(hash_of_(key_of_(*it)), *it);
+					}
+				} catch (...) {
+					clear();
+					deallocate_();
+					throw;
+				}
+			}
+
+			~swiss_table()
+			{
+				clear();
+				deallocate_();
+			}
+
+			swiss_table& operator=(const swiss_table& other)
+			{
+				if (this != &other)
+				{
+					swiss_table tmp(other);
+					swap(tmp);
+				}
+				return *this;
+			}
+
+			iterator begin()
+			{
+				if (group_count_ == 0)
+					return end();
+				iterator it(groups_[0].bytes, slots_);
+				it.skip_empty();
+				return it;
+			}
+
+			const_iterator begin() const { return const_cast<swiss_table*>(this)->begin(); }
+
+			iterator end()
+			{
+				if (group_count_ == 0)
+					return iterator();
+				return iterator(&groups_[group_count_ - 1].bytes[swiss_group::slots - 1],
+								slots_ + group_count_ * swiss_group::slots - 1);
+			}
+
+			const_iterator end() const { return const_cast<swiss_table*>(this)->end(); }
+
+			bool empty() const { return size_ == 0; }
+
+			size_type size() const { return size_; }
+
+			size_type max_size() const { return alloc_.max_size(); }
+
+			/* the key of val is looked for first, then val copied in */
+			ft::pair<iterator, bool> insert(const value_type& val)
+			{
+				const key_type&		key = key_of_(val);
+				const size_t		hash = hash_of_(key);
+				iterator			it = find_(key, hash);
+
+				if (it != end())
+					return ft::make_pair(it, false);
+				if (size_ + 1 > max_load_)
+					rehash_(groups_for_(size_ + 1));
+				return ft::make_pair(place_(hash, val), true);
+			}
+
+			/* returns the iterator after position */
+			iterator erase(const_iterator position)
+			{
+				iterator next(position.ctrl(), position.slot());
+
+				++next;
+				erase_(position);
+				return next;
+			}
+
+			size_type erase(const key_type& key)
+			{
+				const_iterator it = find(key);
+
+				if (it == end())
+					return 0;
+				erase_(it);
+				return 1;
+			}
+
+			void clear()
+			{
+				if (group_count_ == 0)
+					return;
+				for (iterator it = begin(); it != end(); ++it)
+					alloc_.destroy(&*it);
+				reset_controls_();
+				size_ = 0;
+			}
+
+			void swap(swiss_table& other)
+			{
+				ft::swap(groups_, other.groups_);
+				ft::swap(slots_, other.slots_);
+				ft::swap(group_count_, other.group_count_);
+				ft::swap(size_, other.size_);
+				ft::swap(max_load_, other.max_load_);
+				ft::swap(hash_, other.hash_);
+				ft::swap(eq_, other.eq_);
+				ft::swap(alloc_, other.alloc_);
+				ft::swap(group_alloc_, other.group_alloc_);
+			}
+
+			iterator find(const key_type& key) { return find_(key, hash_of_(key)); }
+
+			const_iterator find(const key_type& key) const
+			{
+				return const_cast<swiss_table*>(this)->find_(key, hash_of_(key));
+			}
+
+			size_type count(const key_type& key) const { return (find(key) != end()) ? 1 : 0; }
+
+			/* the slots, without the sentinel */
+			size_type bucket_count() const
+			{
+				return (group_count_ != 0) ? group_count_ * swiss_group::slots - 1 : 0;
+			}
+
+			float load_factor() const
+			{
+				return (group_count_ != 0) ? float(size_) / bucket_count() : 0.0f;
+			}
+
+			float max_load_factor() const { return 0.875f; }
+
+			/* room for n elements at least, more if they're there already */
+			void rehash(size_type n)
+			{
+				const size_type groups = groups_for_(ft::max(n, size_));
+
+				if (groups != group_count_ || groups_ == NULL)
+					rehash_(groups);
+			}
+
+			void reserve(size_type n)
+			{
+				if (n > max_load_)
+					rehash_(groups_for_(n));
+			}
+
+			hasher hash_function() const { return hash_; }
+
+			key_equal key_eq() const { return eq_; }
+
+			allocator_type get_allocator() const { return alloc_; }
+
+		private:
+			/* std::hash is the identity for integers, the multiply spreads
+				them and the shift brings the high bits down to the control
+				byte */
+			size_t hash_of_(const key_type& key) const
+			{
+				unsigned long long h = hash_(key);
+
+				h *= 0x9E3779B97F4A7C15ULL;
+				return static_cast<size_t>(h ^ (h >> 32));
+			}
+
+			static unsigned char control_of_(size_t hash) { return 0x80 | (hash & 0x7F); }
+
+			static unsigned char overflow_bit_of_(size_t hash) { return 1 << ((hash >> 7) & 7); }
+
+			size_t first_group_(size_t hash) const { return (hash >> 12) & (group_count_ - 1); }
+
+			/* a power of 2 with a load limit of n at least */
+			static size_type groups_for_(size_type n)
+			{
+				size_type groups = 1;
+
+				while (load_limit_(groups) < n)
+					groups *= 2;
+				return groups;
+			}
+
+			static size_type load_limit_(size_type groups)
+			{
+				return (groups * swiss_group::slots - 1) * 7 / 8;
+			}
+
+			iterator find_(const key_type& key, size_t hash)
+			{
+				if (group_count_ == 0)
+					return end();
+
+				const unsigned char		control = control_of_(hash);
+				const unsigned char		overflow = overflow_bit_of_(hash);
+				size_t					pos = first_group_(hash);
+
+				for (size_t step = 0; step < group_count_; )
+				{
+					const swiss_group&	group = groups_[pos];
+					value_type*			slots = slots_ + pos * swiss_group::slots;
+
+					for (unsigned mask = group.match(control); mask != 0; mask &= mask - 1)
+					{
+						const unsigned i = __builtin_ctz(mask);
+						if (eq_(key, key_of_(slots[i])))
+							return iterator(&group.bytes[i], slots + i);
+					}
+					if (!(group.overflow() & overflow))
+						break;
+					pos = (pos + ++step) & (group_count_ - 1);
+				}
+				return end();
+			}
+
+			/* puts val into the first empty slot of its probe sequence, the
+				key is known not to be there and there is room */
+			iterator place_(size_t hash, const value_type& val)
+			{
+				iterator it = place_slot_(hash);
+
+				try {
+					alloc_.construct(it.slot(), val);
+				} catch (...) {
+					*const_cast<unsigned char*>(it.ctrl()) = swiss_group::empty;
+					--size_;
+					throw;
+				}
+				return it;
+			}
+
+			void erase_(const_iterator position)
+			{
+				const size_t		offset = reinterpret_cast<uintptr_t>(position.ctrl()) & 15;
+				swiss_group&		group = *reinterpret_cast<swiss_group*>(
+											const_cast<unsigned char*>(position.ctrl() - offset));
+
+				alloc_.destroy(position.slot());
+				group.bytes[offset] = swiss_group::empty;
+				--size_;
+				if (group.overflow() != 0 && max_load_ > 0)
+					--max_load_;
+			}
+
+			void reset_controls_()
+			{
+				std::memset(static_cast<void*>(groups_), 0, group_count_ * sizeof(swiss_group));
+				groups_[group_count_ - 1].bytes[swiss_group::slots - 1] = swiss_group::sentinel;
+				max_load_ = load_limit_(group_count_);
+			}
+
+			void allocate_(size_type groups)
+			{
+				groups_ = group_alloc_.allocate(groups);
+				try {
+					slots_ = alloc_.allocate(groups * swiss_group::slots);
+				} catch (...) {
+					group_alloc_.deallocate(groups_, groups);
+					groups_ = NULL;
+					throw;
+				}
+				group_count_ = groups;
+				reset_controls_();
+			}
+
+			void deallocate_()
+			{
+				if (group_count_ == 0)
+					return;
+				alloc_.deallocate(slots_, group_count_ * swiss_group::slots);
+				group_alloc_.deallocate(groups_, group_count_);
+				groups_ = NULL;
+				slots_ = NULL;
+				group_count_ = 0;
+				max_load_ = 0;
+			}
+
+			/* moves everything into a table of the given size. strong
+				guarantee, a copy that throws leaves the old table alone */
+			void rehash_(size_type groups)
+			{
+				swiss_table	tmp(0, hash_, eq_, alloc_);
+				typename is_trivially_relocatable<value_type>::type relocatable;
+
+				tmp.allocate_(groups);
+				move_into_(tmp, relocatable);
+				swap(tmp);
+			}
+
+			void move_into_(swiss_table& to, true_type)
+			{
+				for (iterator it = begin(); it != end(); ++it)
+				{
+					const size_t	hash = hash_of_(key_of_(*it));
+					iterator		slot = to.place_slot_(hash);
+					std::memcpy(static_cast<void*>(slot.slot()), static_cast<const void*>(&*it),
+								sizeof(value_type));
+				}
+				/* the values are in to now, nothing is left to destroy */
+				if (group_count_ != 0)
+					reset_controls_();
+				size_ = 0;
+			}
+
+			void move_into_(swiss_table& to, false_type)
+			{
+				for (iterator it = begin(); it != end(); ++it)
+					to.place_(hash_of_(key_of_(*it)), *it);
+			}
+
+			/* claims the slot, the value is up to the caller */
+			iterator place_slot_(size_t hash)
+			{
+				size_t pos = first_group_(hash);
+
+				for (size_t step = 0; ; )
+				{
+					swiss_group&	group = groups_[pos];
+					const unsigned	mask = group.match_empty();
+					if (mask != 0)
+					{
+						const unsigned i = __builtin_ctz(mask);
+						group.bytes[i] = control_of_(hash);
+						++size_;
+						return iterator(&group.bytes[i], slots_ + pos * swiss_group::slots + i);
+					}
+					group.overflow() |= overflow_bit_of_(hash);
+					pos = (pos + ++step) & (group_count_ - 1);
+				}
+			}
+	};
+
+} // namespace ft
+
+#endif // SWISS_TABLE_HPP
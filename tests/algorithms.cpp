@@ -113,3 +113,94 @@ TEST(algorithms, lexicographical_compare)
                                           s1.begin(), s1.end()));
 }       
 
+
+
+/* counts how often it is compared, either way */
+struct counted
+{
+    static int  less_calls;
+    static int  compare_calls;
+
+    int         value;
+
+    counted(int v) : value(v) {}
+
+    bool operator<(const counted& rhs) const
+    {
+        ++less_calls;
+        return value < rhs.value;
+    }
+
+    int compare(const counted& rhs) const
+    {
+        ++compare_calls;
+        return value - rhs.value;
+    }
+};
+
+int counted::less_calls = 0;
+int counted::compare_calls = 0;
+
+/* a compare() that means something else, it must not be taken for a
+    three-way comparison */
+struct version
+{
+    int         value;
+
+    version(int v) : value(v) {}
+
+    bool operator<(const version& rhs) const { return value < rhs.value; }
+
+    bool compare(const version& rhs) const { return value == rhs.value; }
+};
+
+
+TEST(algorithms, compare_3way)
+{
+    EXPECT_TRUE(ft::has_compare_member<std::string>::value);
+    EXPECT_FALSE(ft::has_compare_member<int>::value);
+    EXPECT_TRUE(ft::has_compare_member<counted>::value);
+    EXPECT_FALSE(ft::has_compare_member<version>::value);
+
+    EXPECT_LT(ft::compare_3way(1, 2), 0);
+    EXPECT_EQ(ft::compare_3way(2, 2), 0);
+    EXPECT_GT(ft::compare_3way(std::string("b"), std::string("a")), 0);
+    EXPECT_LT(ft::compare_3way(std::greater<int>(), 2, 1), 0);
+    EXPECT_LT(ft::compare_3way(std::less<std::string>(), std::string("a"), std::string("b")), 0);
+
+    /* equal elements used to cost two comparisons each */
+    std::vector<counted> v1;
+    std::vector<counted> v2;
+    for (int i = 0; i < 10; ++i)
+    {
+        v1.push_back(counted(i));
+        v2.push_back(counted(i));
+    }
+    v2.back().value = 42;
+
+    counted::less_calls = 0;
+    counted::compare_calls = 0;
+    EXPECT_TRUE(ft::lexicographical_compare(v1.begin(), v1.end(), v2.begin(), v2.end()));
+    EXPECT_EQ(counted::less_calls, 0);
+    EXPECT_EQ(counted::compare_calls, 10);
+
+    counted::compare_calls = 0;
+    EXPECT_FALSE(ft::lexicographical_compare(v2.begin(), v2.end(), v1.begin(), v1.end(),
+                                             std::less<counted>()));
+    EXPECT_EQ(counted::less_calls, 0);
+    EXPECT_EQ(counted::compare_calls, 10);
+
+    std::vector<version> w1(1, version(1));
+    std::vector<version> w2(1, version(2));
+    EXPECT_TRUE(ft::lexicographical_compare(w1.begin(), w1.end(), w2.begin(), w2.end()));
+    EXPECT_FALSE(ft::lexicographical_compare(w2.begin(), w2.end(), w1.begin(), w1.end()));
+    EXPECT_LT(ft::compare_3way(version(1), version(2)), 0);
+
+    /* any other comparator is still asked in both directions */
+    std::vector<int> i1(5, 1);
+    std::vector<int> i2(5, 1);
+    int calls = 0;
+    EXPECT_FALSE(ft::lexicographical_compare(i1.begin(), i1.end(), i2.begin(), i2.end(),
+                 [&](int a, int b) { ++calls; return a < b; }));
+    EXPECT_EQ(calls, 10);
+}
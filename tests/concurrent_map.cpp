@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+
+#include "../concurrent_map.hpp"
+
+#define VOLUME 1000
+
+typedef ft::concurrent_map<int, int>    cmap;
+
+
+TEST(concurrent_map, single_thread)
+{
+    cmap                m1;
+    std::map<int, int>  m2;
+
+    std::srand(11);
+    for (int i = 0; i < 8 * VOLUME; ++i)
+    {
+        const int key = std::rand() % VOLUME;
+        if (std::rand() % 2)
+        {
+            ft::pair<cmap::iterator, bool> res = m1.insert(ft::make_pair(key, i));
+            EXPECT_EQ(res.second, m2.insert(std::make_pair(key, i)).second);
+            EXPECT_EQ(res.first->second, m2[key]);
+        }
+        else
+        {
+            EXPECT_EQ(m1.erase(key), m2.erase(key));
+        }
+    }
+    EXPECT_EQ(m1.size(), m2.size());
+    EXPECT_TRUE(std::equal(m2.begin(), m2.end(), m1.begin(),
+        [](const std::pair<const int, int>& a, const ft::pair<const int, int>& b) {
+            return a.first == b.first && a.second == b.second;
+        }));
+
+    for (int key = -1; key <= VOLUME; ++key)
+    {
+        EXPECT_EQ(m1.count(key), m2.count(key));
+        EXPECT_EQ(std::distance(m1.begin(), m1.lower_bound(key)),
+                  std::distance(m2.begin(), m2.lower_bound(key)));
+        EXPECT_EQ(std::distance(m1.begin(), m1.upper_bound(key)),
+                  std::distance(m2.begin(), m2.upper_bound(key)));
+        if (m2.count(key))
+        {
+            EXPECT_EQ(m1.find(key)->second, m2[key]);
+        }
+        else
+        {
+            EXPECT_TRUE(m1.find(key) == m1.end());
+        }
+    }
+
+    cmap m3(m1);
+    EXPECT_EQ(m3.size(), m1.size());
+    m1.clear();
+    EXPECT_TRUE(m1.empty());
+    EXPECT_TRUE(m1.begin() == m1.end());
+    m1 = m3;
+    EXPECT_EQ(m1.size(), m2.size());
+}
+
+TEST(concurrent_map, many_threads)
+{
+    const int           threads = 8;
+    cmap                m1;
+    std::atomic<bool>   done(false);
+    std::atomic<int>    errors(0);
+
+    // a reader walks the map the whole time, order must hold throughout
+    std::thread reader([&]() {
+        while (!done)
+        {
+            int last = -5;
+            for (cmap::const_iterator it = m1.begin(); it != m1.end(); ++it)
+            {
+                if (it->first <= last || it->second != it->first)
+                    ++errors;
+                last = it->first;
+            }
+        }
+    });
+
+    // every thread owns the keys equal to its index mod threads: inserts
+    // them all, erases the odd ones, reinserts some and erases again
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t)
+        writers.push_back(std::thread([&, t]() {
+            for (int key = t; key < 10 * VOLUME; key += threads)
+                if (!m1.insert(ft::make_pair(key, key)).second)
+                    ++errors;
+            for (int round = 0; round < 3; ++round)
+            {
+                for (int key = t; key < 10 * VOLUME; key += threads)
+                    if (key % 2 && m1.erase(key) != 1)
+                        ++errors;
+                for (int key = t; key < 10 * VOLUME; key += threads)
+                    if (key % 2 && !m1.insert(ft::make_pair(key, key)).second)
+                        ++errors;
+            }
+            for (int key = t; key < 10 * VOLUME; key += threads)
+                if (key % 2 && m1.erase(key) != 1)
+                    ++errors;
+        }));
+
+    // and everyone fights over the same few keys
+    std::vector<std::thread> racers;
+    std::atomic<int> balance(0);
+    for (int t = 0; t < 4; ++t)
+        racers.push_back(std::thread([&, t]() {
+            for (int i = 0; i < 4 * VOLUME; ++i)
+            {
+                const int key = -1 - (i + t) % 4;
+                if ((i + t) % 2)
+                    balance += m1.insert(ft::make_pair(key, key)).second;
+                else
+                    balance -= static_cast<int>(m1.erase(key));
+            }
+        }));
+
+    for (size_t t = 0; t < writers.size(); ++t)
+        writers[t].join();
+    for (size_t t = 0; t < racers.size(); ++t)
+        racers[t].join();
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(errors, 0);
+    int contested = 0;
+    for (int key = -4; key < 0; ++key)
+        contested += m1.count(key);
+    EXPECT_EQ(contested, balance);
+    EXPECT_EQ(m1.size(), static_cast<size_t>(5 * VOLUME + contested));
+    for (int key = 0; key < 10 * VOLUME; ++key)
+        EXPECT_EQ(m1.count(key), static_cast<size_t>(key % 2 == 0));
+}
+
+TEST(concurrent_map, insert_erase_race)
+{
+    const int           threads = 4;
+    const int           keys = 8;
+    cmap                m1;
+    std::atomic<bool>   done(false);
+    std::atomic<int>    errors(0);
+
+    // few keys, so inserts still linking the upper levels of a node meet
+    // the erases of the same node. a node erased too early is freed while
+    // the others can reach it (run with -fsanitize=address)
+    std::thread reader([&]() {
+        while (!done)
+        {
+            int last = -1;
+            for (cmap::const_iterator it = m1.begin(); it != m1.end(); ++it)
+            {
+                if (it->first <= last || it->second != it->first)
+                    ++errors;
+                last = it->first;
+            }
+            for (int key = 0; key < keys; ++key)
+            {
+                cmap::const_iterator it = m1.find(key);
+                if (it != m1.end() && it->first != key)
+                    ++errors;
+            }
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t)
+        writers.push_back(std::thread([&, t]() {
+            for (int i = 0; i < 10 * VOLUME; ++i)
+            {
+                const int key = (i + t) % keys;
+                if ((i / keys + t) % 2)
+                    m1.insert(ft::make_pair(key, key));
+                else
+                    m1.erase(key);
+            }
+        }));
+    for (size_t t = 0; t < writers.size(); ++t)
+        writers[t].join();
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(errors, 0);
+    EXPECT_EQ(static_cast<size_t>(std::distance(m1.begin(), m1.end())), m1.size());
+    for (int key = 0; key < keys; ++key)
+        m1.erase(key);
+    EXPECT_TRUE(m1.empty());
+    EXPECT_TRUE(m1.begin() == m1.end());
+}
+
+TEST(concurrent_map, many_iterators)
+{
+    cmap                        m1;
+    std::vector<cmap::iterator> its;
+
+    for (int key = 0; key < VOLUME; ++key)
+        m1.insert(ft::make_pair(key, key));
+
+    // many times the slots of the epoch domain, on one thread
+    for (int key = 0; key < VOLUME; ++key)
+        its.push_back(m1.find(key));
+    std::vector<cmap::iterator> copies(its);
+    for (int key = 0; key < VOLUME; ++key)
+        m1.erase(key);
+    EXPECT_TRUE(m1.empty());
+    for (int key = 0; key < VOLUME; ++key)
+    {
+        ASSERT_EQ(its[key]->second, key);
+        ASSERT_EQ(copies[key]->first, key);
+    }
+
+    // and let go of on another one
+    std::thread other([&]() {
+        its.clear();
+        for (int key = 0; key < VOLUME; ++key)
+            m1.insert(ft::make_pair(key, -key));
+    });
+    other.join();
+    copies.clear();
+
+    for (int key = 0; key < VOLUME; ++key)
+        its.push_back(m1.find(key));
+    for (int key = 0; key < VOLUME; ++key)
+        ASSERT_EQ(its[key]->second, -key);
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include <unordered_map>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+#include "../concurrent_unordered_map.hpp"
+
+#define VOLUME 1000
+
+typedef ft::concurrent_unordered_map<int, long>     cmap;
+
+struct increment
+{
+    void operator()(long& obj) const { ++obj; }
+};
+
+/* the stripe a key locks, picked like the map does */
+static size_t stripe_of(int key)
+{
+    unsigned long long h = std::hash<int>()(key);
+
+    h *= 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(h ^ (h >> 32)) >> (8 * sizeof(size_t) - 6);
+}
+
+
+TEST(concurrent_unordered_map, single_thread)
+{
+    cmap                            m1;
+    std::unordered_map<int, long>   m2;
+
+    std::srand(13);
+    for (int i = 0; i < 30 * VOLUME; ++i)
+    {
+        const int key = std::rand() % (4 * VOLUME);
+        switch (std::rand() % 3)
+        {
+            case 0:
+                EXPECT_EQ(m1.insert(ft::make_pair(key, long(i))),
+                          m2.insert(std::make_pair(key, long(i))).second);
+                break;
+            case 1:
+                EXPECT_EQ(m1.erase(key), m2.erase(key));
+                break;
+            default:
+                EXPECT_EQ(m1.insert_or_assign(key, i), m2.count(key) == 0);
+                m2[key] = i;
+        }
+    }
+    EXPECT_EQ(m1.size(), m2.size());
+
+    for (int key = -1; key <= 4 * VOLUME; ++key)
+    {
+        long obj = -1;
+        EXPECT_EQ(m1.count(key), m2.count(key));
+        EXPECT_EQ(m1.find(key, obj), m2.count(key) == 1);
+        if (m2.count(key))
+        {
+            EXPECT_EQ(obj, m2[key]);
+            EXPECT_EQ(m1.at(key), m2[key]);
+        }
+        else
+        {
+            EXPECT_THROW(m1.at(key), std::out_of_range);
+        }
+    }
+
+    size_t visited = 0;
+    m1.for_each([&](const int& key, const long& obj) {
+        ++visited;
+        EXPECT_EQ(m2.at(key), obj);
+    });
+    EXPECT_EQ(visited, m2.size());
+
+    const int key = m2.begin()->first;
+    EXPECT_TRUE(m1.update(key, increment()));
+    EXPECT_EQ(m1.at(key), m2[key] + 1);
+    EXPECT_FALSE(m1.update(-1, increment()));
+
+    m1.clear();
+    EXPECT_TRUE(m1.empty());
+    EXPECT_EQ(m1.count(key), 0u);
+}
+
+TEST(concurrent_unordered_map, many_threads)
+{
+    const int           threads = 8;
+    cmap                m1;
+    std::atomic<bool>   done(false);
+    std::atomic<int>    errors(0);
+
+    // keys below VOLUME stay put with their value, readers must always
+    // find them, through every resize the writers cause
+    for (int key = 0; key < VOLUME; ++key)
+        m1.insert(ft::make_pair(key, long(key)));
+    // every writer bumps the same counters
+    for (int i = 0; i < 4; ++i)
+        m1.insert(ft::make_pair(-1 - i, 0L));
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r)
+        readers.push_back(std::thread([&]() {
+            while (!done)
+                for (int key = 0; key < VOLUME; ++key)
+                {
+                    long obj = -1;
+                    if (!m1.find(key, obj) || obj != key)
+                        ++errors;
+                }
+        }));
+
+    std::thread scanner([&]() {
+        while (!done)
+        {
+            size_t stable = 0;
+            m1.for_each([&](const int& key, const long&) { stable += (key >= 0 && key < VOLUME); });
+            if (stable != static_cast<size_t>(VOLUME))
+                ++errors;
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t)
+        writers.push_back(std::thread([&, t]() {
+            for (int key = VOLUME + t; key < 20 * VOLUME; key += threads)
+                if (!m1.insert(ft::make_pair(key, long(key))))
+                    ++errors;
+            for (int key = VOLUME + t; key < 20 * VOLUME; key += threads)
+                if (key % 2 && m1.erase(key) != 1)
+                    ++errors;
+            for (int key = VOLUME + t; key < 20 * VOLUME; key += threads)
+                if (m1.insert_or_assign(key, -key) != (key % 2 == 1))
+                    ++errors;
+            for (int i = 0; i < VOLUME; ++i)
+                m1.update(-1 - i % 4, increment());
+        }));
+    for (size_t t = 0; t < writers.size(); ++t)
+        writers[t].join();
+    done = true;
+    for (size_t r = 0; r < readers.size(); ++r)
+        readers[r].join();
+    scanner.join();
+
+    EXPECT_EQ(errors, 0);
+    EXPECT_EQ(m1.size(), static_cast<size_t>(20 * VOLUME + 4));
+    long counted = 0;
+    for (int i = 0; i < 4; ++i)
+        counted += m1.at(-1 - i);
+    EXPECT_EQ(counted, threads * VOLUME);
+    for (int key = VOLUME; key < 20 * VOLUME; ++key)
+        EXPECT_EQ(m1.at(key), -key);
+}
+
+TEST(concurrent_unordered_map, stalled_resize)
+{
+    cmap                m1;
+    const int           held = 0;
+    std::atomic<int>    state(0);
+    bool                timed_out = false;
+    std::vector<int>    keys;
+
+    // none of them shares the stripe of held
+    for (int key = 1; keys.size() < static_cast<size_t>(10 * VOLUME); ++key)
+        if (stripe_of(key) != stripe_of(held))
+            keys.push_back(key);
+
+    // 12 of the 16 slots
+    m1.insert(ft::make_pair(held, 0L));
+    for (int i = 0; i < 11; ++i)
+        m1.insert(ft::make_pair(keys[i], long(keys[i])));
+
+    // holds the stripe of held until the inserts below are done
+    std::thread holder([&]() {
+        m1.update(held, [&](long& obj) {
+            const std::chrono::steady_clock::time_point deadline
+                = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            state = 1;
+            while (state != 2 && !timed_out)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                timed_out = std::chrono::steady_clock::now() > deadline;
+            }
+            ++obj;
+        });
+    });
+    while (state != 1)
+        std::this_thread::yield();
+
+    // the 13th hangs a new table, the next writer takes the only chunk of
+    // the old one and stalls at the slot of held
+    m1.insert(ft::make_pair(keys[11], long(keys[11])));
+    std::thread mover([&]() { m1.insert(ft::make_pair(keys[12], long(keys[12]))); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // many times what the new table takes, while the move stands still
+    for (size_t i = 13; i < keys.size(); ++i)
+        m1.insert(ft::make_pair(keys[i], long(keys[i])));
+    for (size_t i = 0; i < keys.size(); i += VOLUME / 10)
+        EXPECT_EQ(m1.at(keys[i]), keys[i]);
+    state = 2;
+    holder.join();
+    mover.join();
+
+    EXPECT_FALSE(timed_out);
+    EXPECT_EQ(m1.size(), keys.size() + 1);
+    EXPECT_EQ(m1.at(held), 1);
+    size_t visited = 0;
+    m1.for_each([&](const int&, const long&) { ++visited; });
+    EXPECT_EQ(visited, keys.size() + 1);
+    for (size_t i = 0; i < keys.size(); ++i)
+        ASSERT_EQ(m1.at(keys[i]), keys[i]);
+}
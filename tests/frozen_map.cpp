@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <cstdlib>
+
+#include "../frozen_map.hpp"
+
+#define VOLUME 1000
+
+
+TEST(frozen_map, lookup)
+{
+    ft::map<int, int>   m1;
+    std::map<int, int>  m2;
+
+    // every size from empty to a few full levels and partial ones
+    for (int n = 0; n < 70; ++n)
+    {
+        ft::frozen_map<int, int> f1(m1);
+        EXPECT_EQ(f1.size(), m1.size());
+        EXPECT_TRUE(ft::equal(f1.begin(), f1.end(), m1.begin()));
+        for (int key = -1; key <= 2 * n + 1; ++key)
+        {
+            EXPECT_EQ(f1.lower_bound(key) - f1.begin(),
+                      std::distance(m2.begin(), m2.lower_bound(key)));
+            EXPECT_EQ(f1.upper_bound(key) - f1.begin(),
+                      std::distance(m2.begin(), m2.upper_bound(key)));
+            EXPECT_EQ(f1.count(key), m2.count(key));
+            if (m2.count(key))
+            {
+                EXPECT_EQ(f1.find(key)->second, m2[key]);
+            }
+            else
+            {
+                EXPECT_TRUE(f1.find(key) == f1.end());
+            }
+        }
+        m1[2 * n] = n;
+        m2[2 * n] = n;
+    }
+}
+
+TEST(frozen_map, access)
+{
+    ft::map<std::string, int> m1;
+    for (int i = 0; i < VOLUME; ++i)
+        m1[std::to_string(std::rand() % (VOLUME * 2))] = i;
+
+    const ft::frozen_map<std::string, int> f1(m1);
+    EXPECT_EQ(f1.size(), m1.size());
+    EXPECT_TRUE(ft::equal(f1.begin(), f1.end(), m1.begin()));
+    for (ft::map<std::string, int>::iterator it = m1.begin(); it != m1.end(); ++it)
+        EXPECT_EQ(f1.at(it->first), it->second);
+    EXPECT_THROW(f1.at("x"), std::out_of_range);
+    EXPECT_EQ(f1.rbegin()->first, m1.rbegin()->first);
+
+    ft::pair<ft::frozen_map<std::string, int>::const_iterator,
+             ft::frozen_map<std::string, int>::const_iterator> range = f1.equal_range("1");
+    EXPECT_EQ(range.second - range.first, int(m1.count("1")));
+
+    // the mapped values stay writable, the map the copy came from doesn't change
+    ft::frozen_map<std::string, int> f2(f1);
+    EXPECT_TRUE(f2 == f1);
+    f2.begin()->second = -1;
+    EXPECT_TRUE(f2 != f1);
+    EXPECT_TRUE(f2 < f1);
+    EXPECT_NE(m1.begin()->second, -1);
+
+    ft::frozen_map<std::string, int> f3;
+    EXPECT_TRUE(f3.empty());
+    EXPECT_TRUE(f3.find("1") == f3.end());
+    f3 = f2;
+    EXPECT_TRUE(f3 == f2);
+    ft::swap(f3, f2);
+    EXPECT_TRUE(f3 == f2);
+    f3 = ft::frozen_map<std::string, int>();
+    EXPECT_TRUE(f3.lower_bound("1") == f3.end());
+}
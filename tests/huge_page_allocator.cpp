@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+#include "../huge_page_allocator.hpp"
+#include "../vector.hpp"
+
+#define VOLUME 1000
+
+
+TEST(huge_page_allocator, blocks)
+{
+    ft::huge_page_allocator<int> alloc;
+    const size_t huge = ft::huge_page_allocator<int>::huge_page_size;
+
+    // below the threshold, operator new
+    int* small = alloc.allocate(VOLUME);
+    small[VOLUME - 1] = 1;
+    alloc.deallocate(small, VOLUME);
+
+    // above, aligned to the huge page and writable to the end
+    const size_t n = huge;
+    int* big = alloc.allocate(n);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(big) % huge, 0);
+    big[0] = 1;
+    big[n - 1] = 2;
+    EXPECT_EQ(big[0] + big[n - 1], 3);
+    alloc.deallocate(big, n);
+
+    // MAP_HUGETLB falls back when the pool is empty
+    ft::huge_page_allocator<int, 1 << 21, true> tlb;
+    int* pooled = tlb.allocate(n);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pooled) % huge, 0);
+    pooled[n - 1] = 4;
+    EXPECT_EQ(pooled[n - 1], 4);
+    tlb.deallocate(pooled, n);
+
+    EXPECT_THROW(alloc.allocate(alloc.max_size() + 1), std::bad_alloc);
+}
+
+TEST(huge_page_allocator, vector)
+{
+    ft::vector<uint64_t, ft::huge_page_allocator<uint64_t> > v1;
+
+    for (uint64_t i = 0; i < VOLUME * VOLUME; ++i)
+        v1.push_back(i);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(v1.data()) % (1 << 21), 0);
+    for (uint64_t i = 0; i < VOLUME * VOLUME; i += VOLUME - 1)
+        ASSERT_EQ(v1[i], i);
+
+    ft::vector<std::string, ft::huge_page_allocator<std::string, 4096> > v2(VOLUME, "string");
+    ft::vector<std::string, ft::huge_page_allocator<std::string, 4096> > v3(v2);
+    EXPECT_TRUE(v2 == v3);
+    EXPECT_TRUE(v2.get_allocator() == v3.get_allocator());
+
+    // rebinds for the std containers
+    std::vector<int, ft::huge_page_allocator<int> > s(VOLUME * VOLUME, 7);
+    EXPECT_EQ(s.back(), 7);
+}
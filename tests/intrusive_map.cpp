@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include "../intrusive_map.hpp"
+
+#define VOLUME 1000
+
+
+struct by_id {};
+struct by_name {};
+
+// one object, two maps
+struct order : ft::intrusive_hook<by_id>, ft::intrusive_hook<by_name>
+{
+    int             id;
+    std::string     name;
+};
+
+struct id_of
+{
+    const int& operator()(const order& o) const { return o.id; }
+};
+
+struct name_of
+{
+    const std::string& operator()(const order& o) const { return o.name; }
+};
+
+typedef ft::intrusive_map<int, order, id_of, std::less<int>, by_id>                     id_map;
+typedef ft::intrusive_map<std::string, order, name_of, std::less<std::string>, by_name> name_map;
+
+/* red-black properties through the hooks, -1 when broken */
+int black_height(const ft::rb_node_base* node)
+{
+    if (node == NULL)
+        return 1;
+    if ((node->left != NULL && node->left->parent != node)
+        || (node->right != NULL && node->right->parent != node))
+        return -1;
+    if (node->color == ft::RED && ((node->left != NULL && node->left->color == ft::RED)
+                                   || (node->right != NULL && node->right->color == ft::RED)))
+        return -1;
+
+    int left = black_height(node->left);
+    int right = black_height(node->right);
+    if (left < 0 || left != right)
+        return -1;
+    return left + (node->color == ft::BLACK);
+}
+
+template <typename Map>
+bool is_valid(Map& m)
+{
+    const ft::rb_node_base* root = m.end().base()->left;
+
+    return root == NULL || (root->color == ft::BLACK && black_height(root) > 0);
+}
+
+
+TEST(intrusive_map, random_ops)
+{
+    std::vector<order>      pool(VOLUME);
+    id_map                  m1;
+    std::map<int, order*>   m2;
+
+    for (int i = 0; i < VOLUME; ++i)
+        pool[i].id = i * 7 % VOLUME;
+
+    std::srand(46);
+    for (int i = 0; i < 20 * VOLUME; ++i)
+    {
+        order& obj = pool[std::rand() % VOLUME];
+        switch (std::rand() % 3)
+        {
+            case 0:
+                if (!static_cast<ft::intrusive_hook<by_id>&>(obj).is_linked())
+                {
+                    EXPECT_TRUE(m1.insert(obj).second);
+                    m2[obj.id] = &obj;
+                }
+                break;
+            case 1:
+                if (static_cast<ft::intrusive_hook<by_id>&>(obj).is_linked())
+                {
+                    // by address, no lookup
+                    m1.erase(obj);
+                    m2.erase(obj.id);
+                }
+                break;
+            default:
+                EXPECT_EQ(m1.erase(obj.id), m2.erase(obj.id));
+        }
+    }
+    EXPECT_EQ(m1.size(), m2.size());
+    EXPECT_TRUE(is_valid(m1));
+
+    std::map<int, order*>::iterator it2 = m2.begin();
+    for (id_map::iterator it = m1.begin(); it != m1.end(); ++it, ++it2)
+        EXPECT_EQ(&*it, it2->second);
+    for (int key = -1; key <= VOLUME; ++key)
+    {
+        EXPECT_EQ(m1.count(key), m2.count(key));
+        if (m2.count(key))
+        {
+            EXPECT_EQ(&*m1.find(key), m2[key]);
+            EXPECT_TRUE(m1.iterator_to(*m2[key]) == m1.find(key));
+        }
+        EXPECT_EQ(m1.lower_bound(key) == m1.end(), m2.lower_bound(key) == m2.end());
+    }
+
+    // an equivalent key is not linked a second time
+    order twin;
+    twin.id = m1.begin()->id;
+    EXPECT_FALSE(m1.insert(twin).second);
+    EXPECT_FALSE(static_cast<ft::intrusive_hook<by_id>&>(twin).is_linked());
+
+    id_map m3;
+    m3.swap(m1);
+    EXPECT_TRUE(m1.empty());
+    EXPECT_EQ(m3.size(), m2.size());
+    EXPECT_TRUE(is_valid(m3));
+    EXPECT_EQ((--m3.end())->id, m2.rbegin()->first);
+
+    m3.clear();
+    for (int i = 0; i < VOLUME; ++i)
+        EXPECT_FALSE(static_cast<ft::intrusive_hook<by_id>&>(pool[i]).is_linked());
+}
+
+TEST(intrusive_map, two_hooks)
+{
+    std::vector<order>  pool(VOLUME);
+    id_map              ids;
+    name_map            names;
+
+    for (int i = 0; i < VOLUME; ++i)
+    {
+        pool[i].id = VOLUME - i;
+        pool[i].name = std::to_string(i);
+        ids.insert(pool[i]);
+        names.insert(pool[i]);
+    }
+    EXPECT_EQ(ids.begin()->id, 1);
+    EXPECT_EQ(names.begin()->name, "0");
+
+    // leaving one map keeps the object in the other
+    for (int i = 0; i < VOLUME; i += 2)
+        ids.erase(pool[i]);
+    EXPECT_EQ(ids.size(), static_cast<size_t>(VOLUME / 2));
+    EXPECT_EQ(names.size(), static_cast<size_t>(VOLUME));
+    EXPECT_TRUE(is_valid(ids));
+    EXPECT_TRUE(is_valid(names));
+    for (name_map::const_iterator it = names.begin(); it != names.end(); ++it)
+        EXPECT_EQ(ids.count(it->id), static_cast<size_t>(std::stoi(it->name) % 2));
+
+    name_map::iterator it = names.find("10");
+    it = names.erase(it);
+    EXPECT_EQ(it->name, "100");
+    EXPECT_TRUE(names.find("10") == names.end());
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <cstdlib>
+
+#include "../lsm_map.hpp"
+
+#define VOLUME 1000
+
+typedef ft::lsm_map<int, int>   lmap;
+
+
+template <typename Map>
+void expect_same(const Map& m1, const std::map<int, int>& m2)
+{
+    typename Map::const_iterator it1 = m1.begin();
+    std::map<int, int>::const_iterator it2 = m2.begin();
+
+    for (; it1 != m1.end() && it2 != m2.end(); ++it1, ++it2)
+    {
+        EXPECT_EQ(it1->first, it2->first);
+        EXPECT_EQ(it1->second, it2->second);
+    }
+    EXPECT_TRUE(it1 == m1.end());
+    EXPECT_TRUE(it2 == m2.end());
+}
+
+TEST(lsm_map, random_ops)
+{
+    // a tiny memtable, every few writes flush and merge
+    lmap                m1(8);
+    std::map<int, int>  m2;
+
+    std::srand(21);
+    for (int i = 0; i < 20 * VOLUME; ++i)
+    {
+        const int key = std::rand() % VOLUME;
+        switch (std::rand() % 4)
+        {
+            case 0:
+                EXPECT_EQ(m1.insert(ft::make_pair(key, i)), m2.insert(std::make_pair(key, i)).second);
+                break;
+            case 1:
+                m1.erase(key);
+                m2.erase(key);
+                break;
+            default:
+                m1.insert_or_assign(key, i);
+                m2[key] = i;
+        }
+    }
+    // 1000 keys fill tiers 0 to 3, fanout - 1 runs per tier at most
+    EXPECT_LE(m1.run_count(), 4 * (lmap::tier_fanout - 1));
+
+    for (int key = -1; key <= VOLUME; ++key)
+    {
+        int obj = -1;
+        EXPECT_EQ(m1.count(key), m2.count(key));
+        EXPECT_EQ(m1.find(key, obj), m2.count(key) == 1);
+        if (m2.count(key))
+        {
+            EXPECT_EQ(obj, m2[key]);
+            EXPECT_EQ(m1.at(key), m2[key]);
+        }
+        else
+        {
+            EXPECT_THROW(m1.at(key), std::out_of_range);
+        }
+    }
+    expect_same(m1, m2);
+
+    // the merge starts from any key
+    for (int key = -1; key <= VOLUME; key += 37)
+    {
+        lmap::const_iterator it1 = m1.lower_bound(key);
+        std::map<int, int>::iterator it2 = m2.lower_bound(key);
+        if (it2 == m2.end())
+        {
+            EXPECT_TRUE(it1 == m1.end());
+        }
+        else
+        {
+            EXPECT_EQ(it1->first, it2->first);
+            EXPECT_EQ(it1->second, it2->second);
+        }
+    }
+
+    // copies don't share runs
+    lmap m3(m1);
+    m1.insert_or_assign(-5, 5);
+    EXPECT_EQ(m3.count(-5), 0u);
+    m1.erase(-5);
+    expect_same(m3, m2);
+
+    m1.compact();
+    EXPECT_EQ(m1.run_count(), m2.empty() ? 0u : 1u);
+    expect_same(m1, m2);
+}
+
+TEST(lsm_map, tombstones)
+{
+    lmap m1(4);
+
+    for (int i = 0; i < VOLUME; ++i)
+        m1.insert_or_assign(i, i);
+    for (int i = 0; i < VOLUME; ++i)
+        m1.erase(i);
+    EXPECT_TRUE(m1.empty());
+    EXPECT_EQ(m1.count(0), 0u);
+
+    // everything erased, the compaction drops it all
+    m1.compact();
+    EXPECT_EQ(m1.run_count(), 0u);
+
+    m1.insert_or_assign(3, 30);
+    m1.erase(3);
+    m1.insert_or_assign(3, 31);
+    EXPECT_EQ(m1.at(3), 31);
+    EXPECT_FALSE(m1.insert(ft::make_pair(3, 32)));
+
+    m1.clear();
+    EXPECT_TRUE(m1.empty());
+}
+
+TEST(lsm_map, strings)
+{
+    ft::lsm_map<std::string, std::string, std::greater<std::string> > m1(3);
+
+    m1.insert_or_assign("b", "1");
+    m1.insert_or_assign("a", "2");
+    m1.insert_or_assign("d", "3");
+    m1.insert_or_assign("c", "4");
+    m1.erase("a");
+    m1.insert_or_assign("b", "5");
+
+    std::string keys;
+    for (ft::lsm_map<std::string, std::string, std::greater<std::string> >::const_iterator it = m1.begin();
+            it != m1.end(); ++it)
+        keys += it->first + it->second;
+    EXPECT_EQ(keys, "d3c4b5");
+}
@@ -0,0 +1,815 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+
+#include "../map.hpp"
+
+#define VOLUME 1000
+
+
+/*
+    The iterators hand out the node they point to through base(), which
+    is enough to walk up to the root and check the red-black properties
+    from the outside:
+        - the root is black
+        - a red node has no red child
+        - every path down to a leaf holds the same number of black nodes
+*/
+
+template <typename NodePtr>
+int black_height(NodePtr node)
+{
+    if (node == NULL)
+        return 1;
+    if (node->color == ft::RED)
+    {
+        if ((node->left != NULL && node->left->color == ft::RED)
+            || (node->right != NULL && node->right->color == ft::RED))
+            return -1;
+    }
+    if (node->left != NULL && node->left->parent != node)
+        return -1;
+    if (node->right != NULL && node->right->parent != node)
+        return -1;
+
+    int left = black_height(node->left);
+    int right = black_height(node->right);
+    if (left < 0 || right < 0 || left != right)
+        return -1;
+    return left + (node->color == ft::BLACK ? 1 : 0);
+}
+
+/* the root is the left child of end() */
+template <typename NodePtr>
+bool is_valid_root(NodePtr end)
+{
+    auto root = end->left;
+
+    if (root == NULL)
+        return true;
+    if (root->color != ft::BLACK || root->parent != end)
+        return false;
+    return black_height(root) > 0;
+}
+
+template <typename Map>
+bool is_valid_tree(Map& m)
+{
+    if (m.empty() && m.begin() != m.end())
+        return false;
+    return is_valid_root(m.end().base());
+}
+
+/* the other balancing policies keep a height or a subtree size per node,
+    checked against the shape. -1 on a broken node */
+template <typename NodePtr>
+int avl_height(NodePtr node)
+{
+    if (node == NULL)
+        return 0;
+
+    int left = avl_height(node->left);
+    int right = avl_height(node->right);
+    if (left < 0 || right < 0 || left - right > 1 || right - left > 1)
+        return -1;
+    if (node->height != std::max(left, right) + 1)
+        return -1;
+    return node->height;
+}
+
+template <typename NodePtr>
+long wb_size(NodePtr node)
+{
+    if (node == NULL)
+        return 0;
+
+    long left = wb_size(node->left);
+    long right = wb_size(node->right);
+    if (left < 0 || right < 0
+        || 3 * (left + 1) < right + 1 || 3 * (right + 1) < left + 1)
+        return -1;
+    if (node->size != size_t(left + right + 1))
+        return -1;
+    return node->size;
+}
+
+template <typename FtMap, typename StdMap>
+bool same_content(const FtMap& ft_map, const StdMap& std_map)
+{
+    if (ft_map.size() != std_map.size())
+        return false;
+
+    typename FtMap::const_iterator it = ft_map.begin();
+    typename StdMap::const_iterator sit = std_map.begin();
+    for (; sit != std_map.end(); ++it, ++sit)
+    {
+        if (it->first != sit->first || it->second != sit->second)
+            return false;
+    }
+    return it == ft_map.end();
+}
+
+
+TEST(map, constructor)
+{
+    ft::map<int, std::string> m1;
+    EXPECT_TRUE(m1.empty());
+    EXPECT_EQ(m1.size(), 0);
+    EXPECT_TRUE(m1.begin() == m1.end());
+
+    for (int i = 0; i < 10; ++i)
+        m1[i] = std::to_string(i);
+    EXPECT_EQ(m1.size(), 10);
+
+    ft::map<int, std::string> m2(m1.begin(), m1.end());
+    EXPECT_EQ(m2.size(), 10);
+    EXPECT_EQ(m2[3], "3");
+
+    ft::map<int, std::string> m3(m2);
+    EXPECT_EQ(m3, m2);
+    EXPECT_TRUE(is_valid_tree(m3));
+
+    ft::map<int, std::string> m4;
+    m4 = m3;
+    EXPECT_EQ(m4, m1);
+    m4[42] = "42";
+    EXPECT_NE(m4, m1);
+}
+
+TEST(map, iterator)
+{
+    ft::map<int, int> m1;
+    for (int i = 0; i < VOLUME; ++i)
+        m1.insert(ft::make_pair(i * 7 % VOLUME, i));
+
+    int prev = -1;
+    for (ft::map<int, int>::iterator it = m1.begin(); it != m1.end(); ++it)
+    {
+        EXPECT_LT(prev, it->first);
+        prev = it->first;
+    }
+
+    ft::map<int, int>::reverse_iterator rit = m1.rbegin();
+    EXPECT_EQ(rit->first, VOLUME - 1);
+    for (; rit != m1.rend(); ++rit)
+        EXPECT_EQ(rit->first, prev--);
+
+    ft::map<int, int>::const_iterator cit = m1.begin();
+    EXPECT_TRUE(cit == m1.begin());
+    EXPECT_EQ((--m1.end())->first, VOLUME - 1);
+}
+
+TEST(map, insert)
+{
+    ft::map<int, int> m1;
+    std::map<int, int> s1;
+
+    std::srand(42);
+    for (int i = 0; i < VOLUME; ++i)
+    {
+        int key = std::rand() % (VOLUME / 2);
+        EXPECT_EQ(m1.insert(ft::make_pair(key, i)).second,
+                  s1.insert(std::make_pair(key, i)).second);
+    }
+    EXPECT_TRUE(same_content(m1, s1));
+    EXPECT_TRUE(is_valid_tree(m1));
+
+    // hinted inserts at the right spot and at the wrong one
+    ft::map<int, int> m2;
+    for (int i = 0; i < VOLUME; ++i)
+        m2.insert(m2.end(), ft::make_pair(i, i));
+    for (int i = 0; i < VOLUME; ++i)
+        m2.insert(m2.begin(), ft::make_pair(-i, i));
+    EXPECT_EQ(m2.size(), 2 * VOLUME - 1);
+    EXPECT_TRUE(is_valid_tree(m2));
+}
+
+TEST(map, access)
+{
+    ft::map<std::string, int> m1;
+
+    m1["one"] = 1;
+    m1["two"] = 2;
+    EXPECT_EQ(m1["one"], 1);
+    EXPECT_EQ(m1.at("two"), 2);
+    EXPECT_THROW(m1.at("three"), std::out_of_range);
+    EXPECT_EQ(m1["three"], 0);
+    EXPECT_EQ(m1.size(), 3);
+}
+
+TEST(map, lookup)
+{
+    ft::map<int, int> m1;
+    for (int i = 0; i < VOLUME; i += 2)
+        m1[i] = i;
+
+    EXPECT_EQ(m1.find(10)->second, 10);
+    EXPECT_TRUE(m1.find(11) == m1.end());
+    EXPECT_EQ(m1.count(10), 1);
+    EXPECT_EQ(m1.count(11), 0);
+    EXPECT_EQ(m1.lower_bound(11)->first, 12);
+    EXPECT_EQ(m1.lower_bound(12)->first, 12);
+    EXPECT_EQ(m1.upper_bound(12)->first, 14);
+    EXPECT_TRUE(m1.upper_bound(VOLUME) == m1.end());
+
+    ft::pair<ft::map<int, int>::iterator, ft::map<int, int>::iterator> range = m1.equal_range(20);
+    EXPECT_EQ(range.first->first, 20);
+    EXPECT_EQ(range.second->first, 22);
+}
+
+TEST(map, erase)
+{
+    ft::map<int, int> m1;
+    std::map<int, int> s1;
+
+    std::srand(21);
+    for (int i = 0; i < VOLUME; ++i)
+    {
+        m1[i] = i;
+        s1[i] = i;
+    }
+    for (int i = 0; i < VOLUME; ++i)
+    {
+        int key = std::rand() % VOLUME;
+        EXPECT_EQ(m1.erase(key), s1.erase(key));
+        if (i % 100 == 0)
+        {
+            EXPECT_TRUE(is_valid_tree(m1));
+        }
+    }
+    EXPECT_TRUE(same_content(m1, s1));
+    EXPECT_TRUE(is_valid_tree(m1));
+
+    m1.erase(m1.begin(), m1.find(s1.rbegin()->first));
+    EXPECT_EQ(m1.size(), 1);
+    EXPECT_TRUE(is_valid_tree(m1));
+
+    m1.erase(m1.begin());
+    EXPECT_TRUE(m1.empty());
+    EXPECT_TRUE(is_valid_tree(m1));
+}
+
+TEST(map, erase_if)
+{
+    // few matches take the element by element path
+    {
+        ft::map<int, int> m1;
+        std::map<int, int> s1;
+        for (int i = 0; i < VOLUME; ++i)
+        {
+            m1[i] = i;
+            s1[i] = i;
+        }
+
+        size_t removed = ft::erase_if(m1, [](const ft::pair<const int, int>& p) { return p.first % 50 == 0; });
+        for (std::map<int, int>::iterator it = s1.begin(); it != s1.end(); )
+        {
+            if (it->first % 50 == 0)
+                s1.erase(it++);
+            else
+                ++it;
+        }
+        EXPECT_EQ(removed, VOLUME / 50);
+        EXPECT_TRUE(same_content(m1, s1));
+        EXPECT_TRUE(is_valid_tree(m1));
+    }
+
+    // most of the map goes away, the tree is rebuilt
+    for (int keep = 0; keep < 40; ++keep)
+    {
+        ft::map<int, int> m1;
+        std::map<int, int> s1;
+        for (int i = 0; i < VOLUME; ++i)
+        {
+            m1[i] = i;
+            s1[i] = i;
+        }
+
+        int calls = 0;
+        size_t removed = ft::erase_if(m1, [&](const ft::pair<const int, int>& p) {
+            ++calls;
+            return p.first >= keep;
+        });
+        s1.erase(s1.lower_bound(keep), s1.end());
+        EXPECT_EQ(calls, VOLUME);
+        EXPECT_EQ(removed, size_t(VOLUME - keep));
+        EXPECT_TRUE(same_content(m1, s1));
+        EXPECT_TRUE(is_valid_tree(m1));
+
+        // still a working map afterwards
+        m1[VOLUME] = 0;
+        m1.erase(0);
+        EXPECT_TRUE(is_valid_tree(m1));
+    }
+
+    ft::map<int, int> m2;
+    EXPECT_EQ(ft::erase_if(m2, [](const ft::pair<const int, int>&) { return true; }), 0);
+}
+
+TEST(map, reserve)
+{
+    ft::map<int, int> m1;
+    EXPECT_EQ(m1.capacity(), 0);
+
+    m1.reserve(VOLUME);
+    EXPECT_EQ(m1.capacity(), VOLUME);
+    EXPECT_TRUE(m1.empty());
+
+    for (int i = 0; i < VOLUME; ++i)
+        m1[i] = i;
+    EXPECT_EQ(m1.capacity(), VOLUME);
+
+    // the nodes come out of the slab in address order
+    const ft::pair<const int, int>* prev = &*m1.begin();
+    for (ft::map<int, int>::iterator it = ++m1.begin(); it != m1.end(); ++it)
+    {
+        EXPECT_LT(prev, &*it);
+        prev = &*it;
+    }
+
+    // beyond the reservation the allocator is asked again
+    m1[VOLUME] = VOLUME;
+    EXPECT_EQ(m1.capacity(), VOLUME + 1);
+
+    // erased slab nodes are kept and reused, the extra one is given back
+    m1.erase(0);
+    m1.erase(1);
+    EXPECT_EQ(m1.capacity(), VOLUME + 1);
+    m1.erase(VOLUME);
+    EXPECT_EQ(m1.capacity(), VOLUME);
+    m1[-1] = -1;
+    EXPECT_EQ(m1.capacity(), VOLUME);
+
+    m1.clear();
+    EXPECT_EQ(m1.capacity(), VOLUME);
+    m1.reserve(VOLUME / 2);
+    EXPECT_EQ(m1.capacity(), VOLUME);
+
+    // erase_if hands the nodes back to the slab as well
+    for (int i = 0; i < VOLUME; ++i)
+        m1[i] = i;
+    ft::erase_if(m1, [](const ft::pair<const int, int>& p) { return p.first % 2; });
+    EXPECT_EQ(m1.size(), VOLUME / 2);
+    EXPECT_EQ(m1.capacity(), VOLUME);
+    EXPECT_TRUE(is_valid_tree(m1));
+
+    // a copy reserves nothing, erased nodes go straight back
+    ft::map<int, int> m2(m1);
+    EXPECT_EQ(m2.capacity(), m1.size());
+    EXPECT_EQ(m2, m1);
+    m2.clear();
+    EXPECT_EQ(m2.capacity(), 0);
+
+    // many slabs, every node finds its own
+    ft::map<int, int> m3;
+    for (int i = 1; i <= 100; ++i)
+    {
+        m3.reserve(i * 10);
+        m3[i] = i;
+    }
+    EXPECT_EQ(m3.capacity(), 1000);
+    for (int i = 100; i < VOLUME + 100; ++i)
+        m3[i] = i;
+    EXPECT_EQ(m3.capacity(), VOLUME + 99);
+    m3.clear();
+    EXPECT_EQ(m3.capacity(), 1000);
+}
+
+TEST(map, find_batch)
+{
+    ft::map<int, int> m1;
+    for (int i = 0; i < VOLUME; i += 2)
+        m1[i] = i;
+
+    std::vector<int> keys;
+    for (int i = -3; i < VOLUME + 3; ++i)
+        keys.push_back((i * 37) % (VOLUME + 3));
+
+    std::vector<ft::map<int, int>::iterator> found;
+    m1.find_batch(keys.begin(), keys.end(), std::back_inserter(found));
+    ASSERT_EQ(found.size(), keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+        EXPECT_TRUE(found[i] == m1.find(keys[i]));
+
+    std::vector<ft::map<int, int>::iterator> lower(keys.size());
+    std::vector<ft::map<int, int>::iterator> upper(keys.size());
+    m1.lower_bound_batch(keys.begin(), keys.end(), lower.begin());
+    m1.upper_bound_batch(keys.begin(), keys.end(), upper.begin());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        EXPECT_TRUE(lower[i] == m1.lower_bound(keys[i]));
+        EXPECT_TRUE(upper[i] == m1.upper_bound(keys[i]));
+    }
+
+    const ft::map<int, int>& m2 = m1;
+    std::vector<ft::map<int, int>::const_iterator> cfound;
+    m2.find_batch(keys.begin(), keys.begin() + 3, std::back_inserter(cfound));
+    EXPECT_EQ(cfound.size(), 3);
+    EXPECT_TRUE(cfound[0] == m2.find(keys[0]));
+
+    ft::map<int, int> empty;
+    found.clear();
+    empty.find_batch(keys.begin(), keys.end(), std::back_inserter(found));
+    EXPECT_EQ(found.size(), keys.size());
+    EXPECT_TRUE(found.back() == empty.end());
+}
+
+TEST(map, find_near)
+{
+    ft::map<int, int> m1;
+    for (int i = 0; i < VOLUME; i += 3)
+        m1[i] = i;
+
+    // every hint against keys around it and far away from it
+    for (ft::map<int, int>::iterator hint = m1.begin(); hint != m1.end(); ++hint)
+    {
+        for (int d = -10; d <= 10; ++d)
+        {
+            int key = hint->first + d;
+            EXPECT_TRUE(m1.lower_bound_near(hint, key) == m1.lower_bound(key));
+            EXPECT_TRUE(m1.find_near(hint, key) == m1.find(key));
+        }
+        EXPECT_TRUE(m1.lower_bound_near(hint, -1) == m1.begin());
+        EXPECT_TRUE(m1.lower_bound_near(hint, VOLUME) == m1.end());
+        EXPECT_TRUE(m1.find_near(hint, VOLUME / 2 + 1) == m1.find(VOLUME / 2 + 1));
+    }
+
+    EXPECT_TRUE(m1.lower_bound_near(m1.end(), 500) == m1.lower_bound(500));
+    EXPECT_TRUE(m1.find_near(m1.end(), 999) == m1.find(999));
+    EXPECT_TRUE(m1.find_near(m1.end(), VOLUME + 1) == m1.end());
+
+    // a sliding window walking up through the keys
+    ft::map<int, int>::const_iterator cur = m1.begin();
+    const ft::map<int, int>& m2 = m1;
+    for (int key = 0; key < VOLUME; key += 7)
+    {
+        cur = m2.lower_bound_near(cur, key);
+        EXPECT_TRUE(cur == m2.lower_bound(key));
+    }
+
+    ft::map<int, int> empty;
+    EXPECT_TRUE(empty.find_near(empty.end(), 1) == empty.end());
+}
+
+/* compare() is counted, operator< must not be used at all */
+struct three_way_key
+{
+    static int  compare_calls;
+    int         value;
+
+    three_way_key(int v) : value(v) {}
+
+    bool operator<(const three_way_key&) const
+    {
+        ADD_FAILURE() << "operator< used instead of compare()";
+        return false;
+    }
+
+    int compare(const three_way_key& rhs) const
+    {
+        ++compare_calls;
+        return (value > rhs.value) - (value < rhs.value);
+    }
+};
+
+int three_way_key::compare_calls = 0;
+
+TEST(map, three_way)
+{
+    ft::map<three_way_key, int> m1;
+
+    for (int i = 0; i < VOLUME; ++i)
+        m1.insert(ft::make_pair(three_way_key(i * 7 % VOLUME), i));
+    EXPECT_EQ(m1.size(), VOLUME);
+    EXPECT_TRUE(is_valid_tree(m1));
+
+    three_way_key::compare_calls = 0;
+    EXPECT_TRUE(m1.find(three_way_key(500)) != m1.end());
+    EXPECT_TRUE(m1.find(three_way_key(VOLUME)) == m1.end());
+    // a single comparison per level
+    EXPECT_LE(three_way_key::compare_calls, 2 * 2 * 10);
+}
+
+TEST(map, prefix)
+{
+    typedef ft::map<std::string, int, ft::prefix_less>  prefix_map;
+
+    prefix_map                  m1;
+    std::map<std::string, int>  m2;
+    std::vector<std::string>    keys;
+
+    // shared prefixes longer than the cached 8 bytes, short keys, and
+    // characters that sort differently as signed char
+    keys.push_back("");
+    keys.push_back(std::string(1, '\0'));
+    keys.push_back(std::string("ab\0c", 4));
+    keys.push_back("ab");
+    keys.push_back("\xff");
+    keys.push_back("\x7f");
+    for (int i = 0; i < VOLUME; ++i)
+        keys.push_back("/usr/share/" + std::to_string(i * 7 % VOLUME));
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        m1.insert(ft::make_pair(keys[i], int(i)));
+        m2.insert(std::make_pair(keys[i], int(i)));
+    }
+    EXPECT_TRUE(same_content(m1, m2));
+    EXPECT_TRUE(is_valid_tree(m1));
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        EXPECT_TRUE(m1.find(keys[i]) != m1.end());
+        EXPECT_EQ(m1.count(keys[i] + "x"), m2.count(keys[i] + "x"));
+        EXPECT_EQ(std::distance(m1.begin(), m1.lower_bound(keys[i] + "x")),
+                  std::distance(m2.begin(), m2.lower_bound(keys[i] + "x")));
+        EXPECT_EQ(std::distance(m1.begin(), m1.upper_bound(keys[i])),
+                  std::distance(m2.begin(), m2.upper_bound(keys[i])));
+    }
+    EXPECT_TRUE(m1.upper_bound("\xff") == m1.end());
+    EXPECT_EQ(m1.lower_bound("ab\x01")->first, "\x7f");
+
+    for (int i = 0; i < VOLUME; i += 3)
+    {
+        m1.erase("/usr/share/" + std::to_string(i));
+        m2.erase("/usr/share/" + std::to_string(i));
+    }
+    EXPECT_TRUE(same_content(m1, m2));
+    prefix_map m3(m1);
+    EXPECT_TRUE(m3 == m1);
+}
+
+template <typename Map>
+void compact_workload(Map& m1)
+{
+    typedef typename Map::iterator  iterator;
+
+    Map m2(m1);
+    for (int rebalance = 0; rebalance < 2; ++rebalance)
+    {
+        m1.compact(rebalance);
+        EXPECT_TRUE(m1 == m2);
+        EXPECT_TRUE(is_valid_tree(m1));
+        EXPECT_EQ(m1.capacity(), m1.size());
+
+        // one block, in key order
+        iterator prev = m1.begin();
+        for (iterator it = m1.begin(); it != m1.end(); prev = it++)
+        {
+            if (it != m1.begin())
+            {
+                EXPECT_EQ(it.base(), prev.base() + 1);
+            }
+            EXPECT_TRUE(m1.find(it->first) == it);
+        }
+    }
+
+    // still a normal map afterwards
+    m1.erase(m1.begin());
+    m1.insert(*m2.begin());
+    EXPECT_TRUE(m1 == m2);
+    EXPECT_TRUE(is_valid_tree(m1));
+}
+
+TEST(map, compact)
+{
+    // relocated by their bytes
+    const bool relocatable = ft::is_trivially_relocatable<ft::pair<const int, int> >::value;
+    const bool copied = ft::is_trivially_relocatable<ft::pair<const std::string, int> >::value;
+    EXPECT_TRUE(relocatable);
+    EXPECT_FALSE(copied);
+
+    ft::map<int, int> m1;
+    std::srand(7);
+    for (int i = 0; i < VOLUME; ++i)
+        m1[std::rand() % VOLUME] = i;
+    for (int i = 0; i < VOLUME / 2; ++i)
+        m1.erase(std::rand() % VOLUME);
+    compact_workload(m1);
+
+    // copy constructed, with cached prefixes
+    ft::map<std::string, std::string, ft::prefix_less> m2;
+    m2.reserve(VOLUME / 4);
+    for (int i = 0; i < VOLUME; ++i)
+        m2[std::to_string(std::rand() % VOLUME)] = std::to_string(i);
+    for (int i = 0; i < VOLUME / 2; ++i)
+        m2.erase(std::to_string(std::rand() % VOLUME));
+    compact_workload(m2);
+
+    ft::map<int, int> m3;
+    m3.reserve(10);
+    m3.compact();
+    EXPECT_EQ(m3.capacity(), 0);
+    EXPECT_TRUE(m3.begin() == m3.end());
+    m3[1] = 1;
+    m3.compact(true);
+    EXPECT_EQ(m3.begin()->first, 1);
+    EXPECT_TRUE(is_valid_tree(m3));
+}
+
+template <typename Balance, typename IsValid>
+void balance_workload(IsValid is_valid)
+{
+    typedef ft::map<int, int, std::less<int>,
+                    std::allocator<ft::pair<const int, int> >, Balance> balanced_map;
+
+    balanced_map        m1;
+    std::map<int, int>  m2;
+
+    std::srand(42);
+    for (int i = 0; i < VOLUME; ++i)
+    {
+        int key = std::rand() % VOLUME;
+        m1.insert(ft::make_pair(key, i));
+        m2.insert(std::make_pair(key, i));
+    }
+    // ascending runs are the worst case for a tree without balancing
+    for (int i = VOLUME; i < 2 * VOLUME; ++i)
+    {
+        m1[i] = i;
+        m2[i] = i;
+    }
+    EXPECT_TRUE(same_content(m1, m2));
+    EXPECT_TRUE(is_valid(m1.end().base()->left));
+
+    for (int i = 0; i < VOLUME; ++i)
+    {
+        int key = std::rand() % (2 * VOLUME);
+        EXPECT_EQ(m1.erase(key), m2.erase(key));
+    }
+    EXPECT_TRUE(same_content(m1, m2));
+    EXPECT_TRUE(is_valid(m1.end().base()->left));
+
+    balanced_map m3(m1);
+    EXPECT_TRUE(m3 == m1);
+    EXPECT_TRUE(is_valid(m3.end().base()->left));
+
+    // the bulk path rebuilds the tree through the policy
+    ft::erase_if(m3, [](const ft::pair<const int, int>& p) { return p.first % 3 != 0; });
+    EXPECT_TRUE(is_valid(m3.end().base()->left));
+    for (typename balanced_map::iterator it = m3.begin(); it != m3.end(); ++it)
+        EXPECT_EQ(it->first % 3, 0);
+    m3.erase(m3.begin(), m3.end());
+    EXPECT_TRUE(m3.empty());
+
+    m1.compact(true);
+    EXPECT_TRUE(same_content(m1, m2));
+    EXPECT_TRUE(is_valid(m1.end().base()->left));
+}
+
+TEST(map, balance)
+{
+    // the links point to the node base of the policy
+    typedef ft::rb_node_base*   rb_node;
+    typedef ft::avl_node_base*  avl_node;
+    typedef ft::wb_node_base*   wb_node;
+
+    balance_workload<ft::rb_balance>([](rb_node root) {
+        return root == NULL || (root->color == ft::BLACK && black_height(root) > 0);
+    });
+    balance_workload<ft::avl_balance>([](avl_node root) { return avl_height(root) >= 0; });
+    balance_workload<ft::wb_balance>([](wb_node root) { return wb_size(root) >= 0; });
+}
+
+TEST(map, comparisons)
+{
+    ft::map<int, int> m1;
+    ft::map<int, int> m2;
+
+    EXPECT_TRUE(m1 == m2);
+    m1[1] = 1;
+    EXPECT_TRUE(m2 < m1);
+    m2[1] = 2;
+    EXPECT_TRUE(m1 < m2);
+    EXPECT_TRUE(m1 != m2);
+
+    m1.swap(m2);
+    EXPECT_EQ(m1[1], 2);
+    ft::swap(m1, m2);
+    EXPECT_EQ(m1[1], 1);
+}
+
+TEST(map, bloom_filter)
+{
+    typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >,
+                    ft::rb_balance, ft::bloom_filter<int> >     filtered_map;
+
+    // the default filter takes no room
+    EXPECT_EQ(sizeof(ft::map<int, int>),
+              sizeof(ft::rb_tree<ft::pair<const int, int>, ft::map<int, int>::value_compare,
+                                 std::allocator<ft::pair<const int, int> > >));
+
+    filtered_map        m1;
+    std::map<int, int>  m2;
+
+    // even keys only, odd ones are misses
+    std::srand(17);
+    for (int i = 0; i < 10 * VOLUME; ++i)
+    {
+        const int key = 2 * (std::rand() % (4 * VOLUME));
+        switch (std::rand() % 4)
+        {
+            case 0:
+                m1.insert(ft::make_pair(key, i));
+                m2.insert(std::make_pair(key, i));
+                break;
+            case 1:
+                EXPECT_EQ(m1.erase(key), m2.erase(key));
+                break;
+            case 2:
+                m1.insert(m1.begin(), ft::make_pair(key, i));
+                m2.insert(std::make_pair(key, i));
+                break;
+            default:
+                m1[key] = i;
+                m2[key] = i;
+        }
+    }
+    EXPECT_TRUE(same_content(m1, m2));
+
+    // never a false "no", few false "maybe"s
+    int maybes = 0;
+    for (int key = -1; key < 8 * VOLUME; ++key)
+    {
+        EXPECT_EQ(m1.count(key), m2.count(key));
+        EXPECT_EQ(m1.find(key) == m1.end(), m2.find(key) == m2.end());
+        maybes += (key % 2 != 0 && m1.filter().may_contain(key));
+    }
+    EXPECT_LT(maybes, 4 * VOLUME / 20);
+
+    // erasing most keys rebuilds the filter smaller
+    const size_t before = m1.filter().memory();
+    ft::erase_if(m1, [](const ft::pair<const int, int>& p) { return p.first % 16 != 0; });
+    for (std::map<int, int>::iterator it = m2.begin(); it != m2.end(); )
+        it = (it->first % 16 != 0) ? m2.erase(it) : ++it;
+    EXPECT_LT(m1.filter().memory(), before);
+    EXPECT_TRUE(same_content(m1, m2));
+    for (int key = 0; key < 8 * VOLUME; key += 16)
+        EXPECT_EQ(m1.count(key), m2.count(key));
+
+    // a bulk insert into an empty map builds the filter once, into a full
+    // one it goes key by key
+    filtered_map m3(m1.begin(), m1.end());
+    m3.insert(m1.begin(), m1.end());
+    std::vector<ft::pair<const int, int> > more;
+    for (int key = 1; key < VOLUME; key += 2)
+        more.push_back(ft::make_pair(key, key));
+    m3.insert(more.begin(), more.end());
+    for (int key = 0; key < VOLUME; ++key)
+        EXPECT_EQ(m3.count(key), (key % 2 != 0) ? 1u : m2.count(key));
+
+    m3.swap(m1);
+    EXPECT_EQ(m1.count(1), 1u);
+    EXPECT_EQ(m3.count(1), 0u);
+    m1.erase(m1.begin(), m1.end());
+    EXPECT_EQ(m1.count(16), 0u);
+    m3.clear();
+    EXPECT_EQ(m3.count(16), 0u);
+    m3[16] = 1;
+    EXPECT_EQ(m3.at(16), 1);
+}
+
+/* std::hash that throws while hash_fails is set */
+static bool hash_fails = false;
+
+struct failing_hash
+{
+    size_t operator()(int key) const
+    {
+        if (hash_fails)
+            throw std::runtime_error("failing_hash");
+        return std::hash<int>()(key);
+    }
+};
+
+TEST(map, bloom_filter_rebuild_throws)
+{
+    typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >,
+                    ft::rb_balance, ft::bloom_filter<int, failing_hash> >   filtered_map;
+
+    filtered_map m1;
+    for (int key = 0; key < 100; ++key)
+        m1[key] = key;
+
+    // the filter throws while it learns of the new key. the key is in the
+    // tree and the filter must not deny it
+    const int key = 100;
+    hash_fails = true;
+    EXPECT_THROW(m1.insert(ft::make_pair(key, key)), std::runtime_error);
+    hash_fails = false;
+    EXPECT_EQ(m1.count(key), 1u);
+    EXPECT_EQ(m1.size(), static_cast<size_t>(key + 1));
+    for (int k = 0; k <= key; ++k)
+        ASSERT_EQ(m1.at(k), k);
+
+    // the next insert rebuilds it for real
+    m1[-1] = -1;
+    EXPECT_EQ(m1.count(-1), 1u);
+    EXPECT_EQ(m1.count(key), 1u);
+    EXPECT_FALSE(m1.filter().may_contain(-2) && m1.filter().may_contain(-3)
+                 && m1.filter().may_contain(-4) && m1.filter().may_contain(-5));
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+
+#include "../mapped_vector.hpp"
+#include "../stack.hpp"
+
+#define VOLUME 1000
+
+
+TEST(mapped_vector, grows_in_place)
+{
+    ft::mapped_vector<int> v1(ft::max_elements(VOLUME * VOLUME));
+    EXPECT_TRUE(v1.empty());
+    EXPECT_EQ(v1.capacity(), 0);
+    EXPECT_GE(v1.max_size(), VOLUME * VOLUME);
+
+    v1.push_back(0);
+    const int* first = &v1[0];
+    for (int i = 1; i < VOLUME * 100; ++i)
+        v1.push_back(i);
+
+    // nothing moved while growing
+    EXPECT_EQ(&v1[0], first);
+    EXPECT_EQ(v1.size(), VOLUME * 100);
+    for (int i = 0; i < VOLUME * 100; ++i)
+        ASSERT_EQ(v1[i], i);
+
+    v1.resize(VOLUME * VOLUME);
+    EXPECT_EQ(&v1[0], first);
+    EXPECT_EQ(v1.back(), 0);
+}
+
+TEST(mapped_vector, overflow)
+{
+    ft::mapped_vector<int> v1(ft::max_elements(10));
+    const size_t max = v1.max_size();
+
+    // the reservation is rounded up to the page
+    EXPECT_GE(max, 10);
+    v1.resize(max, 1);
+    EXPECT_EQ(v1.capacity(), max);
+    EXPECT_THROW(v1.push_back(2), std::length_error);
+    EXPECT_THROW(v1.reserve(max + 1), std::length_error);
+    EXPECT_EQ(v1.size(), max);
+
+    ft::mapped_vector<int> v2;
+    EXPECT_EQ(v2.max_size(), ft::mapped_vector<int>::default_reservation / sizeof(int));
+}
+
+TEST(mapped_vector, vector_interface)
+{
+    ft::mapped_vector<std::string> v1(3, "three");
+    EXPECT_EQ(v1.size(), 3);
+    EXPECT_EQ(v1[2], "three");
+
+    ft::mapped_vector<std::string> v2(v1);
+    EXPECT_TRUE(v1 == v2);
+    EXPECT_NE(v1.data(), v2.data());
+
+    v2.insert(v2.begin() + 1, "one");
+    EXPECT_EQ(v2.size(), 4);
+    EXPECT_EQ(v2[1], "one");
+    EXPECT_TRUE(v1 < v2 || v2 < v1);
+
+    std::vector<std::string> s(100, "s");
+    ft::mapped_vector<std::string> v3(s.begin(), s.end(), ft::max_elements(1000));
+    EXPECT_EQ(v3.size(), 100);
+    EXPECT_LE(v3.max_size(), 2000);
+
+    const std::string* data1 = v1.data();
+    const std::string* data3 = v3.data();
+    const size_t max3 = v3.max_size();
+    ft::swap(v1, v3);
+    EXPECT_EQ(v1.data(), data3);
+    EXPECT_EQ(v3.data(), data1);
+    EXPECT_EQ(v1.max_size(), max3);
+    EXPECT_EQ(v1.size(), 100);
+    EXPECT_EQ(v3.size(), 3);
+
+    v1 = v3;
+    EXPECT_TRUE(v1 == v3);
+    v1.clear();
+    EXPECT_TRUE(v1.empty());
+
+    ft::stack<int, ft::mapped_vector<int> > st;
+    for (int i = 0; i < VOLUME; ++i)
+        st.push(i);
+    EXPECT_EQ(st.top(), VOLUME - 1);
+}
+
+TEST(mapped_vector, random_ops)
+{
+    ft::mapped_vector<int> v(ft::max_elements(VOLUME * 10));
+    std::vector<int> s;
+
+    srand(42);
+    for (int i = 0; i < VOLUME * 10; ++i)
+    {
+        const int op = rand() % 6;
+        const int val = rand() % VOLUME;
+
+        if (op < 2)
+        {
+            v.push_back(val);
+            s.push_back(val);
+        }
+        else if (op == 2 && !s.empty())
+        {
+            v.pop_back();
+            s.pop_back();
+        }
+        else if (op == 3)
+        {
+            const size_t pos = rand() % (s.size() + 1);
+            v.insert(v.begin() + pos, 3, val);
+            s.insert(s.begin() + pos, 3, val);
+        }
+        else if (op == 4 && !s.empty())
+        {
+            const size_t first = rand() % s.size();
+            const size_t last = first + rand() % (s.size() - first + 1);
+            v.erase(v.begin() + first, v.begin() + last);
+            s.erase(s.begin() + first, s.begin() + last);
+        }
+        else if (op == 5)
+        {
+            const size_t n = rand() % (VOLUME * 2);
+            v.resize(n, val);
+            s.resize(n, val);
+        }
+        ASSERT_EQ(v.size(), s.size());
+        ASSERT_TRUE(std::equal(s.begin(), s.end(), v.begin()));
+    }
+}
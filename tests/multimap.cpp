@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include "../multimap.hpp"
+
+#define VOLUME 1000
+
+
+template <typename M1, typename M2>
+bool same_content(const M1& m1, const M2& m2)
+{
+    if (m1.size() != m2.size())
+        return false;
+
+    typename M2::const_iterator it2 = m2.begin();
+    for (typename M1::const_iterator it = m1.begin(); it != m1.end(); ++it, ++it2)
+    {
+        if (it->first != it2->first || it->second != it2->second)
+            return false;
+    }
+    return true;
+}
+
+
+TEST(multimap, random_ops)
+{
+    ft::multimap<int, int>      m1;
+    std::multimap<int, int>     m2;
+
+    // few keys, many duplicates. the values record the insertion order
+    // that the equivalent keys have to keep
+    std::srand(44);
+    for (int i = 0; i < 20 * VOLUME; ++i)
+    {
+        const int key = std::rand() % (VOLUME / 10);
+        switch (std::rand() % 5)
+        {
+            case 0:
+            case 1:
+                EXPECT_EQ(m1.insert(ft::make_pair(key, i))->second, i);
+                m2.insert(std::make_pair(key, i));
+                break;
+            case 2:
+                // find may hand out any of the equivalent keys, the bounds
+                // are the same for both
+                if (i % 2)
+                {
+                    m1.insert(m1.lower_bound(key), ft::make_pair(key, i));
+                    m2.insert(m2.lower_bound(key), std::make_pair(key, i));
+                }
+                else
+                {
+                    m1.insert(m1.upper_bound(key), ft::make_pair(key, i));
+                    m2.insert(m2.upper_bound(key), std::make_pair(key, i));
+                }
+                break;
+            case 3:
+                if (std::rand() % 4 == 0)
+                {
+                    EXPECT_EQ(m1.erase(key), m2.erase(key));
+                }
+                else if (m2.count(key))
+                {
+                    m1.erase(m1.lower_bound(key));
+                    m2.erase(m2.lower_bound(key));
+                }
+                break;
+            default:
+                EXPECT_EQ(m1.count(key), m2.count(key));
+        }
+    }
+    EXPECT_TRUE(same_content(m1, m2));
+
+    for (int key = -1; key <= VOLUME / 10; ++key)
+    {
+        ft::pair<ft::multimap<int, int>::iterator, ft::multimap<int, int>::iterator>
+            range1 = m1.equal_range(key);
+        std::pair<std::multimap<int, int>::iterator, std::multimap<int, int>::iterator>
+            range2 = m2.equal_range(key);
+
+        EXPECT_TRUE(range1.first == m1.lower_bound(key));
+        EXPECT_TRUE(range1.second == m1.upper_bound(key));
+        EXPECT_EQ(m1.count(key), m2.count(key));
+        for (; range2.first != range2.second; ++range1.first, ++range2.first)
+            EXPECT_EQ(range1.first->second, range2.first->second);
+        EXPECT_TRUE(range1.first == range1.second);
+        if (m2.count(key))
+        {
+            EXPECT_EQ(m1.find(key)->first, key);
+        }
+        else
+        {
+            EXPECT_TRUE(m1.find(key) == m1.end());
+        }
+    }
+
+    ft::multimap<int, int> m3(m1);
+    EXPECT_TRUE(m3 == m1);
+    m3.insert(ft::make_pair(0, -1));
+    EXPECT_TRUE(m3 != m1);
+    size_t odd = 0;
+    for (std::multimap<int, int>::iterator it = m2.begin(); it != m2.end(); ++it)
+        odd += it->first % 2;
+    EXPECT_EQ(ft::erase_if(m3, [](const ft::pair<const int, int>& p) { return p.first % 2; }), odd);
+    EXPECT_EQ(m3.size(), m2.size() + 1 - odd);
+    m1.swap(m3);
+    EXPECT_EQ(m3.size(), m2.size());
+}
+
+/* a hint on the wrong side of the equivalent keys, as close as the order
+    allows, the same place std::multimap picks */
+TEST(multimap, hinted_insert)
+{
+    ft::multimap<int, int>      m1;
+    std::multimap<int, int>     m2;
+    const int                   keys[] = { 1, 5, 5, 5, 9 };
+
+    for (int i = 0; i < 5; ++i)
+    {
+        m1.insert(ft::make_pair(keys[i], i));
+        m2.insert(std::make_pair(keys[i], i));
+    }
+
+    // smaller hint: first of the 5s
+    ft::multimap<int, int>::iterator it = m1.insert(m1.begin(), ft::make_pair(5, 99));
+    m2.insert(m2.begin(), std::make_pair(5, 99));
+    EXPECT_TRUE(it == m1.lower_bound(5));
+    EXPECT_TRUE(same_content(m1, m2));
+
+    // bigger hint: last of the 5s
+    it = m1.insert(m1.find(9), ft::make_pair(5, 98));
+    m2.insert(m2.find(9), std::make_pair(5, 98));
+    EXPECT_TRUE(++it == m1.upper_bound(5));
+    EXPECT_TRUE(same_content(m1, m2));
+
+    // end() as the hint of a smaller key
+    m1.insert(m1.end(), ft::make_pair(5, 97));
+    m2.insert(m2.end(), std::make_pair(5, 97));
+    EXPECT_TRUE(same_content(m1, m2));
+
+    // a hint among the 5s goes right before it
+    it = m1.insert(++m1.lower_bound(5), ft::make_pair(5, 96));
+    m2.insert(++m2.lower_bound(5), std::make_pair(5, 96));
+    EXPECT_TRUE(it == ++m1.lower_bound(5));
+    EXPECT_TRUE(same_content(m1, m2));
+
+    srand(7);
+    for (int i = 0; i < VOLUME; ++i)
+    {
+        const int key = rand() % 10;
+        const int hint = rand() % 10;
+        m1.insert(m1.lower_bound(hint), ft::make_pair(key, i));
+        m2.insert(m2.lower_bound(hint), std::make_pair(key, i));
+    }
+    EXPECT_TRUE(same_content(m1, m2));
+}
+
+TEST(multimap, sorted_range_and_strings)
+{
+    std::vector<ft::pair<std::string, int> >   values;
+
+    // already in order, the range insert appends every one at end()
+    for (int i = 0; i < VOLUME; ++i)
+        values.push_back(ft::make_pair(std::string(1, 'a' + i * 26 / VOLUME), i));
+
+    ft::multimap<std::string, int, ft::prefix_less>  m1(values.begin(), values.end());
+    std::multimap<std::string, int>                  m2;
+    for (size_t i = 0; i < values.size(); ++i)
+        m2.insert(std::make_pair(values[i].first, values[i].second));
+
+    EXPECT_TRUE(same_content(m1, m2));
+    EXPECT_EQ(m1.count("a"), m2.count("a"));
+    EXPECT_EQ(m1.count("zz"), 0u);
+    EXPECT_EQ(m1.erase("b"), m2.erase("b"));
+    EXPECT_TRUE(m1.equal_range("b").first == m1.lower_bound("c"));
+    EXPECT_TRUE(same_content(m1, m2));
+
+    // the hint puts an equivalent key right before it
+    ft::multimap<std::string, int, ft::prefix_less>::iterator it = m1.upper_bound("c");
+    --it;
+    it = m1.insert(it, ft::make_pair(std::string("c"), -1));
+    ++it;
+    EXPECT_EQ(it->first, "c");
+    ++it;
+    EXPECT_EQ(it->first, "d");
+
+    m1.clear();
+    EXPECT_TRUE(m1.empty());
+    EXPECT_EQ(m1.count("a"), 0u);
+}
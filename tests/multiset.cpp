@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <functional>
+#include <cstdlib>
+
+#include "../multiset.hpp"
+
+#define VOLUME 1000
+
+
+TEST(multiset, random_ops)
+{
+    ft::multiset<int, std::greater<int> >   s1;
+    std::multiset<int, std::greater<int> >  s2;
+
+    std::srand(45);
+    for (int i = 0; i < 20 * VOLUME; ++i)
+    {
+        const int key = std::rand() % (VOLUME / 10);
+        switch (std::rand() % 4)
+        {
+            case 0:
+            case 1:
+                EXPECT_EQ(*s1.insert(key), key);
+                s2.insert(key);
+                break;
+            case 2:
+                EXPECT_EQ(s1.erase(key), s2.erase(key));
+                break;
+            default:
+                EXPECT_EQ(s1.count(key), s2.count(key));
+        }
+    }
+    EXPECT_EQ(s1.size(), s2.size());
+    EXPECT_TRUE(std::equal(s2.begin(), s2.end(), s1.begin()));
+
+    for (int key = -1; key <= VOLUME / 10; ++key)
+    {
+        EXPECT_EQ(s1.count(key), s2.count(key));
+        EXPECT_TRUE(s1.equal_range(key).first == s1.lower_bound(key));
+        EXPECT_TRUE(s1.equal_range(key).second == s1.upper_bound(key));
+        EXPECT_EQ(static_cast<size_t>(ft::distance(s1.begin(), s1.lower_bound(key))),
+                  static_cast<size_t>(std::distance(s2.begin(), s2.lower_bound(key))));
+    }
+
+    ft::multiset<int, std::greater<int> > s3(s2.begin(), s2.end());
+    EXPECT_TRUE(s3 == s1);
+    s3.erase(s3.begin());
+    EXPECT_TRUE(s3 != s1);
+    EXPECT_TRUE(s3 < s1);
+    s1.clear();
+    EXPECT_TRUE(s1.begin() == s1.end());
+}
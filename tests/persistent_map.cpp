@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+
+#include "../persistent_map.hpp"
+
+#define VOLUME 1000
+
+typedef ft::persistent_map<int, int>    pmap;
+
+// black height of the subtree, -1 if it breaks a red-black rule
+template <typename NodePtr>
+int black_height(NodePtr node)
+{
+    if (node == NULL)
+        return 1;
+    if (node->color == ft::RED
+        && ((node->left && node->left->color == ft::RED)
+            || (node->right && node->right->color == ft::RED)))
+        return -1;
+    const int left = black_height(node->left);
+    const int right = black_height(node->right);
+    if (left < 0 || left != right)
+        return -1;
+    return left + (node->color == ft::BLACK);
+}
+
+template <typename Map>
+bool is_valid(const Map& m)
+{
+    const typename Map::const_iterator::node_pointer root = m.end().root();
+
+    return (root == NULL || root->color == ft::BLACK) && black_height(root) > 0;
+}
+
+template <typename Map, typename StdMap>
+bool same(const Map& m1, const StdMap& m2)
+{
+    if (m1.size() != m2.size())
+        return false;
+    typename StdMap::const_iterator it2 = m2.begin();
+    for (typename Map::const_iterator it1 = m1.begin(); it1 != m1.end(); ++it1, ++it2)
+        if (it1->first != it2->first || it1->second != it2->second)
+            return false;
+    return true;
+}
+
+
+TEST(persistent_map, updates)
+{
+    pmap                                m1;
+    std::map<int, int>                  m2;
+    std::vector<pmap>                   snapshots;
+    std::vector<std::map<int, int> >    expected;
+
+    std::srand(7);
+    for (int i = 0; i < 8 * VOLUME; ++i)
+    {
+        const int key = std::rand() % VOLUME;
+        switch (std::rand() % 3)
+        {
+            case 0:
+                EXPECT_EQ(m1.insert(ft::make_pair(key, i)).second,
+                          m2.insert(std::make_pair(key, i)).second);
+                break;
+            case 1:
+                EXPECT_EQ(m1.erase(key), m2.erase(key));
+                break;
+            default:
+                EXPECT_EQ(m1.insert_or_assign(key, i).second, m2.count(key) == 0);
+                m2[key] = i;
+        }
+        if (i % 500 == 0)
+        {
+            snapshots.push_back(m1.snapshot());
+            expected.push_back(m2);
+            EXPECT_TRUE(is_valid(m1));
+        }
+    }
+    EXPECT_TRUE(same(m1, m2));
+
+    // older versions are untouched by everything that came after them
+    for (size_t i = 0; i < snapshots.size(); ++i)
+    {
+        EXPECT_TRUE(same(snapshots[i], expected[i]));
+        EXPECT_TRUE(is_valid(snapshots[i]));
+    }
+
+    // until all keys are gone
+    for (int key = 0; key < VOLUME; ++key)
+    {
+        EXPECT_EQ(m1.erase(key), m2.erase(key));
+        if (key % 100 == 0)
+        {
+            EXPECT_TRUE(is_valid(m1));
+        }
+    }
+    EXPECT_TRUE(m1.empty());
+    EXPECT_TRUE(m1.begin() == m1.end());
+    EXPECT_TRUE(same(snapshots.back(), expected.back()));
+}
+
+TEST(persistent_map, lookup)
+{
+    pmap                m1;
+    std::map<int, int>  m2;
+
+    for (int i = 0; i < VOLUME; i += 2)
+    {
+        m1.insert(ft::make_pair(i, i * 3));
+        m2[i] = i * 3;
+    }
+
+    for (int key = -1; key <= VOLUME; ++key)
+    {
+        EXPECT_EQ(std::distance(m1.begin(), m1.lower_bound(key)),
+                  std::distance(m2.begin(), m2.lower_bound(key)));
+        EXPECT_EQ(std::distance(m1.begin(), m1.upper_bound(key)),
+                  std::distance(m2.begin(), m2.upper_bound(key)));
+        EXPECT_EQ(m1.count(key), m2.count(key));
+        if (m2.count(key))
+        {
+            EXPECT_EQ(m1.at(key), m2[key]);
+            EXPECT_EQ(m1.find(key)->second, m2[key]);
+        }
+        else
+        {
+            EXPECT_THROW(m1.at(key), std::out_of_range);
+            EXPECT_TRUE(m1.find(key) == m1.end());
+        }
+    }
+
+    // walking backwards, from end() and from the middle
+    std::map<int, int>::const_reverse_iterator it2 = m2.rbegin();
+    for (pmap::const_reverse_iterator it1 = m1.rbegin(); it1 != m1.rend(); ++it1, ++it2)
+        EXPECT_EQ(it1->first, it2->first);
+    pmap::const_iterator it = m1.find(VOLUME / 2);
+    --it;
+    EXPECT_EQ(it->first, VOLUME / 2 - 2);
+    ++it;
+    ++it;
+    EXPECT_EQ(it->first, VOLUME / 2 + 2);
+
+    pmap m3(m1);
+    EXPECT_TRUE(m3 == m1);
+    m3.insert_or_assign(0, -1);
+    EXPECT_TRUE(m3 < m1);
+    EXPECT_EQ(m1.at(0), 0);
+    ft::swap(m1, m3);
+    EXPECT_EQ(m1.at(0), -1);
+    m3 = m1;
+    EXPECT_TRUE(m3 == m1);
+    m1.clear();
+    EXPECT_TRUE(m1.empty());
+    EXPECT_EQ(m3.at(0), -1);
+}
+
+TEST(persistent_map, concurrent_readers)
+{
+    pmap                m1;
+    std::atomic<int>    errors(0);
+
+    for (int i = 0; i < VOLUME; ++i)
+        m1.insert(ft::make_pair(i, i));
+
+    // every reader owns a snapshot and drops it while the writer goes on
+    // replacing and freeing the nodes the snapshot shares with m1
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r)
+    {
+        pmap snap = m1.snapshot();
+        readers.push_back(std::thread([snap, &errors]() mutable {
+            for (int round = 0; round < 50; ++round)
+            {
+                long    sum = 0;
+                size_t  n = 0;
+                for (pmap::const_iterator it = snap.begin(); it != snap.end(); ++it, ++n)
+                    sum += it->second - it->first;
+                if (sum != 0 || n != static_cast<size_t>(VOLUME))
+                    ++errors;
+            }
+            snap.clear();
+        }));
+    }
+
+    for (int i = 0; i < 20 * VOLUME; ++i)
+    {
+        const int key = i % VOLUME;
+        m1.erase(key);
+        m1.insert(ft::make_pair(key, -key));
+    }
+    for (size_t r = 0; r < readers.size(); ++r)
+        readers[r].join();
+    EXPECT_EQ(errors, 0);
+    EXPECT_EQ(m1.size(), static_cast<size_t>(VOLUME));
+    EXPECT_EQ(m1.at(1), -1);
+}
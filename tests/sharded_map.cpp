@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+
+#include "../sharded_map.hpp"
+
+#define VOLUME 1000
+
+typedef ft::sharded_map<int, int, 8>    hmap;
+typedef ft::sharded_map<int, int, 4, std::less<int>, ft::range_sharding<int> >  rmap;
+
+
+template <typename Map>
+void random_ops(Map& m1)
+{
+    std::map<int, int> m2;
+
+    std::srand(5);
+    for (int i = 0; i < 8 * VOLUME; ++i)
+    {
+        const int key = std::rand() % VOLUME;
+        switch (std::rand() % 3)
+        {
+            case 0:
+                EXPECT_EQ(m1.insert(ft::make_pair(key, i)), m2.insert(std::make_pair(key, i)).second);
+                break;
+            case 1:
+                EXPECT_EQ(m1.erase(key), m2.erase(key));
+                break;
+            default:
+                EXPECT_EQ(m1.insert_or_assign(key, i), m2.count(key) == 0);
+                m2[key] = i;
+        }
+    }
+    EXPECT_EQ(m1.size(), m2.size());
+
+    for (int key = -1; key <= VOLUME; ++key)
+    {
+        int obj = -1;
+        EXPECT_EQ(m1.count(key), m2.count(key));
+        EXPECT_EQ(m1.find(key, obj), m2.count(key) == 1);
+        if (m2.count(key))
+        {
+            EXPECT_EQ(obj, m2[key]);
+            EXPECT_EQ(m1.at(key), m2[key]);
+        }
+        else
+        {
+            EXPECT_THROW(m1.at(key), std::out_of_range);
+        }
+    }
+
+    // the scan merges the shards back in key order
+    {
+        typename Map::scan view(m1);
+        EXPECT_EQ(view.size(), m2.size());
+        std::map<int, int>::iterator it2 = m2.begin();
+        for (typename Map::const_iterator it1 = view.begin(); it1 != view.end(); ++it1, ++it2)
+        {
+            EXPECT_EQ(it1->first, it2->first);
+            EXPECT_EQ(it1->second, it2->second);
+        }
+        EXPECT_TRUE(it2 == m2.end());
+    }
+
+    EXPECT_TRUE(m1.visit(m2.begin()->first, [](ft::pair<const int, int>& val) { val.second = -7; }));
+    EXPECT_EQ(m1.at(m2.begin()->first), -7);
+    EXPECT_FALSE(m1.visit(VOLUME, [](ft::pair<const int, int>&) {}));
+    m1.clear();
+    EXPECT_TRUE(m1.empty());
+    typename Map::scan view(m1);
+    EXPECT_TRUE(view.begin() == view.end());
+}
+
+TEST(sharded_map, hash)
+{
+    hmap m1;
+    random_ops(m1);
+
+    // the hash spreads consecutive keys over all shards
+    ft::hash_sharding<int>  sharding;
+    std::vector<int>        hits(8);
+    for (int key = 0; key < VOLUME; ++key)
+        ++hits[sharding(key, 8)];
+    for (size_t i = 0; i < hits.size(); ++i)
+        EXPECT_GT(hits[i], VOLUME / 16);
+}
+
+TEST(sharded_map, range)
+{
+    const int   splits[] = { VOLUME / 4, VOLUME / 2, 3 * VOLUME / 4 };
+    rmap        m1(ft::range_sharding<int>(splits, splits + 3));
+
+    EXPECT_EQ(m1.sharding()(VOLUME / 4 - 1, 4), 0u);
+    EXPECT_EQ(m1.sharding()(VOLUME / 4, 4), 1u);
+    EXPECT_EQ(m1.sharding()(VOLUME, 4), 3u);
+    random_ops(m1);
+}
+
+TEST(sharded_map, many_threads)
+{
+    const int           threads = 8;
+    hmap                m1;
+    std::atomic<bool>   done(false);
+    std::atomic<int>    errors(0);
+
+    std::thread reader([&]() {
+        while (!done)
+        {
+            hmap::scan  view(m1);
+            int         last = -1;
+            for (hmap::const_iterator it = view.begin(); it != view.end(); ++it)
+            {
+                if (it->first <= last)
+                    ++errors;
+                last = it->first;
+            }
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t)
+        writers.push_back(std::thread([&, t]() {
+            for (int key = t; key < 10 * VOLUME; key += threads)
+                if (!m1.insert(ft::make_pair(key, key)))
+                    ++errors;
+            for (int key = t; key < 10 * VOLUME; key += threads)
+                if (key % 2 && m1.erase(key) != 1)
+                    ++errors;
+        }));
+    for (size_t t = 0; t < writers.size(); ++t)
+        writers[t].join();
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(errors, 0);
+    EXPECT_EQ(m1.size(), static_cast<size_t>(5 * VOLUME));
+}
@@ -0,0 +1,250 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../small_map.hpp"
+
+#define VOLUME 100
+
+
+template <typename SmallMap, typename StdMap>
+bool same_content(const SmallMap& small, const StdMap& std_map)
+{
+    if (small.size() != std_map.size())
+        return false;
+
+    typename SmallMap::const_iterator it = small.begin();
+    typename StdMap::const_iterator sit = std_map.begin();
+    for (; sit != std_map.end(); ++it, ++sit)
+    {
+        if (it->first != sit->first || it->second != sit->second)
+            return false;
+    }
+    return it == small.end();
+}
+
+
+/* std::allocator that counts its allocations, of any type */
+static size_t allocations = 0;
+
+template <typename T>
+struct counting_allocator : public std::allocator<T>
+{
+    template <typename U>
+    struct rebind
+    {
+        typedef counting_allocator<U>   other;
+    };
+
+    counting_allocator() {}
+
+    template <typename U>
+    counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        ++allocations;
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+
+TEST(small_map, inline)
+{
+    ft::small_map<int, std::string, 8> m1;
+    EXPECT_TRUE(m1.empty());
+    EXPECT_TRUE(m1.is_inline());
+    EXPECT_TRUE(m1.begin() == m1.end());
+
+    m1[5] = "five";
+    m1[1] = "one";
+    m1[3] = "three";
+    EXPECT_TRUE(m1.insert(ft::make_pair(7, std::string("seven"))).second);
+    EXPECT_FALSE(m1.insert(ft::make_pair(7, std::string("eight"))).second);
+    EXPECT_EQ(m1.size(), 4);
+    EXPECT_TRUE(m1.is_inline());
+
+    int keys[] = {1, 3, 5, 7};
+    int i = 0;
+    for (ft::small_map<int, std::string, 8>::iterator it = m1.begin(); it != m1.end(); ++it, ++i)
+        EXPECT_EQ(it->first, keys[i]);
+    EXPECT_EQ((--m1.end())->second, "seven");
+    EXPECT_EQ(m1.rbegin()->first, 7);
+
+    EXPECT_EQ(m1.at(3), "three");
+    EXPECT_THROW(m1.at(4), std::out_of_range);
+    EXPECT_EQ(m1.lower_bound(4)->first, 5);
+    EXPECT_EQ(m1.upper_bound(5)->first, 7);
+    EXPECT_TRUE(m1.find(8) == m1.end());
+    EXPECT_EQ(m1.count(1), 1);
+
+    EXPECT_EQ(m1.erase(3), 1);
+    EXPECT_EQ(m1.erase(3), 0);
+    m1.erase(m1.begin());
+    EXPECT_EQ(m1.begin()->first, 5);
+    m1.erase(m1.begin(), m1.end());
+    EXPECT_TRUE(m1.empty());
+}
+
+TEST(small_map, spill)
+{
+    ft::small_map<int, int, 4> m1;
+    std::map<int, int> s1;
+
+    std::srand(7);
+    for (int i = 0; i < VOLUME; ++i)
+    {
+        int key = std::rand() % VOLUME;
+        m1[key] = i;
+        s1[key] = i;
+        if (s1.size() <= 4)
+            EXPECT_TRUE(m1.is_inline());
+        else
+            EXPECT_FALSE(m1.is_inline());
+        ASSERT_TRUE(same_content(m1, s1));
+    }
+
+    for (int i = 0; i < VOLUME; ++i)
+    {
+        int key = std::rand() % VOLUME;
+        EXPECT_EQ(m1.erase(key), s1.erase(key));
+    }
+    EXPECT_TRUE(same_content(m1, s1));
+
+    m1.clear();
+    EXPECT_TRUE(m1.empty());
+    EXPECT_TRUE(m1.is_inline());
+}
+
+TEST(small_map, copy)
+{
+    ft::small_map<std::string, int, 4> m1;
+    m1["a"] = 1;
+    m1["b"] = 2;
+
+    ft::small_map<std::string, int, 4> m2(m1);
+    EXPECT_EQ(m1, m2);
+
+    for (int i = 0; i < 10; ++i)
+        m2[std::to_string(i)] = i;
+    EXPECT_FALSE(m2.is_inline());
+    EXPECT_NE(m1, m2);
+
+    ft::small_map<std::string, int, 4> m3(m2);
+    EXPECT_EQ(m3, m2);
+
+    // one of them inline, the other one spilled
+    m1.swap(m2);
+    EXPECT_EQ(m1, m3);
+    EXPECT_FALSE(m1.is_inline());
+    EXPECT_TRUE(m2.is_inline());
+    EXPECT_EQ(m2["b"], 2);
+
+    m3 = m2;
+    EXPECT_EQ(m3, m2);
+    EXPECT_TRUE(m3.is_inline());
+    EXPECT_TRUE(m1 < m3);
+
+    ft::small_map<std::string, int, 4> m4(m1.begin(), m1.end());
+    EXPECT_EQ(m4, m1);
+}
+
+TEST(small_map, no_allocation)
+{
+    typedef ft::pair<const int, int>                                    value_type;
+    typedef counting_allocator<value_type>                              allocator_type;
+    typedef ft::small_map<int, int, 4, std::less<int>, allocator_type>  small_map_type;
+
+    small_map_type m1;
+    m1[2] = 2;
+    m1[1] = 1;
+
+    const size_t before = allocations;
+    EXPECT_EQ(m1.max_size(), small_map_type::map_type().max_size());
+    const size_t after_map = allocations;
+    EXPECT_GT(after_map, before);
+
+    // neither of them builds a map
+    EXPECT_GT(m1.max_size(), 0u);
+    small_map_type::value_compare comp = m1.value_comp();
+    EXPECT_TRUE(comp(*m1.begin(), *(++m1.begin())));
+    EXPECT_EQ(allocations, after_map);
+    EXPECT_TRUE(m1.is_inline());
+}
+
+/* copying throws once copies_left runs out */
+static int copies_left = -1;
+
+struct fragile
+{
+    int     n;
+
+    fragile(int i = 0) : n(i) {}
+
+    fragile(const fragile& other) : n(other.n)
+    {
+        if (copies_left == 0)
+            throw std::runtime_error("fragile");
+        if (copies_left > 0)
+            --copies_left;
+    }
+
+    fragile& operator=(const fragile& other)
+    {
+        n = other.n;
+        return *this;
+    }
+
+    bool operator==(const fragile& other) const { return n == other.n; }
+};
+
+TEST(small_map, swap)
+{
+    typedef ft::small_map<int, fragile, 4>  small_map_type;
+
+    EXPECT_TRUE((std::is_convertible<small_map_type::iterator, small_map_type::const_iterator>::value));
+    EXPECT_FALSE((std::is_convertible<small_map_type::const_iterator, small_map_type::iterator>::value));
+
+    small_map_type m1;
+    small_map_type m2;
+    for (int i = 0; i < 3; ++i)
+        m1[i] = fragile(i);
+    for (int i = 0; i < 10; ++i)
+        m2[i] = fragile(-i);
+    EXPECT_TRUE(m1.is_inline());
+    EXPECT_FALSE(m2.is_inline());
+
+    // a copy of the inline side throws, neither changes
+    copies_left = 1;
+    EXPECT_THROW(m1.swap(m2), std::runtime_error);
+    copies_left = -1;
+    EXPECT_EQ(m1.size(), 3);
+    EXPECT_EQ(m2.size(), 10);
+    EXPECT_TRUE(m1.is_inline());
+    EXPECT_EQ(m1[2].n, 2);
+    EXPECT_EQ(m2[9].n, -9);
+
+    m2.swap(m1);
+    EXPECT_FALSE(m1.is_inline());
+    EXPECT_TRUE(m2.is_inline());
+    EXPECT_EQ(m1.size(), 10);
+    EXPECT_EQ(m2.size(), 3);
+    EXPECT_EQ(m1[9].n, -9);
+    EXPECT_EQ(m2[2].n, 2);
+
+    // both inline, trivially relocatable elements swap as bytes
+    ft::small_map<int, int, 4> m3;
+    ft::small_map<int, int, 4> m4;
+    m3[1] = 1;
+    m4[2] = 2;
+    m4[3] = 3;
+    m3.swap(m4);
+    EXPECT_EQ(m3.size(), 2);
+    EXPECT_EQ(m4.size(), 1);
+    EXPECT_EQ(m3[3], 3);
+    EXPECT_EQ(m4[1], 1);
+}
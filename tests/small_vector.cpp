@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iterator>
+#include <cstdlib>
+
+#include "../small_vector.hpp"
+#include "../stack.hpp"
+
+#define VOLUME 1000
+
+
+template <typename SmallVector, typename StdVector>
+bool same_content(const SmallVector& small, const StdVector& std_vector)
+{
+    if (small.size() != std_vector.size())
+        return false;
+
+    for (size_t i = 0; i < std_vector.size(); ++i)
+    {
+        if (small[i] != std_vector[i])
+            return false;
+    }
+    return true;
+}
+
+
+TEST(small_vector, inline)
+{
+    ft::small_vector<int, 4> v1;
+    EXPECT_TRUE(v1.empty());
+    EXPECT_TRUE(v1.is_inline());
+    EXPECT_EQ(v1.capacity(), 4);
+
+    const int* data = v1.data();
+    for (int i = 0; i < 4; ++i)
+        v1.push_back(i);
+    EXPECT_TRUE(v1.is_inline());
+    EXPECT_EQ(v1.data(), data);
+
+    // the buffer is inside the object
+    EXPECT_GE(reinterpret_cast<const char*>(data), reinterpret_cast<const char*>(&v1));
+    EXPECT_LT(reinterpret_cast<const char*>(data), reinterpret_cast<const char*>(&v1 + 1));
+
+    v1.push_back(4);
+    EXPECT_FALSE(v1.is_inline());
+    EXPECT_EQ(v1.size(), 5);
+    EXPECT_GE(v1.capacity(), 5);
+    for (int i = 0; i < 5; ++i)
+        EXPECT_EQ(v1[i], i);
+
+    // the heap block stays, like the capacity of a vector
+    v1.clear();
+    EXPECT_FALSE(v1.is_inline());
+
+    ft::small_vector<int, 4> v2(3, 7);
+    EXPECT_TRUE(v2.is_inline());
+    ft::small_vector<int, 4> v3(9, 7);
+    EXPECT_FALSE(v3.is_inline());
+    EXPECT_EQ(v3.capacity(), 9);
+
+    v3.assign(2, 1);
+    EXPECT_EQ(v3.size(), 2);
+    EXPECT_FALSE(v3.is_inline());
+}
+
+TEST(small_vector, copy)
+{
+    ft::small_vector<std::string, 4> v1;
+    v1.push_back("one");
+    v1.push_back("two");
+
+    ft::small_vector<std::string, 4> v2(v1);
+    EXPECT_TRUE(v2.is_inline());
+    EXPECT_NE(v2.data(), v1.data());
+    EXPECT_TRUE(v1 == v2);
+
+    for (int i = 0; i < 10; ++i)
+        v1.push_back(std::to_string(i));
+
+    ft::small_vector<std::string, 4> v3(v1);
+    EXPECT_FALSE(v3.is_inline());
+    EXPECT_TRUE(v1 == v3);
+
+    v2 = v1;
+    EXPECT_TRUE(v1 == v2);
+    v3 = ft::small_vector<std::string, 4>(1, "x");
+    EXPECT_EQ(v3.size(), 1);
+    EXPECT_EQ(v3[0], "x");
+
+    // an input iterator in the middle, single pass
+    std::istringstream in("a b c");
+    v3.insert(v3.begin(), std::istream_iterator<std::string>(in),
+                std::istream_iterator<std::string>());
+    EXPECT_EQ(v3.size(), 4);
+    EXPECT_EQ(v3[0], "a");
+    EXPECT_EQ(v3[2], "c");
+    EXPECT_EQ(v3[3], "x");
+}
+
+/* every combination of inline and heap */
+TEST(small_vector, swap)
+{
+    for (int left = 0; left < 8; ++left)
+    {
+        for (int right = 0; right < 8; ++right)
+        {
+            ft::small_vector<std::string, 3> v1;
+            ft::small_vector<std::string, 3> v2;
+            std::vector<std::string> s1;
+            std::vector<std::string> s2;
+
+            for (int i = 0; i < left; ++i)
+            {
+                v1.push_back("l" + std::to_string(i));
+                s1.push_back("l" + std::to_string(i));
+            }
+            for (int i = 0; i < right; ++i)
+            {
+                v2.push_back("r" + std::to_string(i));
+                s2.push_back("r" + std::to_string(i));
+            }
+
+            ft::swap(v1, v2);
+            EXPECT_TRUE(same_content(v1, s2));
+            EXPECT_TRUE(same_content(v2, s1));
+
+            v1.swap(v2);
+            EXPECT_TRUE(same_content(v1, s1));
+            EXPECT_TRUE(same_content(v2, s2));
+        }
+    }
+}
+
+TEST(small_vector, random_ops)
+{
+    ft::small_vector<int, 16> v;
+    std::vector<int> s;
+
+    srand(42);
+    for (int i = 0; i < VOLUME * 10; ++i)
+    {
+        const int op = rand() % 8;
+        const int val = rand() % VOLUME;
+
+        if (op < 3)
+        {
+            v.push_back(val);
+            s.push_back(val);
+        }
+        else if (op == 3 && !s.empty())
+        {
+            v.pop_back();
+            s.pop_back();
+        }
+        else if (op == 4)
+        {
+            const size_t pos = rand() % (s.size() + 1);
+            v.insert(v.begin() + pos, 2, val);
+            s.insert(s.begin() + pos, 2, val);
+        }
+        else if (op == 5 && !s.empty())
+        {
+            const size_t first = rand() % s.size();
+            const size_t last = first + rand() % (s.size() - first + 1);
+            v.erase(v.begin() + first, v.begin() + last);
+            s.erase(s.begin() + first, s.begin() + last);
+        }
+        else if (op == 6 && !s.empty())
+        {
+            const size_t pos = rand() % s.size();
+            v.erase(v.begin() + pos);
+            s.erase(s.begin() + pos);
+        }
+        else if (op == 7)
+        {
+            const size_t n = rand() % 40;
+            v.resize(n, val);
+            s.resize(n, val);
+        }
+        ASSERT_TRUE(same_content(v, s));
+    }
+}
+
+TEST(small_vector, stack)
+{
+    ft::stack<int, ft::small_vector<int, 8> > st;
+
+    for (int i = 0; i < 20; ++i)
+        st.push(i);
+    EXPECT_EQ(st.size(), 20);
+    EXPECT_EQ(st.top(), 19);
+    while (st.size() > 1)
+        st.pop();
+    EXPECT_EQ(st.top(), 0);
+}
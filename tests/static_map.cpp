@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <string_view>
+
+#include "../static_map.hpp"
+
+#define VOLUME 1000
+
+namespace {
+
+    int on_if() { return 1; }
+    int on_else() { return 2; }
+    int on_while() { return 3; }
+    int on_return() { return 4; }
+
+    typedef int (*handler)();
+
+    // sorted and hashed while compiling, read-only data at run time
+    constexpr auto keywords = ft::make_static_map<std::string_view, handler>({
+        { "while", &on_while }, { "if", &on_if }, { "return", &on_return }, { "else", &on_else }
+    });
+
+    constexpr auto hashed_keywords = ft::make_static_unordered_map<std::string_view, handler>({
+        { "while", &on_while }, { "if", &on_if }, { "return", &on_return }, { "else", &on_else }
+    });
+
+    constexpr auto squares = ft::make_static_map<int, int, std::greater<int> >({
+        { 3, 9 }, { -2, 4 }, { 5, 25 }, { 0, 0 }, { 7, 49 }
+    });
+
+    // a larger table, the perfect hash has to work for it
+    template <size_t N>
+    constexpr ft::static_unordered_map<int, int, N> make_cubes()
+    {
+        ft::pair<int, int> values[N] = {};
+        for (size_t i = 0; i < N; ++i)
+            values[i] = ft::pair<int, int>(static_cast<int>(i * 7919 % 100003), static_cast<int>(i));
+        return ft::static_unordered_map<int, int, N>(values);
+    }
+
+    constexpr auto big = make_cubes<300>();
+}
+
+// lookups are constant expressions too
+static_assert(keywords.size() == 4, "");
+static_assert(keywords.count("if") == 1 && keywords.count("for") == 0, "");
+static_assert(keywords.begin()->first == "else", "sorted at compile time");
+static_assert(squares.at(5) == 25 && squares.begin()->first == 7, "");
+static_assert(hashed_keywords.count("return") == 1 && hashed_keywords.count("x") == 0, "");
+static_assert(big.at(7919) == 1, "");
+
+TEST(static_map, sorted)
+{
+    std::string seen;
+    for (auto it = keywords.begin(); it != keywords.end(); ++it)
+        seen += std::string(it->first) + " ";
+    EXPECT_EQ(seen, "else if return while ");
+
+    EXPECT_EQ(keywords.at("while")(), 3);
+    EXPECT_EQ(keywords.find("return")->second(), 4);
+    EXPECT_TRUE(keywords.find("for") == keywords.end());
+    EXPECT_THROW(keywords.at("for"), std::out_of_range);
+    EXPECT_EQ(keywords.lower_bound("f")->first, "if");
+    EXPECT_EQ(keywords.upper_bound("if")->first, "return");
+    EXPECT_TRUE(keywords.upper_bound("while") == keywords.end());
+
+    int previous = 1000;
+    for (auto it = squares.begin(); it != squares.end(); ++it)
+    {
+        EXPECT_LT(it->first, previous);
+        EXPECT_EQ(it->second, it->first * it->first);
+        previous = it->first;
+    }
+    EXPECT_EQ(squares.count(1), 0u);
+}
+
+TEST(static_map, perfect_hash)
+{
+    EXPECT_EQ(hashed_keywords.at("if")(), 1);
+    EXPECT_EQ(hashed_keywords.at("else")(), 2);
+    EXPECT_THROW(hashed_keywords.at("els"), std::out_of_range);
+    // kept in the order given
+    EXPECT_EQ(hashed_keywords.begin()->first, "while");
+
+    std::map<int, int> expected;
+    for (int i = 0; i < 300; ++i)
+        expected[i * 7919 % 100003] = i;
+    for (int key = -1; key < 100003; key += 1 + (key % 13 == 0) * VOLUME)
+    {
+        EXPECT_EQ(big.count(key), expected.count(key));
+    }
+    for (std::map<int, int>::iterator it = expected.begin(); it != expected.end(); ++it)
+        EXPECT_EQ(big.at(it->first), it->second);
+
+    // built at run time the same way
+    ft::pair<int, int> values[] = { { 10, 1 }, { 20, 2 }, { 30, 3 } };
+    ft::static_unordered_map<int, int, 3> runtime(values);
+    EXPECT_EQ(runtime.at(20), 2);
+    EXPECT_EQ(runtime.count(40), 0u);
+    ft::pair<int, int> twice[] = { { 10, 1 }, { 10, 2 } };
+    EXPECT_THROW((ft::static_unordered_map<int, int, 2>(twice)), std::logic_error);
+    EXPECT_THROW((ft::static_map<int, int, 2>(twice)), std::logic_error);
+}
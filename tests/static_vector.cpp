@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+
+#include "../static_vector.hpp"
+#include "../stack.hpp"
+
+#define VOLUME 1000
+
+
+TEST(static_vector, fixed)
+{
+    ft::static_vector<std::string, 8> v1;
+    EXPECT_TRUE(v1.empty());
+    EXPECT_EQ(v1.capacity(), 8);
+    EXPECT_EQ(v1.max_size(), 8);
+
+    const std::string* data = v1.data();
+    for (int i = 0; i < 8; ++i)
+        v1.push_back("a rather long string, past the small string buffer " + std::to_string(i));
+    EXPECT_EQ(v1.size(), 8);
+    EXPECT_FALSE(v1.has_room());
+
+    // nothing ever moves, the buffer is inside the object
+    EXPECT_EQ(v1.data(), data);
+    EXPECT_GE(reinterpret_cast<const char*>(data), reinterpret_cast<const char*>(&v1));
+    EXPECT_LT(reinterpret_cast<const char*>(data), reinterpret_cast<const char*>(&v1 + 1));
+
+    v1.erase(v1.begin() + 2, v1.begin() + 5);
+    EXPECT_EQ(v1.size(), 5);
+    EXPECT_EQ(v1[2].substr(v1[2].size() - 1), "5");
+    EXPECT_TRUE(v1.has_room(3));
+    EXPECT_FALSE(v1.has_room(4));
+
+    ft::static_vector<std::string, 8> v2(v1);
+    EXPECT_TRUE(v1 == v2);
+    EXPECT_NE(v2.data(), v1.data());
+
+    ft::static_vector<int, 4> v3(3, 7);
+    ft::static_vector<int, 4> v4(v3.begin(), v3.end());
+    EXPECT_TRUE(v3 == v4);
+    v4.back() = 8;
+    EXPECT_TRUE(v3 < v4);
+}
+
+TEST(static_vector, overflow)
+{
+    ft::static_vector<int, 4> v1(4, 1);
+
+    EXPECT_THROW(v1.push_back(2), std::length_error);
+    EXPECT_THROW(v1.insert(v1.begin(), 2), std::length_error);
+    EXPECT_THROW(v1.insert(v1.begin(), 3, 2), std::length_error);
+    EXPECT_THROW(v1.resize(5), std::length_error);
+    EXPECT_THROW(v1.reserve(5), std::length_error);
+    // the vector stays as it was
+    EXPECT_EQ(v1.size(), 4);
+    typedef ft::static_vector<int, 4> vector4;
+    EXPECT_TRUE(v1 == vector4(4, 1));
+
+    v1.pop_back();
+    std::istringstream in("5 6");
+    EXPECT_THROW(v1.insert(v1.begin(), std::istream_iterator<int>(in),
+                            std::istream_iterator<int>()), std::length_error);
+    EXPECT_EQ(v1.size(), 3);
+    EXPECT_EQ(v1[0], 1);
+
+    EXPECT_THROW(vector4(5, 1), std::length_error);
+    std::vector<int> s(5, 1);
+    EXPECT_THROW(vector4(s.begin(), s.end()), std::length_error);
+    EXPECT_NO_THROW(v1.reserve(4));
+}
+
+TEST(static_vector, assert_on_overflow)
+{
+    ft::static_vector<int, 2, ft::assert_on_overflow> v1;
+
+    v1.push_back(1);
+    v1.push_back(2);
+    EXPECT_EQ(v1.size(), 2);
+    EXPECT_DEATH(v1.push_back(3), "");
+}
+
+TEST(static_vector, random_ops)
+{
+    ft::static_vector<int, 64> v;
+    std::vector<int> s;
+
+    srand(42);
+    for (int i = 0; i < VOLUME * 10; ++i)
+    {
+        const int op = rand() % 6;
+        const int val = rand() % VOLUME;
+
+        if (op < 2)
+        {
+            if (s.size() < 64)
+            {
+                v.push_back(val);
+                s.push_back(val);
+            }
+            else
+                ASSERT_THROW(v.push_back(val), std::length_error);
+        }
+        else if (op == 2 && !s.empty())
+        {
+            v.pop_back();
+            s.pop_back();
+        }
+        else if (op == 3 && s.size() + 2 <= 64)
+        {
+            const size_t pos = rand() % (s.size() + 1);
+            v.insert(v.begin() + pos, 2, val);
+            s.insert(s.begin() + pos, 2, val);
+        }
+        else if (op == 4 && !s.empty())
+        {
+            const size_t first = rand() % s.size();
+            const size_t last = first + rand() % (s.size() - first + 1);
+            v.erase(v.begin() + first, v.begin() + last);
+            s.erase(s.begin() + first, s.begin() + last);
+        }
+        else if (op == 5)
+        {
+            const size_t n = rand() % 64;
+            v.resize(n, val);
+            s.resize(n, val);
+        }
+        ASSERT_EQ(v.size(), s.size());
+        ASSERT_TRUE(std::equal(s.begin(), s.end(), v.begin()));
+    }
+}
+
+TEST(static_vector, swap)
+{
+    ft::static_vector<std::string, 8> v1(3, "one");
+    ft::static_vector<std::string, 8> v2(6, "two");
+
+    ft::swap(v1, v2);
+    EXPECT_EQ(v1.size(), 6);
+    EXPECT_EQ(v2.size(), 3);
+    EXPECT_EQ(v1[5], "two");
+    EXPECT_EQ(v2[2], "one");
+}
+
+TEST(static_vector, stack)
+{
+    ft::stack<int, ft::static_vector<int, 16> > st;
+
+    for (int i = 0; i < 16; ++i)
+        st.push(i);
+    EXPECT_EQ(st.size(), 16);
+    EXPECT_EQ(st.top(), 15);
+    EXPECT_THROW(st.push(16), std::length_error);
+
+    ft::stack<int, ft::static_vector<int, 16> > copy(st);
+    EXPECT_TRUE(copy == st);
+    while (!st.empty())
+        st.pop();
+    EXPECT_EQ(copy.top(), 15);
+}
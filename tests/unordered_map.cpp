@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <unordered_map>
+#include <string>
+#include <cstdlib>
+#include <type_traits>
+
+#include "../unordered_map.hpp"
+
+#define VOLUME 1000
+
+
+template <typename Map, typename StdMap>
+bool same(const Map& m1, const StdMap& m2)
+{
+    size_t n = 0;
+
+    if (m1.size() != m2.size())
+        return false;
+    for (typename Map::const_iterator it = m1.begin(); it != m1.end(); ++it, ++n)
+    {
+        typename StdMap::const_iterator other = m2.find(it->first);
+        if (other == m2.end() || other->second != it->second)
+            return false;
+    }
+    return n == m2.size();
+}
+
+TEST(unordered_map, random_ops)
+{
+    ft::unordered_map<int, int>     m1;
+    std::unordered_map<int, int>    m2;
+
+    std::srand(3);
+    for (int i = 0; i < 20 * VOLUME; ++i)
+    {
+        const int key = std::rand() % (2 * VOLUME);
+        switch (std::rand() % 3)
+        {
+            case 0:
+                EXPECT_EQ(m1.insert(ft::make_pair(key, i)).second,
+                          m2.insert(std::make_pair(key, i)).second);
+                break;
+            case 1:
+                EXPECT_EQ(m1.erase(key), m2.erase(key));
+                break;
+            default:
+                m1[key] = i;
+                m2[key] = i;
+        }
+    }
+    EXPECT_TRUE(same(m1, m2));
+    EXPECT_LE(m1.load_factor(), m1.max_load_factor());
+
+    for (int key = -1; key <= 2 * VOLUME; ++key)
+    {
+        EXPECT_EQ(m1.count(key), m2.count(key));
+        if (m2.count(key))
+        {
+            EXPECT_EQ(m1.at(key), m2[key]);
+            EXPECT_EQ(m1.find(key)->second, m2[key]);
+            EXPECT_EQ(std::distance(m1.equal_range(key).first, m1.equal_range(key).second), 1);
+        }
+        else
+        {
+            EXPECT_THROW(m1.at(key), std::out_of_range);
+            EXPECT_TRUE(m1.find(key) == m1.end());
+        }
+    }
+
+    // erase while walking, erase doesn't move anything
+    for (ft::unordered_map<int, int>::iterator it = m1.begin(); it != m1.end(); )
+    {
+        if (it->first % 2)
+        {
+            m2.erase(it->first);
+            it = m1.erase(it);
+        }
+        else
+            ++it;
+    }
+    EXPECT_TRUE(same(m1, m2));
+
+    ft::unordered_map<int, int> m3(m1);
+    EXPECT_TRUE(m3 == m1);
+    m3[-1] = 0;
+    EXPECT_TRUE(m3 != m1);
+    m3.erase(m3.begin(), m3.end());
+    EXPECT_TRUE(m3.empty());
+    EXPECT_TRUE(m3.begin() == m3.end());
+    ft::swap(m1, m3);
+    EXPECT_TRUE(m1.empty());
+    EXPECT_TRUE(same(m3, m2));
+    m1 = m3;
+    EXPECT_TRUE(same(m1, m2));
+    m1.clear();
+    EXPECT_TRUE(m1.empty());
+    EXPECT_TRUE(m1.begin() == m1.end());
+}
+
+TEST(unordered_map, tables)
+{
+    // empty tables own no memory and still answer
+    ft::unordered_map<int, int> m1;
+    EXPECT_EQ(m1.bucket_count(), 0u);
+    EXPECT_TRUE(m1.find(0) == m1.end());
+    EXPECT_EQ(m1.erase(0), 0u);
+    EXPECT_TRUE(m1.begin() == m1.end());
+
+    m1.reserve(VOLUME);
+    const size_t buckets = m1.bucket_count();
+    EXPECT_GE(buckets * 7 / 8, static_cast<size_t>(VOLUME));
+    for (int i = 0; i < VOLUME; ++i)
+        m1[i] = i;
+    EXPECT_EQ(m1.bucket_count(), buckets);
+
+    // churn at a constant size: the overflow bits of erased keys can only
+    // lower the load limit, rehashes keep the table from growing
+    for (int i = VOLUME; i < 50 * VOLUME; ++i)
+    {
+        m1.erase(i - VOLUME);
+        m1[i] = i;
+    }
+    EXPECT_EQ(m1.size(), static_cast<size_t>(VOLUME));
+    EXPECT_LE(m1.bucket_count(), 2 * buckets);
+    for (int i = 49 * VOLUME; i < 50 * VOLUME; ++i)
+        EXPECT_EQ(m1.at(i), i);
+
+    m1.rehash(0);
+    EXPECT_LT(m1.bucket_count(), 2 * static_cast<size_t>(VOLUME));
+    EXPECT_EQ(m1.size(), static_cast<size_t>(VOLUME));
+
+    // values that can't be moved with memcpy go through copies
+    ft::unordered_map<std::string, std::string>    m2;
+    std::unordered_map<std::string, std::string>   m3;
+    for (int i = 0; i < VOLUME; ++i)
+    {
+        const std::string key = "a long enough key to live on the heap " + std::to_string(i);
+        m2[key] = key;
+        m3[key] = key;
+    }
+    EXPECT_TRUE(same(m2, m3));
+}
+
+TEST(unordered_map, iterators)
+{
+    typedef ft::unordered_map<int, int>     map_type;
+
+    // iterator to const_iterator, never the way back
+    EXPECT_TRUE((std::is_convertible<map_type::iterator, map_type::const_iterator>::value));
+    EXPECT_FALSE((std::is_convertible<map_type::const_iterator, map_type::iterator>::value));
+
+    map_type m1;
+    m1[1] = 1;
+    map_type::const_iterator cit = m1.begin();
+    EXPECT_TRUE(cit == m1.begin());
+    EXPECT_EQ(cit->second, 1);
+}
+
+TEST(unordered_map, group_match)
+{
+    ft::swiss_group group;
+
+    std::srand(9);
+    for (int round = 0; round < VOLUME; ++round)
+    {
+        for (int i = 0; i < 16; ++i)
+            group.bytes[i] = (std::rand() % 2) ? 0 : 0x80 | (std::rand() % 4);
+        for (int c = 0; c < 256; ++c)
+        {
+            EXPECT_EQ(group.match(c), group.match_scalar(c));
+        }
+    }
+}
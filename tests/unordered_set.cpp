@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <cstdlib>
+
+#include "../unordered_set.hpp"
+
+#define VOLUME 1000
+
+
+TEST(unordered_set, random_ops)
+{
+    ft::unordered_set<int>  s1;
+    std::set<int>           s2;
+
+    std::srand(4);
+    for (int i = 0; i < 10 * VOLUME; ++i)
+    {
+        const int key = std::rand() % VOLUME;
+        if (std::rand() % 2)
+        {
+            EXPECT_EQ(s1.insert(key).second, s2.insert(key).second);
+            EXPECT_EQ(*s1.find(key), key);
+        }
+        else
+        {
+            EXPECT_EQ(s1.erase(key), s2.erase(key));
+        }
+    }
+    EXPECT_EQ(s1.size(), s2.size());
+    std::set<int> walked(s1.begin(), s1.end());
+    EXPECT_TRUE(walked == s2);
+
+    ft::unordered_set<int> s3(s2.begin(), s2.end());
+    EXPECT_TRUE(s3 == s1);
+    s3.erase(*s2.begin());
+    EXPECT_TRUE(s3 != s1);
+    s1.clear();
+    EXPECT_TRUE(s1.begin() == s1.end());
+}
@@ -240,6 +240,9 @@ TEST(vector, erase)
 
     v1.erase(v1.begin() + 2, v1.end() - 2);
     EXPECT_EQ(v1.size(), 4);
+    EXPECT_EQ(v1[1], 2);
+    EXPECT_EQ(v1[2], 8);
+    EXPECT_EQ(v1[3], 9);
 
     while (!v1.empty())
         v1.erase(v1.begin());
@@ -172,6 +172,48 @@ namespace ft {
 	struct are_same<T, T> : public true_type {};
 
 
+	/* true if a const T offers compare(const T&) like std::string, with
+		a signed integral result. a compare() returning a bool or anything
+		else may not follow the strcmp convention and is ignored, such a
+		type can specialize three_way_traits instead. the expression inside
+		decltype is never evaluated, only checked for validity (see the
+		SFINAE links in the README) */
+	template <typename T>
+	struct has_compare_member
+	{
+		typedef char			yes[1];
+		typedef char			no[2];
+
+		template <typename U>
+		static U&	make();
+
+		template <typename R>
+		struct is_result
+			: public integral_constant<bool, std::is_integral<R>::value && std::is_signed<R>::value>
+		{};
+
+		template <typename U>
+		static yes&	test(typename enable_if<is_result<
+						decltype(make<const U>().compare(make<const U>()))>::value>::type*);
+
+		template <typename U>
+		static no&	test(...);
+
+		static const bool	value = sizeof(test<T>(0)) == sizeof(yes);
+	};
+
+	template <typename T>
+	const bool has_compare_member<T>::value;
+
+	/* true if an object can be moved to another address by copying its
+		bytes and forgetting the original. std::is_trivially_copyable is the
+		safe default, specialize it for types that are relocatable anyway */
+	template <typename T>
+	struct is_trivially_relocatable
+		: public integral_constant<bool, std::is_trivially_copyable<T>::value>
+	{};
+
+
 
 
 
@@ -0,0 +1,206 @@
+#ifndef UNORDERED_MAP_HPP
+# define UNORDERED_MAP_HPP
+
+#include <functional>	// std::hash, std::equal_to
+#include <memory>		// std::allocator
+#include <stdexcept>	// std::out_of_range
+
+#include "swiss_table.hpp"
+
+/*
+    A hash map on the Swiss table of swiss_table.hpp, the interface of
+    std::unordered_map without the bucket interface: the table has no
+    buckets to hand out, bucket_count() is the number of slots.
+
+    The values live in the slots themselves, a rehash moves them:
+    growing invalidates every iterator and reference, erase only the ones
+    to the erased element.
+*/
+
+namespace ft {
+
+	template <typename Key, typename T, typename Hash = std::hash<Key>,
+				typename KeyEqual = std::equal_to<Key>,
+				typename Allocator = std::allocator<ft::pair<const Key, T> > >
+	class unordered_map
+	{
+		public:
+			typedef Key													key_type;
+			typedef T													mapped_type;
+			typedef ft::pair<const Key, T>								value_type;
+			typedef Hash												hasher;
+			typedef KeyEqual											key_equal;
+			typedef Allocator											allocator_type;
+			typedef typename allocator_type::reference					reference;
+			typedef typename allocator_type::const_reference			const_reference;
+			typedef typename allocator_type::pointer					pointer;
+			typedef typename allocator_type::const_pointer				const_pointer;
+			typedef typename allocator_type::size_type					size_type;
+			typedef typename allocator_type::difference_type			difference_type;
+
+		private:
+			typedef swiss_table<value_type, key_type, select_first<value_type>,
+								hasher, key_equal, allocator_type>		table_type;
+
+		public:
+			typedef typename table_type::iterator						iterator;
+			typedef typename table_type::const_iterator					const_iterator;
+
+		private:
+			table_type		table_;
+
+		public:
+			explicit unordered_map(size_type n = 0, const Hash& hash = Hash(),
+									const KeyEqual& eq = KeyEqual(),
+									const Allocator& alloc = Allocator())
+				: table_(n, hash, eq, alloc)
+			{}
+
+			template <typename InputIt>
+			unordered_map(InputIt first, InputIt last, size_type n = 0,
+							const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual(),
+							const Allocator& alloc = Allocator())
+				: table_(n, hash, eq, alloc)
+			{
+				insert(first, last);
+			}
+
+			iterator begin() { return table_.begin(); }
+
+			const_iterator begin() const { return table_.begin(); }
+
+			iterator end() { return table_.end(); }
+
+			const_iterator end() const { return table_.end(); }
+
+			bool empty() const { return table_.empty(); }
+
+			size_type size() const { return table_.size(); }
+
+			size_type max_size() const { return table_.max_size(); }
+
+			mapped_type& operator[](const key_type& key)
+			{
+				iterator it = table_.find(key);
+
+				if (it == end())
+					it = table_.insert(value_type(key, mapped_type())).first;
+				return it->second;
+			}
+
+			mapped_type& at(const key_type& key)
+			{
+				iterator it = table_.find(key);
+
+				if (it == end())
+					throw std::out_of_range("ft::unordered_map");
+				return it->second;
+			}
+
+			const mapped_type& at(const key_type& key) const
+			{
+				const_iterator it = table_.find(key);
+
+				if (it == end())
+					throw std::out_of_range("ft::unordered_map");
+				return it->second;
+			}
+
+			ft::pair<iterator, bool> insert(const value_type& val) { return table_.insert(val); }
+
+			iterator insert(const_iterator, const value_type& val) { return table_.insert(val).first; }
+
+			template <typename InputIt>
+			void insert(InputIt first, InputIt last)
+			{
+				for (; first != last; ++first)
+					table_.insert(*first);
+			}
+
+			iterator erase(const_iterator position) { return table_.erase(position); }
+
+			iterator erase(const_iterator first, const_iterator last)
+			{
+				while (first != last)
+					first = table_.erase(first);
+				return iterator(last.ctrl(), last.slot());
+			}
+
+			size_type erase(const key_type& key) { return table_.erase(key); }
+
+			void clear() { table_.clear(); }
+
+			void swap(unordered_map& other) { table_.swap(other.table_); }
+
+			iterator find(const key_type& key) { return table_.find(key); }
+
+			const_iterator find(const key_type& key) const { return table_.find(key); }
+
+			size_type count(const key_type& key) const { return table_.count(key); }
+
+			ft::pair<iterator, iterator> equal_range(const key_type& key)
+			{
+				iterator it = find(key);
+
+				return ft::make_pair(it, (it == end()) ? it : ++iterator(it));
+			}
+
+			ft::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+			{
+				const_iterator it = find(key);
+
+				return ft::make_pair(it, (it == end()) ? it : ++const_iterator(it));
+			}
+
+			size_type bucket_count() const { return table_.bucket_count(); }
+
+			float load_factor() const { return table_.load_factor(); }
+
+			float max_load_factor() const { return table_.max_load_factor(); }
+
+			void rehash(size_type n) { table_.rehash(n); }
+
+			void reserve(size_type n) { table_.reserve(n); }
+
+			hasher hash_function() const { return table_.hash_function(); }
+
+			key_equal key_eq() const { return table_.key_eq(); }
+
+			allocator_type get_allocator() const { return table_.get_allocator(); }
+	};
+
+	/* the same elements, whatever their order */
+	template <typename Key, typename T, typename Hash, typename KeyEqual, typename Alloc>
+	bool operator==(const unordered_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+					const unordered_map<Key, T, Hash, KeyEqual, Alloc>& rhs)
+	{
+		if (lhs.size() != rhs.size())
+			return false;
+		for (typename unordered_map<Key, T, Hash, KeyEqual, Alloc>::const_iterator it = lhs.begin();
+				it != lhs.end(); ++it)
+		{
+			typename unordered_map<Key, T, Hash, KeyEqual, Alloc>::const_iterator other
+				= rhs.find(it->first);
+			if (other == rhs.end() || !(other->second == it->second))
+				return false;
+		}
+		return true;
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual, typename Alloc>
+	bool operator!=(const unordered_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+					const unordered_map<Key, T, Hash, KeyEqual, Alloc>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual, typename Alloc>
+	void swap(unordered_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+				unordered_map<Key, T, Hash, KeyEqual, Alloc>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+
+} // namespace ft
+
+#endif // UNORDERED_MAP_HPP
@@ -0,0 +1,159 @@
+#ifndef UNORDERED_SET_HPP
+# define UNORDERED_SET_HPP
+
+#include <functional>	// std::hash, std::equal_to
+#include <memory>		// std::allocator
+
+#include "swiss_table.hpp"
+
+/*
+    The set of unordered_map.hpp, on the same Swiss table. Elements are
+    keys, both iterators are const.
+*/
+
+namespace ft {
+
+	template <typename Key, typename Hash = std::hash<Key>,
+				typename KeyEqual = std::equal_to<Key>,
+				typename Allocator = std::allocator<Key> >
+	class unordered_set
+	{
+		public:
+			typedef Key													key_type;
+			typedef Key													value_type;
+			typedef Hash												hasher;
+			typedef KeyEqual											key_equal;
+			typedef Allocator											allocator_type;
+			typedef typename allocator_type::reference					reference;
+			typedef typename allocator_type::const_reference			const_reference;
+			typedef typename allocator_type::pointer					pointer;
+			typedef typename allocator_type::const_pointer				const_pointer;
+			typedef typename allocator_type::size_type					size_type;
+			typedef typename allocator_type::difference_type			difference_type;
+
+		private:
+			typedef swiss_table<value_type, key_type, identity<value_type>,
+								hasher, key_equal, allocator_type>		table_type;
+
+		public:
+			typedef typename table_type::const_iterator					iterator;
+			typedef typename table_type::const_iterator					const_iterator;
+
+		private:
+			table_type		table_;
+
+		public:
+			explicit unordered_set(size_type n = 0, const Hash& hash = Hash(),
+									const KeyEqual& eq = KeyEqual(),
+									const Allocator& alloc = Allocator())
+				: table_(n, hash, eq, alloc)
+			{}
+
+			template <typename InputIt>
+			unordered_set(InputIt first, InputIt last, size_type n = 0,
+							const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual(),
+							const Allocator& alloc = Allocator())
+				: table_(n, hash, eq, alloc)
+			{
+				insert(first, last);
+			}
+
+			const_iterator begin() const { return table_.begin(); }
+
+			const_iterator end() const { return table_.end(); }
+
+			bool empty() const { return table_.empty(); }
+
+			size_type size() const { return table_.size(); }
+
+			size_type max_size() const { return table_.max_size(); }
+
+			ft::pair<iterator, bool> insert(const value_type& val)
+			{
+				ft::pair<typename table_type::iterator, bool> res = table_.insert(val);
+
+				return ft::make_pair(const_iterator(res.first), res.second);
+			}
+
+			iterator insert(const_iterator, const value_type& val) { return insert(val).first; }
+
+			template <typename InputIt>
+			void insert(InputIt first, InputIt last)
+			{
+				for (; first != last; ++first)
+					table_.insert(*first);
+			}
+
+			iterator erase(const_iterator position) { return table_.erase(position); }
+
+			iterator erase(const_iterator first, const_iterator last)
+			{
+				while (first != last)
+					first = table_.erase(first);
+				return last;
+			}
+
+			size_type erase(const key_type& key) { return table_.erase(key); }
+
+			void clear() { table_.clear(); }
+
+			void swap(unordered_set& other) { table_.swap(other.table_); }
+
+			const_iterator find(const key_type& key) const { return table_.find(key); }
+
+			size_type count(const key_type& key) const { return table_.count(key); }
+
+			ft::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+			{
+				const_iterator it = find(key);
+
+				return ft::make_pair(it, (it == end()) ? it : ++const_iterator(it));
+			}
+
+			size_type bucket_count() const { return table_.bucket_count(); }
+
+			float load_factor() const { return table_.load_factor(); }
+
+			float max_load_factor() const { return table_.max_load_factor(); }
+
+			void rehash(size_type n) { table_.rehash(n); }
+
+			void reserve(size_type n) { table_.reserve(n); }
+
+			hasher hash_function() const { return table_.hash_function(); }
+
+			key_equal key_eq() const { return table_.key_eq(); }
+
+			allocator_type get_allocator() const { return table_.get_allocator(); }
+	};
+
+	template <typename Key, typename Hash, typename KeyEqual, typename Alloc>
+	bool operator==(const unordered_set<Key, Hash, KeyEqual, Alloc>& lhs,
+					const unordered_set<Key, Hash, KeyEqual, Alloc>& rhs)
+	{
+		if (lhs.size() != rhs.size())
+			return false;
+		for (typename unordered_set<Key, Hash, KeyEqual, Alloc>::const_iterator it = lhs.begin();
+				it != lhs.end(); ++it)
+			if (rhs.count(*it) == 0)
+				return false;
+		return true;
+	}
+
+	template <typename Key, typename Hash, typename KeyEqual, typename Alloc>
+	bool operator!=(const unordered_set<Key, Hash, KeyEqual, Alloc>& lhs,
+					const unordered_set<Key, Hash, KeyEqual, Alloc>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <typename Key, typename Hash, typename KeyEqual, typename Alloc>
+	void swap(unordered_set<Key, Hash, KeyEqual, Alloc>& lhs,
+				unordered_set<Key, Hash, KeyEqual, Alloc>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+
+} // namespace ft
+
+#endif // UNORDERED_SET_HPP
@@ -3,6 +3,8 @@
 
 #include <utility>
 
+#include "type_traits.hpp"
+
 namespace ft {
 
 	// everything in a struct is public
@@ -17,27 +19,28 @@ namespace ft {
 		T1			first;
 		T2			second;
 
-		/* methods */
-		pair()
+		/* methods, constexpr so tables of pairs can be built at compile
+			time (see static_map.hpp) */
+		constexpr pair()
 			: first(), second()
 		{}
 
-		pair(const first_type &_a, const second_type &_b)
+		constexpr pair(const first_type &_a, const second_type &_b)
 		: first(_a), second(_b)
 		{}
 
 		template <typename U, typename V>
-		pair(const pair<U,V> &_p) : first(_p.first), second(_p.second)
+		constexpr pair(const pair<U,V> &_p) : first(_p.first), second(_p.second)
 		{}
 
 		/* copy constructor
 			is defaulted (until C++11 it's implicitly declared) */
-		pair(const pair &p) : first(p.first), second(p.second)
+		constexpr pair(const pair &p) : first(p.first), second(p.second)
 		{}
 
 		/* ill formed if either attributes const qualified , reference
 			with inaccessible copy assignment operator */
-		pair	&operator=(const pair &_p)
+		constexpr pair	&operator=(const pair &_p)
 		{
 			/* gnu implementation doesn't check */
 			if (this != &_p)
@@ -49,49 +52,57 @@ namespace ft {
 		}
 	};
 
+	/* the copy constructor is user provided, the bytes still are all
+		there is to a pair */
+	template <typename T1, typename T2>
+	struct is_trivially_relocatable<pair<T1, T2> >
+		: public integral_constant<bool, is_trivially_relocatable<T1>::value
+										&& is_trivially_relocatable<T2>::value>
+	{};
+
 	/* originally inlined */
 	/* no need for friend because attributes of a struct are public */
 	template <typename T1, typename T2>
-	bool	operator==(const pair<T1, T2> &lhs, const pair<T1, T2> &rhs)
+	constexpr bool	operator==(const pair<T1, T2> &lhs, const pair<T1, T2> &rhs)
 	{
 		return (lhs.first == rhs.first && lhs.second == rhs.second);
 	}
 
 	/* only if first of lhs and rhs are equal compare second */
 	template <typename T1, typename T2>
-	bool	operator<(const pair<T1, T2> &lhs, const pair<T1, T2> &rhs)
+	constexpr bool	operator<(const pair<T1, T2> &lhs, const pair<T1, T2> &rhs)
 	{
 		/* follows the order and conditions mentioned by the reference*/
 		return (lhs.first < rhs.first || (!(rhs.first < lhs.first) && lhs.second < rhs.second));
 	}
 
 	template <typename T1, typename T2>
-	bool	operator!=(const pair<T1, T2> &lhs, const pair<T1, T2> &rhs)
+	constexpr bool	operator!=(const pair<T1, T2> &lhs, const pair<T1, T2> &rhs)
 	{
 		return !(lhs == rhs);
 	}
 
 	template <typename T1, typename T2>
-	bool	operator>(const pair<T1, T2> &lhs, const pair<T1, T2> &rhs)
+	constexpr bool	operator>(const pair<T1, T2> &lhs, const pair<T1, T2> &rhs)
 	{
 		return (rhs < lhs);
 	}
 
 	template <typename T1, typename T2>
-	bool	operator<=(const pair<T1, T2> &lhs, const pair<T1, T2> &rhs)
+	constexpr bool	operator<=(const pair<T1, T2> &lhs, const pair<T1, T2> &rhs)
 	{
 		return !(rhs < lhs);
 	}
 
 	template <typename T1, typename T2>
-	bool	operator>=(const pair<T1, T2> &lhs, const pair<T1, T2> &rhs)
+	constexpr bool	operator>=(const pair<T1, T2> &lhs, const pair<T1, T2> &rhs)
 	{
 		return !(lhs < rhs);
 	}
 
 	/* originally inlined */
 	template <typename T1, typename T2>
-	inline pair<T1, T2> make_pair(T1 _f, T2 _s)
+	constexpr pair<T1, T2> make_pair(T1 _f, T2 _s)
 	{
 		return (pair<T1, T2>(_f, _s));
 	}
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <memory>		// std::allocator
+#include <algorithm>	// std::rotate
 #include <exception>
 #include <limits>
 
@@ -35,39 +36,106 @@
 
 namespace ft {
 
-template <typename T, typename Allocator=std::allocator<T> >
-class vector
+/* where a vector keeps its elements. basic_vector asks its Storage for
+
+	initial(), initial_capacity()	the block an empty vector starts with,
+									NULL and 0 for the heap
+	allocate(n), deallocate(p, n)	any other block
+	extend(p, cap, n)				grows the block p of cap elements in
+									place to n or more, returns the new
+									capacity, 0 if it can't
+	has_inline, is_inline(p)		whether there is a block inside the
+									storage and whether p is it, such a
+									block can't change hands in a swap
+	construct(p, val), destroy(p)
+	max_size(), overflow()			what happens beyond it, the heap throws
+									std::length_error
+
+	plus the pointer, reference and size typedefs. heap_storage goes
+	through the allocator for everything, small_vector.hpp and
+	static_vector.hpp have one with a buffer inside */
+template <typename T, typename Allocator>
+struct heap_storage
+{
+	typedef Allocator										allocator_type;
+	typedef typename allocator_type::size_type				size_type;
+	typedef typename allocator_type::difference_type		difference_type;
+	typedef typename allocator_type::reference				reference;
+	typedef typename allocator_type::const_reference		const_reference;
+	typedef typename allocator_type::pointer				pointer;
+	typedef typename allocator_type::const_pointer			const_pointer;
+	typedef ft::false_type									has_inline;
+
+	allocator_type		alloc_;
+
+	explicit heap_storage(const allocator_type& alloc = allocator_type())
+		: alloc_(alloc)
+	{}
+
+	pointer initial() const { return NULL; }
+
+	size_type initial_capacity() const { return 0; }
+
+	pointer allocate(size_type n) { return alloc_.allocate(n); }
+
+	void deallocate(pointer p, size_type n) { alloc_.deallocate(p, n); }
+
+	size_type extend(pointer, size_type, size_type) const { return 0; }
+
+	bool is_inline(const_pointer) const { return false; }
+
+	void construct(pointer p, const_reference val) { alloc_.construct(p, val); }
+
+	void destroy(pointer p) { alloc_.destroy(p); }
+
+	size_type max_size() const
+	{
+		return ft::min<size_type>(alloc_.max_size(),
+			std::numeric_limits<difference_type>::max());
+	}
+
+	void overflow() const { throw std::length_error("ft::vector"); }
+
+	void swap(heap_storage& other) { ft::swap(alloc_, other.alloc_); }
+};
+
+
+/* the vector itself, whatever keeps the elements. ft::vector and the other
+	vectors derive from it and only add their constructors */
+template <typename T, typename Storage>
+class basic_vector
 {
 	public:
 		typedef T													value_type;
-		typedef Allocator											allocator_type;
-		typedef typename allocator_type::size_type					size_type;
-		typedef typename allocator_type::difference_type			difference_type;
-		typedef typename allocator_type::reference					reference;
-		typedef typename allocator_type::const_reference			const_reference;
-		typedef typename allocator_type::pointer					pointer;
-		typedef typename allocator_type::const_pointer				const_pointer;
-		typedef ft::normal_iterator<pointer, vector>					iterator;
-		typedef ft::normal_iterator<const_pointer, vector>				const_iterator;
+		typedef Storage												storage_type;
+		typedef typename storage_type::size_type					size_type;
+		typedef typename storage_type::difference_type				difference_type;
+		typedef typename storage_type::reference					reference;
+		typedef typename storage_type::const_reference				const_reference;
+		typedef typename storage_type::pointer						pointer;
+		typedef typename storage_type::const_pointer				const_pointer;
+		typedef ft::normal_iterator<pointer, basic_vector>				iterator;
+		typedef ft::normal_iterator<const_pointer, basic_vector>		const_iterator;
 		typedef ft::reverse_iterator<iterator>							reverse_iterator;
 		typedef ft::reverse_iterator<const_iterator>					const_reverse_iterator;
 
-	private:
-		allocator_type		alloc_;
+	protected:
+		storage_type		storage_;
 		pointer				begin_;
 		pointer				end_;
 		pointer				end_cap_;
 
-	public:
-
-		// constructors 
-		explicit vector(const allocator_type &alloc = allocator_type())
-			: alloc_(alloc), begin_(NULL), end_(NULL), end_cap_(NULL)
-		{}
+		// constructors, the public ones are the ones of the vectors
+		explicit basic_vector(const storage_type &storage)
+			: storage_(storage)
+		{
+			reset_();
+		}
 
-		explicit vector(size_type n, const value_type &val = value_type(), const allocator_type &alloc = allocator_type())
-			: alloc_(alloc), begin_(NULL), end_(NULL), end_cap_(NULL)
+		basic_vector(size_type n, const value_type &val, const storage_type &storage)
+			: storage_(storage)
 		{
+			reset_();
 			try {
 				if (n > 0)
 				{
@@ -81,10 +149,11 @@ class vector
 		}
 
 		template <typename InputIterator>
-		vector(InputIterator first, InputIterator last, const allocator_type &alloc = allocator_type(),
+		basic_vector(InputIterator first, InputIterator last, const storage_type &storage,
 				typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = 0)
-			: alloc_(alloc), begin_(NULL), end_(NULL), end_cap_(NULL)
+			: storage_(storage)
 		{
+			reset_();
 			try {
 				assign(first, last);
 			} catch (...) {
@@ -93,9 +162,10 @@ class vector
 			}
 		}
 
-		vector(const vector &other)
-			: alloc_(other.alloc_), begin_(NULL), end_(NULL), end_cap_(NULL)
+		basic_vector(const basic_vector &other)
+			: storage_(other.storage_)
 		{
+			reset_();
 			try {
 				if (other.size() > 0)
 				{
@@ -109,20 +179,18 @@ class vector
 		}
 
 		// destructors
-		~vector()
+		~basic_vector()
 		{
 			vdeallocate_();
 		}
 
+	public:
 
 		// operator=
-		vector	&operator=(const vector& other)
+		basic_vector	&operator=(const basic_vector& other)
 		{
 			if (this != &other)
-			{
-				alloc_ = other.get_allocator();
 				assign(other.begin(), other.end());
-			}
 
 			return *this;
 		}
@@ -177,8 +245,7 @@ class vector
 
 		size_type max_size() const
 		{
-			return ft::min<size_type>(alloc_.max_size(),
-				std::numeric_limits<difference_type>::max());
+			return storage_.max_size();
 		}
 
 		void resize(size_type n, value_type val=value_type())
@@ -206,17 +273,35 @@ class vector
 		}
 
 
+		/* a block the storage can extend stays where it is. otherwise the
+			elements are copied into the new block before the old one
+			goes, a copy that throws leaves the vector as it was */
 		void reserve(size_type n)
 		{
-			if (n > capacity()) {
-				vector tmp(alloc_);
-				tmp.vallocate_(n);
-				tmp.construct_at_end_(begin_, end_, ft::iterator_category(begin_));
-				swap(tmp);	
-			}
+			if (n > capacity())
+			{
+				if (n > max_size())
+					storage_.overflow();
+
+				const size_type extended = storage_.extend(begin_, capacity(), n);
+				if (extended != 0)
+				{
+					end_cap_ = begin_ + extended;
+					return ;
+				}
 
-			// because the old vector goes out of scope
-			// the memory is deallocated (tmp == old vector)
+				pointer	block = allocate_block_(n);
+				pointer	last = block;
+
+				try {
+					for (pointer p = begin_; p != end_; ++p, ++last)
+						storage_.construct(last, *p);
+				} catch (...) {
+					release_block_(block, last, n);
+					throw;
+				}
+				adopt_block_(block, last, n);
+			}
 		}
 
 
@@ -282,8 +367,17 @@ class vector
 		{
 			if (n > capacity())
 			{
-				vector tmp(n, val);
-				swap(tmp);
+				pointer	block = allocate_block_(n);
+				pointer	last = block;
+
+				try {
+					for (; last != block + n; ++last)
+						storage_.construct(last, val);
+				} catch (...) {
+					release_block_(block, last, n);
+					throw;
+				}
+				adopt_block_(block, last, n);
 			} else {
 				const size_type _size = size();
 
@@ -358,7 +452,7 @@ class vector
 			size_type n = ft::distance(first, last);
 			if (n > 0)
 			{
-				ft::copy(begin_ + (last - begin()) + 1, end_, begin_ + (first - begin()));
+				ft::copy(begin_ + (last - begin()), end_, begin_ + (first - begin()));
 				erase_at_end_(end_ - n);
 			}
 
@@ -366,12 +460,11 @@ class vector
 		}
 
 
-		void swap(vector &a)
+		/* blocks on the heap change hands. a block inside the storage
+			stays where it is, then the elements are swapped instead */
+		void swap(basic_vector &a)
 		{
-			ft::swap(alloc_, a.alloc_);
-			ft::swap(begin_, a.begin_);
-			ft::swap(end_, a.end_);
-			ft::swap(end_cap_, a.end_cap_);
+			swap_(a, typename storage_type::has_inline());
 		}
 
 		void clear()
@@ -379,32 +472,63 @@ class vector
 			erase_at_end_(begin_);
 		}
 
-		allocator_type get_allocator() const
-		{
-			return alloc_;
-		}
 
-
-	private:
+	protected:
 
 		inline void construct_(pointer p, const_reference val)
 		{
-			alloc_.construct(p, val);
+			storage_.construct(p, val);
 		}
 
 		inline void destroy_(pointer p)
 		{
-			alloc_.destroy(p);
+			storage_.destroy(p);
 		}
 
-		/* allocates memory using the allocator for the vector to be ready.
-			Does nothing else - preparation for the construction of vector */
-		inline void vallocate_(size_type n)
+		/* the empty vector, on the initial block of the storage */
+		inline void reset_()
+		{
+			begin_ = end_ = storage_.initial();
+			end_cap_ = begin_ + storage_.initial_capacity();
+		}
+
+		inline pointer allocate_block_(size_type n)
 		{
 			if (n > max_size())
-				throw std::length_error("ft::vector");
+				storage_.overflow();
 
-			begin_ = end_ = alloc_.allocate(n);
+			return storage_.allocate(n);
+		}
+
+		/* undoes a block that didn't fill up: [block, last) was constructed */
+		inline void release_block_(pointer block, pointer last, size_type n)
+		{
+			while (last != block)
+				destroy_(--last);
+			storage_.deallocate(block, n);
+		}
+
+		/* the block of n with the elements [block, last) replaces the
+			current one */
+		inline void adopt_block_(pointer block, pointer last, size_type n)
+		{
+			vdeallocate_();
+			begin_ = block;
+			end_ = last;
+			end_cap_ = block + n;
+		}
+
+		/* makes the vector ready for n elements, the initial block is used
+			while it is big enough. Does nothing else - preparation for the
+			construction of vector */
+		inline void vallocate_(size_type n)
+		{
+			if (n <= storage_.initial_capacity())
+			{
+				reset_();
+				return ;
+			}
+			begin_ = end_ = allocate_block_(n);
 			end_cap_ = begin_ + n;
 		}
 
@@ -413,12 +537,10 @@ class vector
 			Cleans up after any operation and leaves a clean plate */
 		inline void vdeallocate_()
 		{
-			if (begin_ == NULL)
-				return ;
-
 			clear();
-			alloc_.deallocate(begin_, capacity());
-			begin_ = end_ = end_cap_ = NULL;
+			if (begin_ != storage_.initial())
+				storage_.deallocate(begin_, capacity());
+			reset_();
 		}
 
 		inline void construct_at_end_(size_type n, const_reference val = value_type())
@@ -474,20 +596,23 @@ class vector
 			}
 		}
 
+		/* single pass: appended, then rotated into place. no temporary
+			vector, the storage may not have room for one */
 		template <typename InputIterator>
 		inline void insert_range_(iterator pos, InputIterator first,
 						InputIterator last, ft::input_iterator_tag)
 		{
-			if (pos == end())
-			{
+			const difference_type offset = pos - begin();
+			const size_type old_size = size();
+
+			try {
 				for (; first != last; ++first)
 					push_back(*first);
+			} catch (...) {
+				erase_at_end_(begin_ + old_size);
+				throw;
 			}
-			else
-			{
-				vector tmp(first, last);
-				insert(pos, tmp.begin(), tmp.end());
-			}
+			std::rotate(begin_ + offset, begin_ + old_size, end_);
 		}
 
 		template <typename ForwardIterator>
@@ -507,6 +632,38 @@ class vector
 			}
 		}
 
+		void swap_(basic_vector &a, ft::false_type)
+		{
+			storage_.swap(a.storage_);
+			ft::swap(begin_, a.begin_);
+			ft::swap(end_, a.end_);
+			ft::swap(end_cap_, a.end_cap_);
+		}
+
+		void swap_(basic_vector &a, ft::true_type)
+		{
+			if (storage_.is_inline(begin_) || a.storage_.is_inline(a.begin_))
+				swap_elements_(a);
+			else
+				swap_(a, ft::false_type());
+		}
+
+		/* the shorter one makes room for the longer one, the common part
+			is swapped and the rest moves over */
+		void swap_elements_(basic_vector &a)
+		{
+			basic_vector&	shorter = (size() < a.size()) ? *this : a;
+			basic_vector&	longer = (size() < a.size()) ? a : *this;
+			const size_type	common = shorter.size();
+
+			shorter.reserve(longer.size());
+			for (size_type i = 0; i < common; ++i)
+				ft::swap(shorter.begin_[i], longer.begin_[i]);
+			shorter.construct_at_end_(longer.begin_ + common, longer.end_,
+										ft::iterator_category(longer.begin_));
+			longer.erase_at_end_(longer.begin_ + common);
+		}
+
 
 		/* multiple sources claim a growth factor of 2 is suboptimal, if not 
 			the worst possible (fbvectors) 
@@ -523,7 +680,7 @@ class vector
 			const size_type size_max = max_size();
 
 			if (new_size > size_max)
-				throw std::length_error("ft::vector");
+				storage_.overflow();
 
 			const size_type cap = capacity();
 			if (new_size < cap)
@@ -539,38 +696,72 @@ class vector
 };
 
 
-	template <typename T, typename Alloc>
-	inline bool operator==(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+template <typename T, typename Allocator=std::allocator<T> >
+class vector : public basic_vector<T, heap_storage<T, Allocator> >
+{
+	private:
+		typedef basic_vector<T, heap_storage<T, Allocator> >		base_type;
+		typedef typename base_type::storage_type					storage_type;
+
+	public:
+		typedef Allocator											allocator_type;
+		typedef typename base_type::value_type						value_type;
+		typedef typename base_type::size_type						size_type;
+
+		// constructors 
+		explicit vector(const allocator_type &alloc = allocator_type())
+			: base_type(storage_type(alloc))
+		{}
+
+		explicit vector(size_type n, const value_type &val = value_type(), const allocator_type &alloc = allocator_type())
+			: base_type(n, val, storage_type(alloc))
+		{}
+
+		template <typename InputIterator>
+		vector(InputIterator first, InputIterator last, const allocator_type &alloc = allocator_type(),
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = 0)
+			: base_type(first, last, storage_type(alloc))
+		{}
+
+		allocator_type get_allocator() const
+		{
+			return this->storage_.alloc_;
+		}
+};
+
+
+	template <typename T, typename Storage>
+	inline bool operator==(const basic_vector<T, Storage>& lhs, const basic_vector<T, Storage>& rhs)
 	{
 		return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
 	}
 
-	template <typename T, typename Alloc>
-	inline bool operator!=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+	template <typename T, typename Storage>
+	inline bool operator!=(const basic_vector<T, Storage>& lhs, const basic_vector<T, Storage>& rhs)
 	{
 		return !(lhs == rhs);
 	}
 
-	template <typename T, typename Alloc>
-	inline bool operator<(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+	template <typename T, typename Storage>
+	inline bool operator<(const basic_vector<T, Storage>& lhs, const basic_vector<T, Storage>& rhs)
 	{
 		return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); 
 	}
 
-	template <typename T, typename Alloc>
-	bool operator<=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+	template <typename T, typename Storage>
+	bool operator<=(const basic_vector<T, Storage>& lhs, const basic_vector<T, Storage>& rhs)
 	{
 		return !(rhs < lhs);
 	}
 
-	template <typename T, typename Alloc>
-	bool operator>(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+	template <typename T, typename Storage>
+	bool operator>(const basic_vector<T, Storage>& lhs, const basic_vector<T, Storage>& rhs)
 	{
 		return rhs < lhs;
 	}
 
-	template <typename T, typename Alloc>
-	bool operator>=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+	template <typename T, typename Storage>
+	bool operator>=(const basic_vector<T, Storage>& lhs, const basic_vector<T, Storage>& rhs)
 	{
 		return !(lhs < rhs);
 	}